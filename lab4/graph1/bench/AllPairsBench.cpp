@@ -0,0 +1,148 @@
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../src/Graph.cpp"
+#include "BenchUtil.hpp"
+
+template <typename T>
+struct WeightedEdge {
+  int from;
+  int to;
+  T weight;
+};
+
+/**
+ * Draws a random graph in which every ordered pair of vertices is an edge
+ * with the given probability, weights 1..1000.
+ */
+template <typename T>
+std::vector<WeightedEdge<T>> makeRandomEdges(int vertices, double density,
+                                             unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> coin(0.0, 1.0);
+  std::uniform_int_distribution<int> weight(1, 1000);
+  std::vector<WeightedEdge<T>> edges;
+  for (int u = 0; u < vertices; ++u) {
+    for (int v = 0; v < vertices; ++v) {
+      if (u != v && coin(rng) < density) {
+        edges.push_back({u, v, static_cast<T>(weight(rng))});
+      }
+    }
+  }
+  return edges;
+}
+
+/**
+ * Textbook Floyd-Warshall on a plain matrix, the baseline for the blocked
+ * version.
+ */
+template <typename T>
+std::vector<T> textbookFloydWarshall(
+    int n, const std::vector<WeightedEdge<T>> &edges) {
+  const T INF = std::numeric_limits<T>::max();
+  std::vector<T> matrix(static_cast<std::size_t>(n) * n, INF);
+  for (int v = 0; v < n; ++v) matrix[v * n + v] = 0;
+  for (const auto &edge : edges) {
+    T &cell = matrix[edge.from * n + edge.to];
+    cell = std::min(cell, edge.weight);
+  }
+  for (int k = 0; k < n; ++k) {
+    for (int i = 0; i < n; ++i) {
+      T ik = matrix[i * n + k];
+      if (ik == INF) continue;
+      for (int j = 0; j < n; ++j) {
+        T kj = matrix[k * n + j];
+        if (kj != INF && ik + kj < matrix[i * n + j]) {
+          matrix[i * n + j] = ik + kj;
+        }
+      }
+    }
+  }
+  return matrix;
+}
+
+/**
+ * Runs both all-pairs algorithms on one graph, and the textbook triple
+ * loop on graphs small enough for it, checking every result against the
+ * blocked Floyd-Warshall matrix.
+ */
+template <typename T>
+void benchmark(const std::string &typeName, int vertices, double density,
+               unsigned threads) {
+  std::vector<WeightedEdge<T>> edges =
+      makeRandomEdges<T>(vertices, density, 42);
+  Graph<T> graph(vertices);
+  for (const auto &edge : edges) graph.addEdge(edge.from, edge.to, edge.weight);
+  graph.finalize();
+  ThreadPool pool(threads);
+
+  DistanceMatrix<T> reference;
+  double blockedMs = timeMs([&] {
+    graph.allPairsShortestPaths(reference, AllPairsMode::FloydWarshall, pool);
+  });
+
+  auto row = [&](const std::string &name, double ms, bool ok) {
+    std::cout << std::setw(8) << typeName << std::setw(10) << vertices
+              << std::setw(9) << std::fixed << std::setprecision(2)
+              << density * 100 << "%" << std::setw(11) << name
+              << std::setw(12) << std::setprecision(1) << ms << std::setw(9)
+              << std::setprecision(2)
+              << ms / blockedMs << "x  "
+              << (ok ? Color::GREEN + "ok" : Color::RED + "MISMATCH")
+              << Color::RESET << std::endl;
+  };
+  row("blocked", blockedMs, true);
+
+  DistanceMatrix<T> johnson;
+  double ms = timeMs([&] {
+    graph.allPairsShortestPaths(johnson, AllPairsMode::Johnson, pool);
+  });
+  row("johnson", ms, sameDistances(johnson.values, reference.values));
+
+  // The cubic baseline gets slow quickly, and the point is made by then
+  if (vertices <= 2048) {
+    std::vector<T> textbook;
+    ms = timeMs([&] { textbook = textbookFloydWarshall(vertices, edges); });
+    row("textbook", ms, sameDistances(textbook, reference.values));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<int> sizes;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = std::max(1, std::atoi(argv[++i]));
+    } else {
+      sizes.push_back(std::atoi(argv[i]));
+    }
+  }
+  if (sizes.empty()) sizes = {1024, 2048};
+
+  std::cout << Color::BOLD << Color::MAGENTA
+            << "\n[All-pairs shortest paths on random graphs, " << threads
+            << " threads]" << Color::RESET << std::endl;
+  std::cout << std::setw(8) << "Type" << std::setw(10) << "Vertices"
+            << std::setw(10) << "Density" << std::setw(11) << "Algorithm"
+            << std::setw(12) << "Time (ms)" << std::setw(10) << "Relative"
+            << std::endl;
+  std::cout << std::string(65, '-') << std::endl;
+
+  // Dense inputs are Floyd-Warshall's home ground, sparse ones with a
+  // handful of edges per vertex are Johnson's
+  for (int vertices : sizes) {
+    for (double density : {0.5, 8.0 / vertices}) {
+      benchmark<int>("int", vertices, density, threads);
+      benchmark<float>("float", vertices, density, threads);
+      benchmark<double>("double", vertices, density, threads);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../src/Graph.cpp"
+#include "BenchUtil.hpp"
+
+/**
+ * Generates queries from a few sources. With local set, every target lies
+ * within a few blocks of its source, like most trips on a road network;
+ * otherwise half of the targets are spread over the whole map.
+ */
+std::vector<PathQuery> makeQueries(int vertices, int sources, int perSource,
+                                   bool local, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> anyVertex(0, vertices - 1);
+  std::uniform_int_distribution<int> nearby(-50, 50);
+  int width = static_cast<int>(std::ceil(std::sqrt(vertices)));
+  std::vector<PathQuery> queries;
+  for (int s = 0; s < sources; ++s) {
+    int source = anyVertex(rng);
+    for (int q = 0; q < perSource; ++q) {
+      int target = anyVertex(rng);
+      if (local || q % 2 == 0) {
+        // Move a few blocks away on the grid, staying inside the map
+        int x = std::min(std::max(source % width + nearby(rng), 0), width - 1);
+        int y = source / width + nearby(rng);
+        target = std::min(std::max(y * width + x, 0), vertices - 1);
+      }
+      queries.push_back({source, target});
+    }
+  }
+  // Interleave the sources the way independent requests would arrive
+  std::shuffle(queries.begin(), queries.end(), rng);
+  return queries;
+}
+
+/**
+ * Times one full Dijkstra search per distinct source against the batch API
+ * and prints one row.
+ */
+void benchmark(Graph<int> &graph, int vertices, bool local) {
+  std::vector<PathQuery> queries = makeQueries(vertices, 32, 32, local, 7);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<int> expected(queries.size());
+  std::vector<int> distances;
+  std::vector<char> done(queries.size(), 0);
+  for (size_t i = 0; i < queries.size(); ++i) {
+    if (done[i]) continue;
+    graph.dijkstra(queries[i].source, distances);
+    for (size_t j = i; j < queries.size(); ++j) {
+      if (queries[j].source == queries[i].source) {
+        expected[j] = distances[queries[j].target];
+        done[j] = 1;
+      }
+    }
+  }
+  auto middle = std::chrono::steady_clock::now();
+  std::vector<int> answers;
+  graph.shortestPaths(queries, answers);
+  auto end = std::chrono::steady_clock::now();
+
+  double fullMs =
+      std::chrono::duration<double, std::milli>(middle - start).count();
+  double batchMs =
+      std::chrono::duration<double, std::milli>(end - middle).count();
+  bool ok = answers == expected;
+
+  std::cout << std::setw(10) << vertices << std::setw(8)
+            << (local ? "local" : "mixed") << std::setw(10) << queries.size()
+            << std::setw(14) << std::fixed << std::setprecision(2) << fullMs
+            << std::setw(14) << batchMs << std::setw(14)
+            << std::setprecision(0) << queries.size() / (batchMs / 1000.0)
+            << "  " << (ok ? Color::GREEN + "ok" : Color::RED + "MISMATCH")
+            << Color::RESET << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<int> sizes;
+  for (int i = 1; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+  if (sizes.empty()) sizes = {100000, 1000000, 10000000};
+
+  std::cout << Color::BOLD << Color::MAGENTA
+            << "\n[Batch shortest path queries on road-like graphs]"
+            << Color::RESET << std::endl;
+  std::cout << std::setw(10) << "Vertices" << std::setw(8) << "Targets" << std::setw(10) << "Queries"
+            << std::setw(14) << "Full (ms)" << std::setw(14) << "Batch (ms)"
+            << std::setw(14) << "Queries/s" << std::endl;
+  std::cout << std::string(70, '-') << std::endl;
+
+  for (int vertices : sizes) {
+    Graph<int> graph = makeRoadGraph<int>(vertices, 42);
+    benchmark(graph, vertices, true);
+    benchmark(graph, vertices, false);
+  }
+  return 0;
+}
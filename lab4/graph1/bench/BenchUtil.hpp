@@ -0,0 +1,83 @@
+#ifndef BENCH_UTIL_HPP
+#define BENCH_UTIL_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "../include/Graph.hpp"
+
+/**
+ * Builds a road-like graph: vertices are laid out on a near-square grid,
+ * neighbouring intersections are joined in both directions and a few
+ * diagonal "shortcut" streets are sprinkled in. Weights are drawn uniformly
+ * from [1, 1000) so ties are rare for every weight type and one grid step
+ * never costs less than 1.
+ *
+ * @tparam T The weight type.
+ * @param vertices Number of vertices to generate.
+ * @param seed Seed for the weight generator.
+ * @return Graph<T> The generated graph.
+ */
+template <typename T>
+Graph<T> makeRoadGraph(int vertices, unsigned seed) {
+  Graph<T> graph(vertices);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> weight(1.0, 1000.0);
+  std::uniform_int_distribution<int> shortcut(0, 15);
+  int width = static_cast<int>(std::ceil(std::sqrt(vertices)));
+
+  auto connect = [&](int a, int b) {
+    T w = static_cast<T>(weight(rng));
+    graph.addEdge(a, b, w);
+    graph.addEdge(b, a, w);
+  };
+
+  for (int v = 0; v < vertices; ++v) {
+    int x = v % width;
+    if (x + 1 < width && v + 1 < vertices) connect(v, v + 1);
+    if (v + width < vertices) connect(v, v + width);
+    if (x + 1 < width && v + width + 1 < vertices && shortcut(rng) == 0) {
+      connect(v, v + width + 1);
+    }
+  }
+  graph.finalize();
+  return graph;
+}
+
+/**
+ * Compares two distance vectors, allowing a small relative error for floating
+ * point weights where different algorithms can sum the same path lengths in
+ * a different order.
+ */
+template <typename T>
+bool sameDistances(const std::vector<T> &a, const std::vector<T> &b) {
+  if (a.size() != b.size()) return false;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (a[i] == b[i]) continue;
+    if constexpr (std::is_integral_v<T>) {
+      return false;
+    } else {
+      T scale = std::max(std::abs(a[i]), std::abs(b[i]));
+      if (std::abs(a[i] - b[i]) > scale * static_cast<T>(1e-5)) return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Times one call and returns milliseconds.
+ */
+template <typename Call>
+double timeMs(Call call) {
+  auto start = std::chrono::steady_clock::now();
+  call();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+#endif /* BENCH_UTIL_HPP */
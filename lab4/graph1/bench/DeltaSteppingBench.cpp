@@ -0,0 +1,83 @@
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../src/Graph.cpp"
+#include "BenchUtil.hpp"
+
+/**
+ * Runs delta-stepping with 1, 2, 4, ... up to maxThreads threads and then
+ * with a few bucket widths on all threads, checking every result against
+ * Dijkstra.
+ *
+ * @param typeName Name of the weight type, for the table.
+ * @param vertices Number of vertices in the generated graph.
+ * @param maxThreads Largest thread count to try.
+ */
+template <typename T>
+void benchmarkType(const std::string &typeName, int vertices,
+                   unsigned maxThreads) {
+  Graph<T> graph = makeRoadGraph<T>(vertices, 42);
+  std::vector<T> reference;
+  double dijkstraMs = timeMs([&] { graph.dijkstra(0, reference); });
+  std::cout << std::setw(8) << typeName << std::setw(12) << vertices
+            << std::setw(10) << "dijkstra" << std::setw(10) << ""
+            << std::setw(12) << std::fixed << std::setprecision(1)
+            << dijkstraMs << std::endl;
+
+  auto row = [&](unsigned threads, T delta, const std::string &label) {
+    ThreadPool pool(threads);
+    std::vector<T> distances;
+    double ms =
+        timeMs([&] { graph.deltaStepping(0, distances, delta, pool); });
+    bool ok = distances == reference;
+    std::cout << std::setw(8) << typeName << std::setw(12) << vertices
+              << std::setw(10) << threads << std::setw(10) << label
+              << std::setw(12) << std::setprecision(1) << ms << std::setw(10)
+              << std::setprecision(2) << dijkstraMs / ms << "x  "
+              << (ok ? Color::GREEN + "ok" : Color::RED + "MISMATCH")
+              << Color::RESET << std::endl;
+  };
+
+  for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+    row(threads, T(), "auto");
+  }
+  row(maxThreads, T(), "auto");
+  for (double width : {50.0, 200.0, 2000.0}) {
+    row(maxThreads, static_cast<T>(width),
+        std::to_string(static_cast<int>(width)));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<int> sizes;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      maxThreads = std::max(1, std::atoi(argv[++i]));
+    } else {
+      sizes.push_back(std::atoi(argv[i]));
+    }
+  }
+  if (sizes.empty()) sizes = {1000000};
+
+  std::cout << Color::BOLD << Color::MAGENTA
+            << "\n[Delta-stepping scaling on road-like graphs]" << Color::RESET
+            << std::endl;
+  std::cout << std::setw(8) << "Type" << std::setw(12) << "Vertices"
+            << std::setw(10) << "Threads" << std::setw(10) << "Delta"
+            << std::setw(12) << "Time (ms)" << std::setw(11) << "Speedup"
+            << std::endl;
+  std::cout << std::string(63, '-') << std::endl;
+
+  for (int vertices : sizes) {
+    benchmarkType<int>("int", vertices, maxThreads);
+    benchmarkType<double>("double", vertices, maxThreads);
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../src/Graph.cpp"
+#include "BenchUtil.hpp"
+
+/**
+ * Runs every heap on one graph and prints a row per heap.
+ *
+ * @param typeName Name of the weight type, for the table.
+ * @param vertices Number of vertices in the generated graph.
+ */
+template <typename T>
+void benchmarkType(const std::string &typeName, int vertices) {
+  Graph<T> graph = makeRoadGraph<T>(vertices, 42);
+  const HeapType heaps[] = {HeapType::Binary, HeapType::FourAry,
+                            HeapType::Pairing, HeapType::Radix};
+
+  std::vector<T> reference;
+  double best = 0;
+  HeapType winner = HeapType::Binary;
+
+  for (HeapType heap : heaps) {
+    std::vector<T> distances;
+    auto start = std::chrono::steady_clock::now();
+    graph.dijkstra(0, distances, heap);
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    bool ok = true;
+    if (reference.empty()) {
+      reference = distances;
+    } else {
+      ok = sameDistances(reference, distances);
+    }
+    if (best == 0 || ms < best) {
+      best = ms;
+      winner = heap;
+    }
+
+    std::cout << std::setw(8) << typeName << std::setw(12) << vertices
+              << std::setw(10) << heapTypeName(heap) << std::setw(14)
+              << std::fixed << std::setprecision(2) << ms << "  "
+              << (ok ? Color::GREEN + "ok" : Color::RED + "MISMATCH")
+              << Color::RESET << std::endl;
+  }
+  std::cout << Color::CYAN << "  fastest: " << heapTypeName(winner)
+            << Color::RESET << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<int> sizes;
+  for (int i = 1; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+  if (sizes.empty()) sizes = {100000, 1000000, 10000000};
+
+  std::cout << Color::BOLD << Color::MAGENTA
+            << "\n[Dijkstra heap benchmark on road-like graphs]" << Color::RESET
+            << std::endl;
+  std::cout << std::setw(8) << "Type" << std::setw(12) << "Vertices"
+            << std::setw(10) << "Heap" << std::setw(14) << "Time (ms)"
+            << std::endl;
+  std::cout << std::string(50, '-') << std::endl;
+
+  for (int vertices : sizes) {
+    benchmarkType<int>("int", vertices);
+    benchmarkType<float>("float", vertices);
+    benchmarkType<double>("double", vertices);
+  }
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../include/DynamicGraph.hpp"
+#include "../include/IncrementalShortestPaths.hpp"
+#include "../src/Graph.cpp"
+#include "BenchUtil.hpp"
+
+/**
+ * Generates a batch of traffic updates touching one in `every` edges. Most
+ * edits scale a travel time up or down, a few close a road and a few
+ * reopen one with a fresh weight.
+ */
+std::vector<GraphEdit<int>> makeBatch(const DynamicGraph<int> &graph,
+                                      std::size_t every, std::mt19937 &rng) {
+  int n = graph.getNumVertices();
+  std::size_t edits = std::max<std::size_t>(1, graph.getNumEdges() / every);
+  std::uniform_int_distribution<int> anyVertex(0, n - 1);
+  std::uniform_int_distribution<int> kind(0, 19);
+  std::uniform_real_distribution<double> factor(0.5, 2.0);
+  int width = static_cast<int>(std::ceil(std::sqrt(n)));
+
+  std::vector<GraphEdit<int>> batch;
+  while (batch.size() < edits) {
+    int u = anyVertex(rng);
+    const auto &arcs = graph.outEdges(u);
+    int k = kind(rng);
+    if (k == 0) {
+      int v = u + 1 < n ? u + 1 : u - 1;
+      if (u + width < n && rng() % 2) v = u + width;
+      batch.push_back(GraphEdit<int>::setEdge(u, v, 1 + rng() % 1000));
+      continue;
+    }
+    if (arcs.empty()) continue;
+    const auto &arc = arcs[rng() % arcs.size()];
+    if (k == 1) {
+      batch.push_back(GraphEdit<int>::removeEdge(u, arc.vertex));
+    } else {
+      int weight = std::max(1, static_cast<int>(arc.weight * factor(rng)));
+      batch.push_back(GraphEdit<int>::setEdge(u, arc.vertex, weight));
+    }
+  }
+  return batch;
+}
+
+/**
+ * Applies a series of batches and times the incremental repair against a
+ * full Dijkstra search on the frozen graph after each one, then prints one
+ * row with the averages. Touched counts the vertices the repair visited.
+ */
+void benchmark(DynamicGraph<int> &graph, std::size_t every, int batches) {
+  int vertices = graph.getNumVertices();
+  int source = vertices / 2;
+  IncrementalShortestPaths<int> paths(graph, source);
+  std::mt19937 rng(7);
+
+  double fullMs = 0, updateMs = 0;
+  std::size_t touched = 0, edits = 0;
+  bool ok = true;
+  std::vector<int> distances;
+  for (int b = 0; b < batches; ++b) {
+    std::vector<GraphEdit<int>> batch = makeBatch(graph, every, rng);
+    edits += batch.size();
+
+    auto start = std::chrono::steady_clock::now();
+    paths.update(graph.apply(batch));
+    auto middle = std::chrono::steady_clock::now();
+    Graph<int> frozen = graph.toGraph();
+    auto restart = std::chrono::steady_clock::now();
+    frozen.dijkstra(source, distances);
+    auto end = std::chrono::steady_clock::now();
+
+    updateMs +=
+        std::chrono::duration<double, std::milli>(middle - start).count();
+    fullMs +=
+        std::chrono::duration<double, std::milli>(end - restart).count();
+    touched += paths.getLastTouched();
+    ok = ok && distances == paths.distances();
+  }
+
+  std::cout << std::setw(10) << vertices << std::setw(9) << std::fixed
+            << std::setprecision(3) << 100.0 / every << "%" << std::setw(10)
+            << edits / batches << std::setw(12) << touched / batches
+            << std::setw(14) << std::setprecision(2) << fullMs / batches
+            << std::setw(14) << updateMs / batches << std::setw(10)
+            << std::setprecision(0) << fullMs / updateMs << "x"
+            << "  " << (ok ? Color::GREEN + "ok" : Color::RED + "MISMATCH")
+            << Color::RESET << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<int> sizes;
+  for (int i = 1; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+  if (sizes.empty()) sizes = {100000, 1000000};
+
+  std::cout << Color::BOLD << Color::MAGENTA
+            << "\n[Incremental shortest paths under edge updates]"
+            << Color::RESET << std::endl;
+  std::cout << std::setw(10) << "Vertices" << std::setw(10) << "Batch"
+            << std::setw(10) << "Edits" << std::setw(12) << "Touched"
+            << std::setw(14) << "Full (ms)"
+            << std::setw(14) << "Update (ms)" << std::setw(11) << "Speedup"
+            << std::endl;
+  std::cout << std::string(81, '-') << std::endl;
+
+  // 0.1% is one minute of traffic; smaller batches are what a service
+  // sees when it folds in updates every few seconds
+  for (int vertices : sizes) {
+    DynamicGraph<int> graph(makeRoadGraph<int>(vertices, 42));
+    for (std::size_t every : {1000, 10000, 100000}) {
+      benchmark(graph, every, 20);
+    }
+  }
+  return 0;
+}
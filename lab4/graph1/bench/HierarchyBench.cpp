@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../include/ContractionHierarchy.hpp"
+#include "../src/Graph.cpp"
+#include "BenchUtil.hpp"
+
+/**
+ * Preprocesses one graph, round-trips the hierarchy through a file and
+ * compares random point-to-point queries against Dijkstra.
+ *
+ * @param vertices Number of vertices in the generated graph.
+ */
+void benchmark(int vertices) {
+  using Clock = std::chrono::steady_clock;
+  using Ms = std::chrono::duration<double, std::milli>;
+  const int QUERIES = 10000;
+  const int CHECKED = 20;
+
+  Graph<int> graph = makeRoadGraph<int>(vertices, 42);
+  auto start = Clock::now();
+  auto built = ContractionHierarchy<int>::build(graph);
+  double buildMs = Ms(Clock::now() - start).count();
+
+  std::string file = "bin/HierarchyBench.ch";
+  built.save(file);
+  start = Clock::now();
+  auto hierarchy = ContractionHierarchy<int>::load(file);
+  double loadMs = Ms(Clock::now() - start).count();
+
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> anyVertex(0, vertices - 1);
+  std::vector<PathQuery> queries(QUERIES);
+  for (PathQuery &query : queries) query = {anyVertex(rng), anyVertex(rng)};
+
+  start = Clock::now();
+  std::vector<int> answers(QUERIES);
+  for (int i = 0; i < QUERIES; ++i) {
+    hierarchy.query(queries[i].source, queries[i].target, answers[i]);
+  }
+  double queryUs = Ms(Clock::now() - start).count() * 1000.0 / QUERIES;
+
+  start = Clock::now();
+  bool ok = true;
+  for (int i = 0; i < CHECKED; ++i) {
+    std::vector<int> expected;
+    graph.shortestPaths({queries[i]}, expected);
+    ok &= expected[0] == answers[i];
+  }
+  double dijkstraUs = Ms(Clock::now() - start).count() * 1000.0 / CHECKED;
+  std::remove(file.c_str());
+
+  std::cout << std::setw(10) << vertices << std::setw(12) << std::fixed
+            << std::setprecision(0) << buildMs << std::setw(12)
+            << hierarchy.getNumShortcuts() << std::setw(10)
+            << std::setprecision(2) << loadMs << std::setw(14) << queryUs
+            << std::setw(16) << dijkstraUs << "  "
+            << (ok ? Color::GREEN + "ok" : Color::RED + "MISMATCH")
+            << Color::RESET << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<int> sizes;
+  for (int i = 1; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+  if (sizes.empty()) sizes = {100000, 1000000};
+
+  std::cout << Color::BOLD << Color::MAGENTA
+            << "\n[Contraction hierarchy queries on road-like graphs]"
+            << Color::RESET << std::endl;
+  std::cout << std::setw(10) << "Vertices" << std::setw(12) << "Build (ms)"
+            << std::setw(12) << "Shortcuts" << std::setw(10) << "Load (ms)"
+            << std::setw(14) << "CH query (us)" << std::setw(16)
+            << "Dijkstra (us)" << std::endl;
+  std::cout << std::string(76, '-') << std::endl;
+
+  for (int vertices : sizes) {
+    benchmark(vertices);
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../src/Graph.cpp"
+#include "BenchUtil.hpp"
+
+/**
+ * Prints one row: average vertices settled and time per query for a mode.
+ */
+void printRow(const std::string &typeName, int vertices, const char *mode,
+              double settled, double us, bool ok) {
+  std::cout << std::setw(8) << typeName << std::setw(10) << vertices
+            << std::setw(16) << mode << std::setw(14) << std::fixed
+            << std::setprecision(0) << settled << std::setw(14)
+            << std::setprecision(1) << us << "  "
+            << (ok ? Color::GREEN + "ok" : Color::RED + "MISMATCH")
+            << Color::RESET << std::endl;
+}
+
+/**
+ * Answers the same random queries with every search mode. Plain Dijkstra
+ * is A* with a zero heuristic and gives the reference distances; the A*
+ * row uses the grid distance, since every step costs at least 1.
+ *
+ * @param typeName Name of the weight type, for the table.
+ * @param vertices Number of vertices in the generated graph.
+ */
+template <typename T>
+void benchmarkType(const std::string &typeName, int vertices) {
+  using Clock = std::chrono::steady_clock;
+  using Us = std::chrono::duration<double, std::micro>;
+  const int QUERIES = 50;
+  const int LANDMARKS = 16;
+
+  Graph<T> graph = makeRoadGraph<T>(vertices, 42);
+  int width = static_cast<int>(std::ceil(std::sqrt(vertices)));
+
+  auto start = Clock::now();
+  Landmarks<T> landmarks = graph.selectLandmarks(LANDMARKS);
+  double landmarkMs = Us(Clock::now() - start).count() / 1000.0;
+
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> anyVertex(0, vertices - 1);
+  std::vector<PathQuery> queries(QUERIES);
+  for (PathQuery &query : queries) query = {anyVertex(rng), anyVertex(rng)};
+
+  // Reference distances from full Dijkstra runs, which share no code with
+  // the point-to-point searches under test
+  std::vector<T> reference(QUERIES), distances;
+  for (int q = 0; q < QUERIES; ++q) {
+    graph.dijkstra(queries[q].source, distances);
+    reference[q] = distances[queries[q].target];
+  }
+
+  const char *modes[] = {"dijkstra", "a*", "bidirectional", "alt"};
+  for (int mode = 0; mode < 4; ++mode) {
+    double settledSum = 0;
+    bool ok = true;
+    start = Clock::now();
+    for (int q = 0; q < QUERIES; ++q) {
+      int source = queries[q].source, target = queries[q].target;
+      auto gridDistance = [&](int v) {
+        return static_cast<T>(std::max(std::abs(v % width - target % width),
+                                       std::abs(v / width - target / width)));
+      };
+      T distance;
+      std::size_t settled = 0;
+      switch (mode) {
+        case 0:
+          graph.aStar(source, target, [](int) { return T(0); }, distance,
+                      &settled);
+          break;
+        case 1:
+          graph.aStar(source, target, gridDistance, distance, &settled);
+          break;
+        case 2:
+          graph.bidirectionalDijkstra(source, target, distance, &settled);
+          break;
+        default:
+          graph.alt(landmarks, source, target, distance, &settled);
+          break;
+      }
+      T scale = std::max(std::abs(distance), std::abs(reference[q]));
+      ok &= std::abs(distance - reference[q]) <= scale * static_cast<T>(1e-5);
+      settledSum += static_cast<double>(settled);
+    }
+    double us = Us(Clock::now() - start).count() / QUERIES;
+    printRow(typeName, vertices, modes[mode], settledSum / QUERIES, us, ok);
+  }
+  std::cout << Color::CYAN << "  " << LANDMARKS << " landmarks in "
+            << std::setprecision(0) << landmarkMs << " ms" << Color::RESET
+            << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<int> sizes;
+  for (int i = 1; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+  if (sizes.empty()) sizes = {100000, 1000000};
+
+  std::cout << Color::BOLD << Color::MAGENTA
+            << "\n[Point-to-point search modes on road-like graphs]"
+            << Color::RESET << std::endl;
+  std::cout << std::setw(8) << "Type" << std::setw(10) << "Vertices"
+            << std::setw(16) << "Mode" << std::setw(14) << "Settled"
+            << std::setw(14) << "Time (us)" << std::endl;
+  std::cout << std::string(66, '-') << std::endl;
+
+  for (int vertices : sizes) {
+    benchmarkType<int>("int", vertices);
+    benchmarkType<float>("float", vertices);
+    benchmarkType<double>("double", vertices);
+  }
+  return 0;
+}
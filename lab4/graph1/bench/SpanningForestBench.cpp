@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../src/Graph.cpp"
+#include "BenchUtil.hpp"
+
+/**
+ * Runs every spanning forest algorithm on one graph and prints a row for
+ * each, checking its edge count and total weight against Kruskal's. The
+ * parallel ones run on one thread and on maxThreads threads. Prim's time
+ * includes building the reverse edges it scans, which is a one-time cost
+ * per graph.
+ */
+void benchmark(int vertices, unsigned maxThreads) {
+  Graph<int> graph = makeRoadGraph<int>(vertices, 42);
+  SpanningForest<int> reference;
+  double kruskalMs = 0;
+
+  auto row = [&](SpanningForestMode mode, const std::string &name,
+                 unsigned threads) {
+    ThreadPool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+    SpanningForest<int> forest = graph.minimumSpanningForest(mode, pool);
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    if (reference.edges.empty()) {
+      reference = forest;
+      kruskalMs = ms;
+    }
+    bool ok = forest.edges.size() == reference.edges.size() &&
+              forest.totalWeight == reference.totalWeight;
+
+    std::cout << std::setw(10) << vertices << std::setw(12)
+              << graph.getNumEdges() << std::setw(10) << name << std::setw(9)
+              << threads << std::setw(12) << std::fixed
+              << std::setprecision(1) << ms << std::setw(9)
+              << std::setprecision(2) << kruskalMs / ms << "x"
+              << std::setw(14) << forest.totalWeight << "  "
+              << (ok ? Color::GREEN + "ok" : Color::RED + "MISMATCH")
+              << Color::RESET << std::endl;
+  };
+
+  row(SpanningForestMode::Kruskal, "kruskal", 1);
+  if (maxThreads > 1) row(SpanningForestMode::Kruskal, "kruskal", maxThreads);
+  row(SpanningForestMode::Prim, "prim", 1);
+  row(SpanningForestMode::Boruvka, "boruvka", 1);
+  if (maxThreads > 1) row(SpanningForestMode::Boruvka, "boruvka", maxThreads);
+}
+
+int main(int argc, char *argv[]) {
+  unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<int> sizes;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      maxThreads = std::max(1, std::atoi(argv[++i]));
+    } else {
+      sizes.push_back(std::atoi(argv[i]));
+    }
+  }
+  if (sizes.empty()) sizes = {1000000};
+
+  std::cout << Color::BOLD << Color::MAGENTA
+            << "\n[Minimum spanning forests on road-like graphs]"
+            << Color::RESET << std::endl;
+  std::cout << std::setw(10) << "Vertices" << std::setw(12) << "Edges"
+            << std::setw(10) << "Algorithm" << std::setw(9) << "Threads"
+            << std::setw(12) << "Time (ms)" << std::setw(10) << "Speedup"
+            << std::setw(14) << "Weight" << std::endl;
+  std::cout << std::string(81, '-') << std::endl;
+
+  for (int vertices : sizes) benchmark(vertices, maxThreads);
+  return 0;
+}
@@ -0,0 +1,72 @@
+#ifndef CONTRACTION_HIERARCHY_HPP
+#define CONTRACTION_HIERARCHY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ArrayView.hpp"
+#include "Graph.hpp"
+
+/**
+ * Contraction hierarchy over a finalized Graph<T> with non-negative
+ * weights. build() contracts the vertices one by one, cheapest first by
+ * edge difference, and adds a shortcut wherever removing a vertex would
+ * lengthen a shortest path. A point-to-point query then runs two small
+ * Dijkstra searches that only climb to higher-ranked vertices.
+ *
+ * The hierarchy is immutable; copies share the same arrays. save() writes
+ * it in a binary format that load() memory-maps and uses in place.
+ */
+template <typename T>
+class ContractionHierarchy {
+ private:
+  // Arcs in CSR form: the arcs of vertex v are the entries
+  // [offsets[v], offsets[v + 1]) of the other arrays
+  struct ArcList {
+    ArrayView<std::size_t> offsets;
+    ArrayView<int> targets;
+    ArrayView<T> weights;
+    ArrayView<int> middles;  // vertex a shortcut skips, -1 for graph edges
+  };
+
+  struct Storage;
+
+  // Vertices are renumbered by rank, so the top of the hierarchy that
+  // every query climbs into is packed at the end of the arrays. Arc lists
+  // are indexed by rank and store ranks.
+  ArcList up;    // r -> s with s > r
+  ArcList down;  // s -> r with s > r, stored reversed at r
+  ArrayView<int> ranks;     // vertex -> rank
+  ArrayView<int> vertices;  // rank -> vertex
+  std::shared_ptr<const void> owner;  // keeps the arrays above alive
+  int numVertices;
+
+  ContractionHierarchy();
+
+ public:
+  static ContractionHierarchy build(const Graph<T> &graph);
+  static ContractionHierarchy load(const std::string &filename,
+                                   bool verifyChecksum = false);
+  void save(const std::string &filename) const;
+
+  bool query(int source, int target, T &distance) const;
+  bool query(int source, int target, T &distance,
+             std::vector<int> &path) const;
+
+  int getNumVertices() const { return numVertices; }
+  int rankOf(int v) const { return ranks[v]; }
+  std::size_t getNumArcs() const {
+    return up.targets.size() + down.targets.size();
+  }
+  std::size_t getNumShortcuts() const;
+
+ private:
+  int search(int source, int target, T &distance) const;
+  int findMiddle(int from, int to) const;
+  void unpackArc(int from, int to, std::vector<int> &path) const;
+};
+
+#endif /* CONTRACTION_HIERARCHY_HPP */
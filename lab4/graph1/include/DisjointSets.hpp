@@ -0,0 +1,33 @@
+#ifndef DISJOINT_SETS_HPP
+#define DISJOINT_SETS_HPP
+
+#include <vector>
+
+/**
+ * Union-find over the elements [0, size) with union by size and full path
+ * compression, which keeps every operation at near constant amortized
+ * cost. Used by Graph<T>::minimumSpanningForest.
+ */
+class DisjointSets {
+ private:
+  std::vector<int> parent;  // parent[x] == x for the representative
+  std::vector<int> sizes;   // set size, valid at representatives
+
+ public:
+  explicit DisjointSets(int size);
+
+  int find(int x) {
+    int root = x;
+    while (parent[root] != root) root = parent[root];
+    while (parent[x] != root) {
+      int next = parent[x];
+      parent[x] = root;
+      x = next;
+    }
+    return root;
+  }
+
+  bool unite(int a, int b);
+};
+
+#endif /* DISJOINT_SETS_HPP */
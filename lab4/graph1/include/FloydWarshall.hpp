@@ -0,0 +1,41 @@
+#ifndef FLOYD_WARSHALL_HPP
+#define FLOYD_WARSHALL_HPP
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include "ThreadPool.hpp"
+
+// Side of the square tiles the matrix is processed in. Three tiles of
+// doubles fit in L2, and every tile row is a whole number of AVX2 vectors.
+constexpr std::size_t FLOYD_WARSHALL_TILE = 64;
+
+// Value the kernels use for a missing path: +infinity for floating point
+// types and half the maximum for integers, so that adding two of them
+// cannot overflow
+template <typename T>
+constexpr T floydWarshallInfinity() {
+  if constexpr (std::is_integral_v<T>) {
+    return std::numeric_limits<T>::max() / 2;
+  } else {
+    return std::numeric_limits<T>::infinity();
+  }
+}
+
+/**
+ * Cache-blocked Floyd-Warshall used by Graph<T>::allPairsShortestPaths.
+ * The row-major matrix is split into FLOYD_WARSHALL_TILE-sized tiles and
+ * every block of pivots runs in three phases: the pivot tile on its own,
+ * then the rest of its tile row and column, then every other tile as a
+ * min-plus product of the two. The last two phases run tiles in parallel.
+ * The tile kernels use AVX2 when the CPU has it and plain loops otherwise.
+ *
+ * The matrix side must be a multiple of the tile size, missing edges must
+ * hold floydWarshallInfinity<T>() and the graph must not have a negative
+ * cycle.
+ */
+template <typename T>
+void floydWarshall(T *matrix, std::size_t side, ThreadPool &pool);
+
+#endif /* FLOYD_WARSHALL_HPP */
@@ -2,25 +2,97 @@
 #define D735F8E8_8C27_4C0D_A975_B917F625D76B
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
-// Try multiple possible paths for json.hpp
-#if __has_include(<nlohmann/json.hpp>)
-#include <nlohmann/json.hpp>
-#elif __has_include("../../deps/nlohmann/json.hpp")
-#include "../../deps/nlohmann/json.hpp"
-#else
-#error "Could not find nlohmann/json.hpp. Please run 'make deps' first."
-#endif
+#include "ArrayView.hpp"
+#include "DisjointSets.hpp"
+#include "DotWriter.hpp"
+#include "FloydWarshall.hpp"
+#include "GraphLoader.hpp"
+#include "GraphSnapshot.hpp"
+#include "Heap.hpp"
+#include "SearchWorkspace.hpp"
+#include "ThreadPool.hpp"
 
 template <typename T>
 class Graph;
 
+// Rounds: classic |V|-1 relaxation passes, stopping after a pass with no
+// change. Spfa: FIFO work queue with small-label-first / large-label-last.
+enum class BellmanFordMode { Rounds, Spfa };
+
+// One shortest path question for Graph<T>::shortestPaths
+struct PathQuery {
+  int source;
+  int target;
+};
+
+// Distances between every vertex and a few landmark vertices, the
+// preprocessing of Graph<T>::alt. Values are stored vertex by vertex, so
+// the bounds for one vertex are read from one place.
+template <typename T>
+struct Landmarks {
+  std::vector<int> vertices;
+  std::vector<T> fromLandmark;  // [v * count() + i]: landmark i -> v
+  std::vector<T> toLandmark;    // [v * count() + i]: v -> landmark i
+  int count() const { return static_cast<int>(vertices.size()); }
+};
+
+// FloydWarshall: cache-blocked, vectorized O(V^3) relaxation, for dense
+// graphs. Johnson: one Dijkstra per source in parallel on weights made
+// non-negative with Bellman-Ford potentials, for sparse graphs.
+enum class AllPairsMode { FloydWarshall, Johnson };
+
+// Distances between all pairs of vertices from
+// Graph<T>::allPairsShortestPaths, row-major in one contiguous array:
+// values[from * size + to], std::numeric_limits<T>::max() if unreachable
+template <typename T>
+struct DistanceMatrix {
+  int size = 0;
+  std::vector<T> values;
+  T at(int from, int to) const {
+    return values[static_cast<std::size_t>(from) * size + to];
+  }
+};
+
+// Kruskal: all edges sorted by weight in parallel, then one union-find
+// pass. Prim: grows one tree at a time from an indexed 4-ary heap.
+// Boruvka: every component picks its lightest edge in parallel, in rounds.
+enum class SpanningForestMode { Kruskal, Prim, Boruvka };
+
+// Result of Graph<T>::minimumSpanningForest: the edges, as stored in the
+// graph, of a minimum spanning tree of every connected component. The
+// total is summed in a wider type, since it can overflow T.
+template <typename T>
+struct SpanningForest {
+  using Sum = std::conditional_t<std::is_integral_v<T>, long long, double>;
+  struct Edge {
+    int from;
+    int to;
+    T weight;
+  };
+  std::vector<Edge> edges;
+  Sum totalWeight = 0;
+};
+
+template <typename T>
+class ContractionHierarchy;
+
+template <typename T>
+class DynamicGraph;
+
 template <typename T>
 std::ostream &operator<<(std::ostream &os, const Graph<T> &graph);
 
@@ -28,25 +100,124 @@ template <typename T>
 class Graph {
  private:
   struct Edge {
+    int from;
     int to;
     T weight;
   };
 
-  std::vector<std::vector<Edge>> adjList;
+  // Builder phase: edges collected by addEdge until finalize() is called
+  std::vector<Edge> pendingEdges;
+
+  // Frozen CSR layout: the out-edges of vertex v are the entries
+  // [offsets[v], offsets[v + 1]) of targets and weights. The views point
+  // either into the storage vectors below or into a mapped snapshot file.
+  ArrayView<std::size_t> offsets;
+  ArrayView<int> targets;
+  ArrayView<T> weights;
+  std::vector<std::size_t> offsetStorage;
+  std::vector<int> targetStorage;
+  std::vector<T> weightStorage;
+  std::shared_ptr<const MappedFile> snapshot;
+
+  // Incoming edges of every vertex in CSR form, for searches that walk
+  // edges backwards
+  struct ReverseEdges {
+    std::vector<std::size_t> offsets;
+    std::vector<int> sources;
+    std::vector<T> weights;
+  };
+
+  // Derived data computed on first use and published with the
+  // std::atomic_* shared_ptr functions
+  mutable std::shared_ptr<const bool> negativeWeights;
+  mutable std::shared_ptr<const ReverseEdges> reverseEdges;
   int numVertices;
+  bool finalized;
+
+  Graph();
 
  public:
   explicit Graph(const std::string &filename);
+  explicit Graph(int vertices);
+  Graph(const Graph &other);
+  Graph(Graph &&other) noexcept = default;
+  Graph &operator=(const Graph &other);
+  Graph &operator=(Graph &&other) noexcept = default;
   void addEdge(int from, int to, T weight);
+  void finalize();
+  bool isFinalized() const { return finalized; }
   friend std::ostream &operator<<<>(std::ostream &os, const Graph &graph);
+  friend class ContractionHierarchy<T>;
+  friend class DynamicGraph<T>;
 
   void readGraphFromFile(const std::string &filename);
-  std::string toDot() const;
+  void save(const std::string &filename) const;
+  static Graph load(const std::string &filename, bool verifyChecksum = false);
+  void toDot(std::ostream &os, const DotOptions &options = DotOptions()) const;
+  void toDot(int fd, const DotOptions &options = DotOptions()) const;
   bool bellmanFord(int src, std::vector<T> &distances);
-  bool dijkstra(int src, std::vector<T> &distances);
+  bool bellmanFord(int src, std::vector<T> &distances,
+                   std::vector<int> &negativeCycle,
+                   BellmanFordMode mode = BellmanFordMode::Spfa);
+  bool dijkstra(int src, std::vector<T> &distances,
+                HeapType heapType = HeapType::Binary);
+  bool deltaStepping(int src, std::vector<T> &distances, T delta = T(),
+                     ThreadPool &pool = ThreadPool::shared()) const;
+  bool shortestPaths(const std::vector<PathQuery> &queries,
+                     std::vector<T> &distances) const;
+  bool aStar(int source, int target, const std::function<T(int)> &heuristic,
+             T &distance, std::size_t *settled = nullptr) const;
+  bool bidirectionalDijkstra(int source, int target, T &distance,
+                             std::size_t *settled = nullptr) const;
+  Landmarks<T> selectLandmarks(int count) const;
+  bool alt(const Landmarks<T> &landmarks, int source, int target, T &distance,
+           std::size_t *settled = nullptr) const;
+  bool allPairsShortestPaths(
+      DistanceMatrix<T> &distances,
+      AllPairsMode mode = AllPairsMode::FloydWarshall,
+      ThreadPool &pool = ThreadPool::shared()) const;
+  SpanningForest<T> minimumSpanningForest(
+      SpanningForestMode mode = SpanningForestMode::Kruskal,
+      ThreadPool &pool = ThreadPool::shared()) const;
+  int getNumVertices() const { return numVertices; }
+  std::size_t getNumEdges() const { return targets.size(); }
 
  private:
   void readGraphFromJson(const std::string &filename);
+  void readGraphFromSnapshot(const std::string &filename, bool verifyChecksum);
+  void bindStorage();
+  void requireFinalized() const;
+  bool hasNegativeWeights() const;
+  const ReverseEdges &reverse() const;
+  T defaultDelta() const;
+  void writeDot(DotWriter &dot, const DotOptions &options) const;
+  template <typename Heap>
+  void dijkstraWithHeap(int src, std::vector<T> &distances,
+                        const std::size_t *edgeOffsets, const int *edgeTargets,
+                        const T *edgeWeights) const;
+  template <typename Heuristic>
+  bool aStarSearch(int source, int target, const Heuristic &heuristic,
+                   T &distance, std::size_t *settled) const;
+  void answerQueryGroup(const std::vector<PathQuery> &queries,
+                        const std::vector<std::size_t> &order,
+                        std::size_t first, std::size_t last,
+                        std::vector<T> &distances) const;
+  bool bellmanFordRounds(int src, std::vector<T> &distances,
+                         std::vector<int> &parent,
+                         std::vector<int> &negativeCycle) const;
+  bool bellmanFordSpfa(int src, std::vector<T> &distances,
+                       std::vector<int> &parent,
+                       std::vector<int> &negativeCycle) const;
+  bool johnsonPotentials(std::vector<T> &potentials) const;
+  void floydWarshallMatrix(DistanceMatrix<T> &distances,
+                           ThreadPool &pool) const;
+  void johnson(DistanceMatrix<T> &distances,
+               const std::vector<T> &potentials, ThreadPool &pool) const;
+  void kruskal(SpanningForest<T> &forest, ThreadPool &pool) const;
+  void prim(SpanningForest<T> &forest) const;
+  void boruvka(SpanningForest<T> &forest, ThreadPool &pool) const;
+  bool findParentCycle(const std::vector<int> &parent,
+                       std::vector<int> &cycle) const;
 };
 
 #endif /* D735F8E8_8C27_4C0D_A975_B917F625D76B */
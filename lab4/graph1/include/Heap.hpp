@@ -0,0 +1,116 @@
+#ifndef HEAP_HPP
+#define HEAP_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Priority queue implementations used by Graph<T>::dijkstra. Every heap is
+ * indexed by vertex id in [0, capacity) so the shortest path engine can be
+ * written once against the same interface:
+ *
+ *   push(v, key)         insert a vertex that is not in the heap
+ *   decreaseKey(v, key)  lower the key of a vertex that is in the heap
+ *   pop()                remove and return the (vertex, key) with minimum key
+ */
+enum class HeapType { Binary, FourAry, Pairing, Radix };
+
+const char *heapTypeName(HeapType type);
+
+/**
+ * Indexed d-ary min-heap. D = 2 is the classic binary heap, D = 4 trades a
+ * few extra comparisons per sift-down for a shallower, more cache-friendly
+ * tree.
+ */
+template <typename T, int D>
+class DaryHeap {
+ private:
+  std::vector<int> heap;      // heap position -> vertex
+  std::vector<int> position;  // vertex -> heap position, -1 if absent
+  std::vector<T> keys;        // vertex -> current key
+
+  void siftUp(int index);
+  void siftDown(int index);
+
+ public:
+  explicit DaryHeap(int capacity);
+  bool empty() const { return heap.empty(); }
+  bool contains(int vertex) const { return position[vertex] != -1; }
+  int capacity() const { return static_cast<int>(position.size()); }
+  T topKey() const { return keys[heap.front()]; }
+  void push(int vertex, T key);
+  void decreaseKey(int vertex, T key);
+  std::pair<int, T> pop();
+  void clear();
+};
+
+template <typename T>
+using BinaryHeap = DaryHeap<T, 2>;
+
+template <typename T>
+using FourAryHeap = DaryHeap<T, 4>;
+
+/**
+ * Pairing heap with O(1) insert and decrease-key. Nodes live in flat arrays
+ * indexed by vertex, so no per-node allocation happens during a search.
+ */
+template <typename T>
+class PairingHeap {
+ private:
+  std::vector<T> keys;
+  std::vector<int> child;    // leftmost child, -1 if none
+  std::vector<int> sibling;  // next sibling, -1 if none
+  std::vector<int> prev;     // parent for leftmost children, else left sibling
+  std::vector<char> inHeap;
+  std::vector<int> pairs;    // scratch buffer for the two-pass merge
+  int root;
+
+  int meld(int a, int b);
+  void cut(int vertex);
+
+ public:
+  explicit PairingHeap(int capacity);
+  bool empty() const { return root == -1; }
+  bool contains(int vertex) const { return inHeap[vertex] != 0; }
+  void push(int vertex, T key);
+  void decreaseKey(int vertex, T key);
+  std::pair<int, T> pop();
+};
+
+/**
+ * Monotone radix heap. Keys must be non-negative and never smaller than the
+ * last popped key, which always holds for Dijkstra with non-negative weights.
+ * Floating point keys are bucketed by their IEEE-754 bit pattern, which is
+ * order preserving for non-negative values.
+ */
+template <typename T>
+class RadixHeap {
+ private:
+  static constexpr int NUM_BUCKETS = 65;
+
+  struct Entry {
+    std::uint64_t radix;
+    int vertex;
+  };
+
+  std::vector<Entry> buckets[NUM_BUCKETS];
+  std::vector<T> keys;
+  std::vector<char> inHeap;
+  std::uint64_t last;
+  std::size_t count;
+
+  static std::uint64_t toRadix(T key);
+  int bucketIndex(std::uint64_t radix) const;
+  void insert(int vertex, T key);
+
+ public:
+  explicit RadixHeap(int capacity);
+  bool empty() const { return count == 0; }
+  bool contains(int vertex) const { return inHeap[vertex] != 0; }
+  void push(int vertex, T key);
+  void decreaseKey(int vertex, T key);
+  std::pair<int, T> pop();
+};
+
+#endif /* HEAP_HPP */
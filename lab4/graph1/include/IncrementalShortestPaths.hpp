@@ -0,0 +1,49 @@
+#ifndef INCREMENTAL_SHORTEST_PATHS_HPP
+#define INCREMENTAL_SHORTEST_PATHS_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "DynamicGraph.hpp"
+#include "Heap.hpp"
+
+/**
+ * Single-source shortest path distances over a DynamicGraph with
+ * non-negative weights, kept up to date across edit batches in the style
+ * of Ramalingam and Reps. After a batch only the vertices whose distance
+ * can change are touched: the shortest path subtrees hanging below tree
+ * edges that got heavier or disappeared, plus whatever the lighter and new
+ * edges improve.
+ *
+ * The graph must outlive this object, and every batch applied to it must
+ * be passed to update() before the distances are read again.
+ */
+template <typename T>
+class IncrementalShortestPaths {
+ private:
+  const DynamicGraph<T> *graph;
+  int source;
+  std::vector<T> dist;
+  std::vector<int> parent;    // predecessor in the shortest path tree
+  std::vector<char> orphan;   // scratch: vertex lost its tree path
+  FourAryHeap<T> queue;
+  std::size_t lastTouched;
+
+ public:
+  IncrementalShortestPaths(const DynamicGraph<T> &graph, int source);
+
+  void update(const std::vector<EdgeChange<T>> &changes);
+
+  int getSource() const { return source; }
+  const std::vector<T> &distances() const { return dist; }
+  T distance(int v) const { return dist[v]; }
+  int parentOf(int v) const { return parent[v]; }
+  std::size_t getLastTouched() const { return lastTouched; }
+
+ private:
+  void grow();
+  void improve(int v, T distance, int from);
+  void propagate();
+};
+
+#endif /* INCREMENTAL_SHORTEST_PATHS_HPP */
@@ -0,0 +1,56 @@
+#ifndef SEARCH_WORKSPACE_HPP
+#define SEARCH_WORKSPACE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Heap.hpp"
+
+/**
+ * Scratch state for running many Dijkstra searches one after another on
+ * the same thread. Instead of clearing per-vertex arrays before each
+ * search, every entry carries the number of the search that last wrote
+ * it; begin() starts a new search by bumping that number, so a search
+ * only pays for the vertices it actually touches.
+ */
+template <typename T>
+class SearchWorkspace {
+ private:
+  // Everything a search reads about one vertex sits in one entry, so a
+  // relaxation touches a single cache line
+  struct Entry {
+    T distance;
+    std::uint32_t reached;  // stamp: distance is valid
+    std::uint32_t settled;  // stamp: distance is final
+    std::uint32_t wanted;   // stamp: vertex is a query target
+  };
+
+  std::vector<Entry> entries;
+  std::uint32_t version;
+  FourAryHeap<T> queue;
+
+ public:
+  SearchWorkspace();
+  void begin(int vertices);
+
+  FourAryHeap<T> &heap() { return queue; }
+
+  T distance(int v) const {
+    return entries[v].reached == version ? entries[v].distance
+                                         : std::numeric_limits<T>::max();
+  }
+  bool isReached(int v) const { return entries[v].reached == version; }
+  void setDistance(int v, T distance) {
+    entries[v].distance = distance;
+    entries[v].reached = version;
+  }
+
+  bool isSettled(int v) const { return entries[v].settled == version; }
+  void settle(int v) { entries[v].settled = version; }
+
+  bool isTarget(int v) const { return entries[v].wanted == version; }
+  bool markTarget(int v);
+};
+
+#endif /* SEARCH_WORKSPACE_HPP */
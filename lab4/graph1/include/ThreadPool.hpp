@@ -0,0 +1,131 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads that run data-parallel loops. The calling
+ * thread takes part in every loop as worker 0, so a pool of size 1 runs
+ * everything inline. Loops issued from inside a running loop are executed
+ * serially by the issuing worker instead of deadlocking.
+ */
+class ThreadPool {
+ private:
+  std::vector<std::thread> workers;
+  std::mutex loopMutex;  // one loop at a time when several threads share it
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  const std::function<void(unsigned)> *task;
+  unsigned long generation;
+  unsigned pending;
+  bool stopping;
+  std::exception_ptr failure;
+
+  void workerLoop(unsigned index);
+  void runOnAll(const std::function<void(unsigned)> &body);
+  static bool insideLoop();
+
+ public:
+  explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency());
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+  static ThreadPool &shared();
+
+  /**
+   * Splits [begin, end) into chunks of at most grain indices that the
+   * threads claim dynamically, which keeps skewed work balanced.
+   *
+   * @param body Called as body(lo, hi, worker) with worker < size().
+   */
+  template <typename Body>
+  void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                   Body body) {
+    if (begin >= end) return;
+    grain = std::max<std::size_t>(grain, 1);
+    if (end - begin <= grain || size() == 1 || insideLoop()) {
+      body(begin, end, 0u);
+      return;
+    }
+    std::atomic<std::size_t> next(begin);
+    std::function<void(unsigned)> chunkLoop = [&](unsigned worker) {
+      for (std::size_t lo = next.fetch_add(grain); lo < end;
+           lo = next.fetch_add(grain)) {
+        body(lo, std::min(lo + grain, end), worker);
+      }
+    };
+    runOnAll(chunkLoop);
+  }
+
+  /**
+   * Sorts a random access range: one run per thread is sorted in
+   * parallel, then neighbouring runs are merged pairwise, all pairs of a
+   * round in parallel. Not stable.
+   */
+  template <typename Iterator, typename Less>
+  void parallelSort(Iterator first, Iterator last, Less less) {
+    using Value = typename std::iterator_traits<Iterator>::value_type;
+    const std::size_t MIN_RUN = 1 << 16;
+    std::size_t count = static_cast<std::size_t>(last - first);
+    std::size_t runs = std::min<std::size_t>(size(), count / MIN_RUN);
+    if (runs <= 1 || insideLoop()) {
+      std::sort(first, last, less);
+      return;
+    }
+
+    std::vector<std::size_t> bounds(runs + 1);
+    for (std::size_t r = 0; r <= runs; ++r) bounds[r] = count * r / runs;
+    parallelFor(0, runs, 1, [&](std::size_t lo, std::size_t hi, unsigned) {
+      for (std::size_t r = lo; r < hi; ++r) {
+        std::sort(first + bounds[r], first + bounds[r + 1], less);
+      }
+    });
+
+    // Each round merges neighbouring runs pairwise, moving them between
+    // the range and the buffer; an odd run out is merged with nothing
+    std::vector<Value> buffer(count);
+    auto mergeRound = [&](auto from, auto to) {
+      std::size_t current = bounds.size() - 1;
+      parallelFor(0, (current + 1) / 2, 1,
+                  [&](std::size_t lo, std::size_t hi, unsigned) {
+                    for (std::size_t p = lo; p < hi; ++p) {
+                      std::size_t a = bounds[2 * p];
+                      std::size_t b = bounds[std::min(2 * p + 1, current)];
+                      std::size_t c = bounds[std::min(2 * p + 2, current)];
+                      std::merge(std::make_move_iterator(from + a),
+                                 std::make_move_iterator(from + b),
+                                 std::make_move_iterator(from + b),
+                                 std::make_move_iterator(from + c), to + a,
+                                 less);
+                    }
+                  });
+      std::vector<std::size_t> merged;
+      for (std::size_t r = 0; r < current; r += 2) merged.push_back(bounds[r]);
+      merged.push_back(count);
+      bounds.swap(merged);
+    };
+    while (true) {
+      mergeRound(first, buffer.begin());
+      if (bounds.size() == 2) {
+        std::move(buffer.begin(), buffer.end(), first);
+        return;
+      }
+      mergeRound(buffer.begin(), first);
+      if (bounds.size() == 2) return;
+    }
+  }
+};
+
+#endif /* THREAD_POOL_HPP */
@@ -0,0 +1,842 @@
+#include "../include/ContractionHierarchy.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+#include "../include/GraphLoader.hpp"
+#include "../include/GraphSnapshot.hpp"
+#include "../include/SearchWorkspace.hpp"
+
+namespace {
+
+/* ------------------------------ Builder ------------------------------- */
+
+template <typename T>
+struct Arc {
+  int vertex;
+  T weight;
+  int middle;  // contracted vertex the arc stands for, -1 for graph edges
+};
+
+/**
+ * Contracts a graph vertex by vertex. The arc lists only hold arcs between
+ * vertices that are not contracted yet; when a vertex is contracted its
+ * remaining arcs all lead to later, higher-ranked vertices and are moved to
+ * upArcs and downArcs, which become the hierarchy.
+ */
+template <typename T>
+class HierarchyBuilder {
+ private:
+  // Settled-vertex budget of one witness search. A search that gives up
+  // early only costs an unnecessary shortcut, never a wrong distance, so
+  // priority estimates use a much smaller budget than real contractions.
+  static constexpr int CONTRACT_SETTLE_LIMIT = 1000;
+  static constexpr int ESTIMATE_SETTLE_LIMIT = 10;
+
+  struct Shortcut {
+    int from;
+    int to;
+    T weight;
+  };
+
+  int numVertices;
+  std::vector<std::vector<Arc<T>>> outArcs;
+  std::vector<std::vector<Arc<T>>> inArcs;
+  std::vector<int> contractedNeighbours;
+  std::vector<char> contracted;
+  std::vector<Shortcut> shortcuts;
+  SearchWorkspace<T> workspace;
+
+  void findShortcuts(int v, int settleLimit);
+  void witnessSearch(int from, int skipped, T limit, int settleLimit);
+  int priority(int v);
+  void contract(int v);
+  void addArc(int from, int to, T weight, int middle);
+  static void removeArc(std::vector<Arc<T>> &arcs, int vertex);
+
+ public:
+  std::vector<std::vector<Arc<T>>> upArcs;
+  std::vector<std::vector<Arc<T>>> downArcs;
+  std::vector<int> order;  // vertices in contraction order
+
+  HierarchyBuilder(int vertices, std::vector<std::vector<Arc<T>>> edges);
+  void run();
+};
+
+/**
+ * Takes the out-edges of every vertex, drops self-loops and keeps only the
+ * lightest of parallel edges.
+ *
+ * @param vertices Number of vertices.
+ * @param edges Out-edges of every vertex.
+ */
+template <typename T>
+HierarchyBuilder<T>::HierarchyBuilder(int vertices,
+                                      std::vector<std::vector<Arc<T>>> edges)
+    : numVertices(vertices),
+      outArcs(std::move(edges)),
+      inArcs(vertices),
+      contractedNeighbours(vertices, 0),
+      contracted(vertices, 0),
+      upArcs(vertices),
+      downArcs(vertices) {
+  for (int u = 0; u < numVertices; ++u) {
+    auto &arcs = outArcs[u];
+    std::sort(arcs.begin(), arcs.end(), [](const Arc<T> &a, const Arc<T> &b) {
+      return a.vertex != b.vertex ? a.vertex < b.vertex : a.weight < b.weight;
+    });
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < arcs.size(); ++i) {
+      if (arcs[i].vertex == u) continue;
+      if (kept > 0 && arcs[kept - 1].vertex == arcs[i].vertex) continue;
+      arcs[kept++] = arcs[i];
+    }
+    arcs.resize(kept);
+    for (const Arc<T> &arc : arcs) {
+      inArcs[arc.vertex].push_back({u, arc.weight, -1});
+    }
+  }
+}
+
+/**
+ * Runs a Dijkstra search from a vertex over the remaining graph without
+ * passing through the vertex about to be contracted. The search stops once
+ * every vertex marked as a target in the workspace is settled, the
+ * distances exceed the limit, or the settle budget is used up.
+ *
+ * @param from Start vertex.
+ * @param skipped The vertex being contracted.
+ * @param limit Longest path worth looking at.
+ * @param settleLimit Maximum number of vertices to settle.
+ */
+template <typename T>
+void HierarchyBuilder<T>::witnessSearch(int from, int skipped, T limit,
+                                        int settleLimit) {
+  FourAryHeap<T> &heap = workspace.heap();
+  std::size_t remaining = 0;
+  for (const Arc<T> &arc : outArcs[skipped]) {
+    if (arc.vertex != from && workspace.markTarget(arc.vertex)) ++remaining;
+  }
+  // Settling the skipped vertex up front keeps the search off it
+  workspace.settle(skipped);
+  workspace.setDistance(from, 0);
+  heap.push(from, 0);
+
+  int settledCount = 0;
+  while (!heap.empty() && remaining > 0 && settledCount < settleLimit) {
+    auto [u, distU] = heap.pop();
+    if (distU > limit) break;
+    workspace.settle(u);
+    ++settledCount;
+    if (workspace.isTarget(u)) --remaining;
+
+    for (const Arc<T> &arc : outArcs[u]) {
+      if (workspace.isSettled(arc.vertex)) continue;
+      T candidate = distU + arc.weight;
+      if (candidate > limit) continue;
+      if (!workspace.isReached(arc.vertex)) {
+        heap.push(arc.vertex, candidate);
+        workspace.setDistance(arc.vertex, candidate);
+      } else if (candidate < workspace.distance(arc.vertex)) {
+        heap.decreaseKey(arc.vertex, candidate);
+        workspace.setDistance(arc.vertex, candidate);
+      }
+    }
+  }
+}
+
+/**
+ * Collects in `shortcuts` the arcs u -> w needed to keep every shortest path
+ * u -> v -> w intact once v is removed.
+ *
+ * @param v The vertex to contract.
+ * @param settleLimit Settle budget of each witness search.
+ */
+template <typename T>
+void HierarchyBuilder<T>::findShortcuts(int v, int settleLimit) {
+  shortcuts.clear();
+  for (const Arc<T> &in : inArcs[v]) {
+    T limit = 0;
+    bool anyTarget = false;
+    for (const Arc<T> &out : outArcs[v]) {
+      if (out.vertex == in.vertex) continue;
+      limit = std::max(limit, in.weight + out.weight);
+      anyTarget = true;
+    }
+    if (!anyTarget) continue;
+
+    workspace.begin(numVertices);
+    witnessSearch(in.vertex, v, limit, settleLimit);
+    for (const Arc<T> &out : outArcs[v]) {
+      if (out.vertex == in.vertex) continue;
+      T through = in.weight + out.weight;
+      bool witnessed = workspace.isReached(out.vertex) &&
+                       workspace.distance(out.vertex) <= through;
+      if (!witnessed) shortcuts.push_back({in.vertex, out.vertex, through});
+    }
+  }
+}
+
+/**
+ * Contraction priority of a vertex: twice its edge difference (shortcuts
+ * added minus arcs removed) plus the number of neighbours already
+ * contracted, which spreads the contractions evenly over the graph.
+ *
+ * @param v The vertex to rate.
+ * @return int Lower values are contracted first.
+ */
+template <typename T>
+int HierarchyBuilder<T>::priority(int v) {
+  findShortcuts(v, ESTIMATE_SETTLE_LIMIT);
+  int edgeDifference = static_cast<int>(shortcuts.size()) -
+                       static_cast<int>(inArcs[v].size() + outArcs[v].size());
+  return 2 * edgeDifference + contractedNeighbours[v];
+}
+
+/**
+ * Removes the arc to or from a vertex from one arc list.
+ */
+template <typename T>
+void HierarchyBuilder<T>::removeArc(std::vector<Arc<T>> &arcs, int vertex) {
+  for (std::size_t i = 0; i < arcs.size(); ++i) {
+    if (arcs[i].vertex == vertex) {
+      arcs[i] = arcs.back();
+      arcs.pop_back();
+      return;
+    }
+  }
+}
+
+/**
+ * Adds an arc between two remaining vertices, or shortens the existing one.
+ */
+template <typename T>
+void HierarchyBuilder<T>::addArc(int from, int to, T weight, int middle) {
+  for (Arc<T> &out : outArcs[from]) {
+    if (out.vertex != to) continue;
+    if (weight < out.weight) {
+      out.weight = weight;
+      out.middle = middle;
+      for (Arc<T> &in : inArcs[to]) {
+        if (in.vertex == from) {
+          in.weight = weight;
+          in.middle = middle;
+          break;
+        }
+      }
+    }
+    return;
+  }
+  outArcs[from].push_back({to, weight, middle});
+  inArcs[to].push_back({from, weight, middle});
+}
+
+/**
+ * Removes a vertex from the remaining graph, keeping its arcs as part of
+ * the hierarchy and bridging it with shortcuts where needed.
+ */
+template <typename T>
+void HierarchyBuilder<T>::contract(int v) {
+  // Shortcuts are applied only after every witness search has run: a
+  // shortcut through v must not serve as a witness for avoiding v
+  findShortcuts(v, CONTRACT_SETTLE_LIMIT);
+
+  for (const Arc<T> &in : inArcs[v]) removeArc(outArcs[in.vertex], v);
+  for (const Arc<T> &out : outArcs[v]) removeArc(inArcs[out.vertex], v);
+  upArcs[v] = std::move(outArcs[v]);
+  downArcs[v] = std::move(inArcs[v]);
+  outArcs[v] = {};
+  inArcs[v] = {};
+  contracted[v] = 1;
+
+  for (const Shortcut &shortcut : shortcuts) {
+    addArc(shortcut.from, shortcut.to, shortcut.weight, v);
+  }
+}
+
+/**
+ * Contracts all vertices. The queue is updated lazily: a popped vertex is
+ * rated again and goes back in if it is no longer the cheapest, and the
+ * neighbours of each contracted vertex are rated again since their edge
+ * difference has changed.
+ */
+template <typename T>
+void HierarchyBuilder<T>::run() {
+  using Entry = std::pair<int, int>;  // (priority, vertex)
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  std::vector<int> current(numVertices);
+  for (int v = 0; v < numVertices; ++v) {
+    current[v] = priority(v);
+    queue.push({current[v], v});
+  }
+
+  order.reserve(numVertices);
+  std::vector<int> neighbours;
+  while (!queue.empty()) {
+    auto [rating, v] = queue.top();
+    queue.pop();
+    if (contracted[v] || rating != current[v]) continue;  // stale entry
+
+    int fresh = priority(v);
+    if (fresh > rating && !queue.empty() && fresh > queue.top().first) {
+      current[v] = fresh;
+      queue.push({fresh, v});
+      continue;
+    }
+
+    neighbours.clear();
+    for (const Arc<T> &arc : inArcs[v]) neighbours.push_back(arc.vertex);
+    for (const Arc<T> &arc : outArcs[v]) neighbours.push_back(arc.vertex);
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+                     neighbours.end());
+
+    contract(v);
+    order.push_back(v);
+
+    for (int u : neighbours) {
+      ++contractedNeighbours[u];
+      current[u] = priority(u);
+      queue.push({current[u], u});
+    }
+  }
+}
+
+/* ---------------------------- Query state ----------------------------- */
+
+/**
+ * Per-thread scratch space of the bidirectional query.
+ */
+template <typename T>
+struct QueryState {
+  SearchWorkspace<T> forward;
+  SearchWorkspace<T> backward;
+  std::vector<int> forwardParent;
+  std::vector<int> backwardParent;
+};
+
+template <typename T>
+QueryState<T> &queryState() {
+  static thread_local QueryState<T> state;
+  return state;
+}
+
+/* ----------------------------- File format ---------------------------- */
+
+/**
+ * Binary hierarchy file, laid out like a graph snapshot: native byte order,
+ * a header giving the position of every array, each array starting on an
+ * 8-byte boundary, and a checksum chained over all arrays.
+ */
+constexpr char MAGIC[8] = {'L', 'A', 'B', '4', 'C', 'H', '\0', '\0'};
+constexpr std::uint32_t VERSION = 1;
+
+enum Section {
+  RANKS,
+  VERTICES,
+  UP_OFFSETS,
+  UP_TARGETS,
+  UP_WEIGHTS,
+  UP_MIDDLES,
+  DOWN_OFFSETS,
+  DOWN_TARGETS,
+  DOWN_WEIGHTS,
+  DOWN_MIDDLES,
+  NUM_SECTIONS
+};
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t weightType;
+  std::uint64_t numVertices;
+  std::uint64_t numUpArcs;
+  std::uint64_t numDownArcs;
+  std::uint64_t sectionStart[NUM_SECTIONS];
+  std::uint64_t checksumStart;
+};
+
+std::uint64_t alignUp(std::uint64_t position) { return (position + 7) & ~7ULL; }
+
+/**
+ * Byte size of every section for the given counts.
+ */
+std::array<std::uint64_t, NUM_SECTIONS> sectionSizes(const Header &header,
+                                                     std::size_t weightSize) {
+  std::uint64_t n = header.numVertices;
+  std::array<std::uint64_t, NUM_SECTIONS> sizes = {};
+  sizes[RANKS] = n * sizeof(std::int32_t);
+  sizes[VERTICES] = n * sizeof(std::int32_t);
+  sizes[UP_OFFSETS] = (n + 1) * sizeof(std::uint64_t);
+  sizes[UP_TARGETS] = header.numUpArcs * sizeof(std::int32_t);
+  sizes[UP_WEIGHTS] = header.numUpArcs * weightSize;
+  sizes[UP_MIDDLES] = header.numUpArcs * sizeof(std::int32_t);
+  sizes[DOWN_OFFSETS] = (n + 1) * sizeof(std::uint64_t);
+  sizes[DOWN_TARGETS] = header.numDownArcs * sizeof(std::int32_t);
+  sizes[DOWN_WEIGHTS] = header.numDownArcs * weightSize;
+  sizes[DOWN_MIDDLES] = header.numDownArcs * sizeof(std::int32_t);
+  return sizes;
+}
+
+}  // namespace
+
+/**
+ * Owns the arrays of a hierarchy built in memory.
+ */
+template <typename T>
+struct ContractionHierarchy<T>::Storage {
+  std::vector<int> ranks;
+  std::vector<int> vertices;
+  std::vector<std::size_t> offsets[2];
+  std::vector<int> targets[2];
+  std::vector<T> weights[2];
+  std::vector<int> middles[2];
+};
+
+template <typename T>
+ContractionHierarchy<T>::ContractionHierarchy() : numVertices(0) {}
+
+/**
+ * Preprocesses a graph into a contraction hierarchy.
+ *
+ * @param graph A finalized graph with non-negative weights.
+ * @return ContractionHierarchy The hierarchy of the graph.
+ */
+template <typename T>
+ContractionHierarchy<T> ContractionHierarchy<T>::build(const Graph<T> &graph) {
+  graph.requireFinalized();
+  if (graph.hasNegativeWeights()) {
+    throw std::invalid_argument(
+        "Contraction hierarchies need non-negative edge weights");
+  }
+
+  int n = graph.numVertices;
+  std::vector<std::vector<Arc<T>>> edges(n);
+  for (int u = 0; u < n; ++u) {
+    edges[u].reserve(graph.offsets[u + 1] - graph.offsets[u]);
+    for (std::size_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+      edges[u].push_back({graph.targets[e], graph.weights[e], -1});
+    }
+  }
+  HierarchyBuilder<T> builder(n, std::move(edges));
+  builder.run();
+
+  auto storage = std::make_shared<Storage>();
+  storage->vertices = std::move(builder.order);
+  storage->ranks.assign(n, 0);
+  for (int r = 0; r < n; ++r) storage->ranks[storage->vertices[r]] = r;
+
+  const std::vector<std::vector<Arc<T>>> *lists[2] = {&builder.upArcs,
+                                                      &builder.downArcs};
+  for (int side = 0; side < 2; ++side) {
+    std::vector<std::size_t> &offsets = storage->offsets[side];
+    offsets.assign(n + 1, 0);
+    for (int r = 0; r < n; ++r) {
+      const auto &arcs = (*lists[side])[storage->vertices[r]];
+      offsets[r + 1] = offsets[r] + arcs.size();
+      for (const Arc<T> &arc : arcs) {
+        storage->targets[side].push_back(storage->ranks[arc.vertex]);
+        storage->weights[side].push_back(arc.weight);
+        storage->middles[side].push_back(
+            arc.middle < 0 ? -1 : storage->ranks[arc.middle]);
+      }
+    }
+  }
+
+  ContractionHierarchy hierarchy;
+  hierarchy.numVertices = n;
+  hierarchy.ranks = {storage->ranks.data(), storage->ranks.size()};
+  hierarchy.vertices = {storage->vertices.data(), storage->vertices.size()};
+  ArcList *sides[2] = {&hierarchy.up, &hierarchy.down};
+  for (int side = 0; side < 2; ++side) {
+    sides[side]->offsets = {storage->offsets[side].data(),
+                            storage->offsets[side].size()};
+    sides[side]->targets = {storage->targets[side].data(),
+                            storage->targets[side].size()};
+    sides[side]->weights = {storage->weights[side].data(),
+                            storage->weights[side].size()};
+    sides[side]->middles = {storage->middles[side].data(),
+                            storage->middles[side].size()};
+  }
+  hierarchy.owner = std::move(storage);
+  return hierarchy;
+}
+
+/**
+ * Writes the hierarchy to a binary file that load() can map.
+ *
+ * @param filename Path of the file to create or overwrite.
+ */
+template <typename T>
+void ContractionHierarchy<T>::save(const std::string &filename) const {
+  Header header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.weightType =
+      static_cast<std::uint32_t>(GraphSnapshot::weightTypeOf<T>());
+  header.numVertices = static_cast<std::uint64_t>(numVertices);
+  header.numUpArcs = up.targets.size();
+  header.numDownArcs = down.targets.size();
+
+  const void *data[NUM_SECTIONS] = {
+      ranks.data(),        vertices.data(),     up.offsets.data(),
+      up.targets.data(),   up.weights.data(),   up.middles.data(),
+      down.offsets.data(), down.targets.data(), down.weights.data(),
+      down.middles.data()};
+  auto sizes = sectionSizes(header, sizeof(T));
+  std::uint64_t position = alignUp(sizeof(Header));
+  std::uint64_t sum = 0;
+  for (int s = 0; s < NUM_SECTIONS; ++s) {
+    header.sectionStart[s] = position;
+    position = alignUp(position + sizes[s]);
+    sum = GraphSnapshot::checksum(data[s], sizes[s], sum);
+  }
+  header.checksumStart = position;
+
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("Could not create file: " + filename);
+  }
+  const char padding[8] = {};
+  auto writeAt = [&](std::uint64_t start, const void *bytes, std::size_t size) {
+    std::uint64_t at = static_cast<std::uint64_t>(file.tellp());
+    file.write(padding, static_cast<std::streamsize>(start - at));
+    file.write(static_cast<const char *>(bytes),
+               static_cast<std::streamsize>(size));
+  };
+
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (int s = 0; s < NUM_SECTIONS; ++s) {
+    writeAt(header.sectionStart[s], data[s], sizes[s]);
+  }
+  writeAt(header.checksumStart, &sum, sizeof(sum));
+
+  if (!file) {
+    throw std::runtime_error("Could not write file: " + filename);
+  }
+}
+
+/**
+ * Opens a hierarchy written by save(). The file is memory-mapped and
+ * queries read the mapped pages directly.
+ *
+ * @param filename Path of the hierarchy file.
+ * @param verifyChecksum Whether to hash the whole file before using it.
+ * @return ContractionHierarchy The loaded hierarchy.
+ */
+template <typename T>
+ContractionHierarchy<T> ContractionHierarchy<T>::load(
+    const std::string &filename, bool verifyChecksum) {
+  auto file = std::make_shared<const MappedFile>(filename, false);
+  if (file->size() < sizeof(Header)) {
+    throw std::runtime_error("Hierarchy file is truncated");
+  }
+  const Header &header = *reinterpret_cast<const Header *>(file->data());
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw std::runtime_error("Not a contraction hierarchy file");
+  }
+  if (header.version != VERSION) {
+    throw std::runtime_error("Unsupported hierarchy version " +
+                             std::to_string(header.version));
+  }
+  if (header.weightType !=
+      static_cast<std::uint32_t>(GraphSnapshot::weightTypeOf<T>())) {
+    throw std::runtime_error("Hierarchy weight type does not match");
+  }
+  if (header.numVertices >= static_cast<std::uint64_t>(INT32_MAX)) {
+    throw std::runtime_error("Hierarchy has too many vertices");
+  }
+
+  // Counts that could not fit in the file are rejected before the section
+  // sizes are computed from them, so the products cannot wrap around
+  std::uint64_t fileSize = file->size();
+  if (header.numVertices >= fileSize / sizeof(std::uint64_t) ||
+      header.numUpArcs > fileSize / sizeof(T) ||
+      header.numDownArcs > fileSize / sizeof(T)) {
+    throw std::runtime_error("Hierarchy file is truncated or corrupt");
+  }
+  auto sizes = sectionSizes(header, sizeof(T));
+  std::uint64_t end = sizeof(Header);
+  for (int s = 0; s < NUM_SECTIONS; ++s) {
+    if (header.sectionStart[s] % 8 != 0 || header.sectionStart[s] < end ||
+        !GraphSnapshot::endsBy(header.sectionStart[s], sizes[s], fileSize)) {
+      throw std::runtime_error("Hierarchy file is truncated or corrupt");
+    }
+    end = header.sectionStart[s] + sizes[s];
+  }
+  if (header.checksumStart < end ||
+      !GraphSnapshot::endsBy(header.checksumStart, sizeof(std::uint64_t),
+                             fileSize)) {
+    throw std::runtime_error("Hierarchy file is truncated or corrupt");
+  }
+
+  const char *base = file->data();
+  if (verifyChecksum) {
+    std::uint64_t sum = 0;
+    for (int s = 0; s < NUM_SECTIONS; ++s) {
+      sum = GraphSnapshot::checksum(base + header.sectionStart[s], sizes[s],
+                                    sum);
+    }
+    std::uint64_t stored;
+    std::memcpy(&stored, base + header.checksumStart, sizeof(stored));
+    if (sum != stored) {
+      throw std::runtime_error("Hierarchy checksum mismatch");
+    }
+  }
+
+  auto section = [&](int s) { return base + header.sectionStart[s]; };
+  std::size_t n = header.numVertices;
+  ContractionHierarchy hierarchy;
+  hierarchy.numVertices = static_cast<int>(n);
+  hierarchy.ranks = {reinterpret_cast<const int *>(section(RANKS)), n};
+  hierarchy.vertices = {reinterpret_cast<const int *>(section(VERTICES)), n};
+
+  // Queries index with every stored rank and vertex unchecked, so they are
+  // checked here even when the checksum is skipped
+  auto inRange = [&](ArrayView<int> values, int lowest) {
+    for (int value : values) {
+      if (value < lowest || value >= hierarchy.numVertices) return false;
+    }
+    return true;
+  };
+  if (!inRange(hierarchy.ranks, 0) || !inRange(hierarchy.vertices, 0)) {
+    throw std::runtime_error("Hierarchy ranks are corrupt");
+  }
+
+  auto bind = [&](ArcList &arcs, int first, std::size_t count) {
+    arcs.offsets = {reinterpret_cast<const std::size_t *>(section(first)),
+                    n + 1};
+    arcs.targets = {reinterpret_cast<const int *>(section(first + 1)), count};
+    arcs.weights = {reinterpret_cast<const T *>(section(first + 2)), count};
+    arcs.middles = {reinterpret_cast<const int *>(section(first + 3)), count};
+    if (!GraphSnapshot::isValidCsr(
+            reinterpret_cast<const std::uint64_t *>(section(first)),
+            reinterpret_cast<const std::int32_t *>(section(first + 1)), n,
+            count) ||
+        !inRange(arcs.middles, -1)) {
+      throw std::runtime_error("Hierarchy arcs are corrupt");
+    }
+  };
+  bind(hierarchy.up, UP_OFFSETS, header.numUpArcs);
+  bind(hierarchy.down, DOWN_OFFSETS, header.numDownArcs);
+  hierarchy.owner = std::move(file);
+  return hierarchy;
+}
+
+/**
+ * Counts the arcs that are shortcuts rather than edges of the graph.
+ *
+ * @return std::size_t Number of shortcuts.
+ */
+template <typename T>
+std::size_t ContractionHierarchy<T>::getNumShortcuts() const {
+  std::size_t count = 0;
+  for (int middle : up.middles) count += middle >= 0;
+  for (int middle : down.middles) count += middle >= 0;
+  return count;
+}
+
+/**
+ * Runs the bidirectional upward search between two ranks. The forward
+ * search follows up arcs from the source and the backward search follows
+ * down arcs from the target, taking turns; a side stops once its smallest
+ * key cannot improve the best meeting found so far. A settled vertex that
+ * a higher vertex already reaches more cheaply is stalled: its arcs are not
+ * relaxed, since it cannot lie on a shortest path.
+ *
+ * @param source Rank of the source.
+ * @param target Rank of the target.
+ * @param distance Set to the distance, or the maximum of T if unreachable.
+ * @return int Rank of the top vertex of the shortest path, -1 if none.
+ */
+template <typename T>
+int ContractionHierarchy<T>::search(int source, int target,
+                                    T &distance) const {
+  QueryState<T> &state = queryState<T>();
+  state.forward.begin(numVertices);
+  state.backward.begin(numVertices);
+  if (state.forwardParent.size() < static_cast<std::size_t>(numVertices)) {
+    state.forwardParent.resize(numVertices);
+    state.backwardParent.resize(numVertices);
+  }
+
+  T best = std::numeric_limits<T>::max();
+  int meeting = -1;
+
+  auto step = [&](SearchWorkspace<T> &own, const SearchWorkspace<T> &other,
+                  std::vector<int> &parent, const ArcList &relax,
+                  const ArcList &stall) {
+    auto [u, distU] = own.heap().pop();
+    own.settle(u);
+    if (other.isReached(u) && distU + other.distance(u) < best) {
+      best = distU + other.distance(u);
+      meeting = u;
+    }
+    for (std::size_t e = stall.offsets[u]; e < stall.offsets[u + 1]; ++e) {
+      int x = stall.targets[e];
+      if (own.isReached(x) && own.distance(x) + stall.weights[e] < distU) {
+        return;
+      }
+    }
+    for (std::size_t e = relax.offsets[u]; e < relax.offsets[u + 1]; ++e) {
+      int v = relax.targets[e];
+      T candidate = distU + relax.weights[e];
+      if (!own.isReached(v)) {
+        own.heap().push(v, candidate);
+      } else if (candidate < own.distance(v) && !own.isSettled(v)) {
+        own.heap().decreaseKey(v, candidate);
+      } else {
+        continue;
+      }
+      own.setDistance(v, candidate);
+      parent[v] = u;
+    }
+  };
+
+  state.forward.setDistance(source, 0);
+  state.forward.heap().push(source, 0);
+  state.forwardParent[source] = -1;
+  state.backward.setDistance(target, 0);
+  state.backward.heap().push(target, 0);
+  state.backwardParent[target] = -1;
+
+  bool forwardTurn = true;
+  while (true) {
+    bool forwardDone = state.forward.heap().empty() ||
+                       !(state.forward.heap().topKey() < best);
+    bool backwardDone = state.backward.heap().empty() ||
+                        !(state.backward.heap().topKey() < best);
+    if (forwardDone && backwardDone) break;
+    if (forwardDone) forwardTurn = false;
+    if (backwardDone) forwardTurn = true;
+
+    if (forwardTurn) {
+      step(state.forward, state.backward, state.forwardParent, up, down);
+    } else {
+      step(state.backward, state.forward, state.backwardParent, down, up);
+    }
+    forwardTurn = !forwardTurn;
+  }
+
+  distance = best;
+  return meeting;
+}
+
+/**
+ * Computes the shortest path distance between two vertices.
+ *
+ * @param source The source vertex.
+ * @param target The target vertex.
+ * @param distance Set to the distance, or the maximum of T if the target is
+ * unreachable.
+ * @return bool True if successful, false if a vertex is out of range.
+ */
+template <typename T>
+bool ContractionHierarchy<T>::query(int source, int target,
+                                    T &distance) const {
+  if (source < 0 || source >= numVertices || target < 0 ||
+      target >= numVertices) {
+    return false;
+  }
+  search(ranks[source], ranks[target], distance);
+  return true;
+}
+
+/**
+ * Computes the shortest path between two vertices, with shortcuts expanded
+ * back into edges of the original graph.
+ *
+ * @param source The source vertex.
+ * @param target The target vertex.
+ * @param distance Set to the distance, or the maximum of T if the target is
+ * unreachable.
+ * @param path Set to the vertices of the path from source to target, or
+ * left empty if the target is unreachable.
+ * @return bool True if successful, false if a vertex is out of range.
+ */
+template <typename T>
+bool ContractionHierarchy<T>::query(int source, int target, T &distance,
+                                    std::vector<int> &path) const {
+  path.clear();
+  if (source < 0 || source >= numVertices || target < 0 ||
+      target >= numVertices) {
+    return false;
+  }
+  int meeting = search(ranks[source], ranks[target], distance);
+  if (meeting < 0) return true;
+
+  // Ranks along the hierarchy path: up from the source to the meeting
+  // vertex, then down to the target
+  QueryState<T> &state = queryState<T>();
+  std::vector<int> climb;
+  for (int r = meeting; r != -1; r = state.forwardParent[r]) {
+    climb.push_back(r);
+  }
+  std::reverse(climb.begin(), climb.end());
+  for (int r = state.backwardParent[meeting]; r != -1;
+       r = state.backwardParent[r]) {
+    climb.push_back(r);
+  }
+
+  path.push_back(vertices[climb[0]]);
+  for (std::size_t i = 0; i + 1 < climb.size(); ++i) {
+    unpackArc(climb[i], climb[i + 1], path);
+  }
+  return true;
+}
+
+/**
+ * Looks up the vertex a hierarchy arc skips.
+ *
+ * @param from Rank of the tail of the arc.
+ * @param to Rank of the head of the arc.
+ * @return int Rank of the skipped vertex, -1 for an edge of the graph.
+ */
+template <typename T>
+int ContractionHierarchy<T>::findMiddle(int from, int to) const {
+  // An arc is stored at its lower-ranked end
+  const ArcList &arcs = from < to ? up : down;
+  int owner = std::min(from, to);
+  int other = std::max(from, to);
+  for (std::size_t e = arcs.offsets[owner]; e < arcs.offsets[owner + 1];
+       ++e) {
+    if (arcs.targets[e] == other) return arcs.middles[e];
+  }
+  throw std::logic_error("Hierarchy arc not found");
+}
+
+/**
+ * Appends the graph vertices after `from` on the path an arc stands for.
+ *
+ * @param from Rank of the tail of the arc.
+ * @param to Rank of the head of the arc.
+ * @param path Path to extend.
+ */
+template <typename T>
+void ContractionHierarchy<T>::unpackArc(int from, int to,
+                                        std::vector<int> &path) const {
+  std::vector<std::pair<int, int>> pending = {{from, to}};
+  while (!pending.empty()) {
+    auto [a, b] = pending.back();
+    pending.pop_back();
+    int middle = findMiddle(a, b);
+    if (middle < 0) {
+      path.push_back(vertices[b]);
+    } else {
+      pending.push_back({middle, b});
+      pending.push_back({a, middle});
+    }
+  }
+}
+
+// Explicit template instantiation
+template class ContractionHierarchy<int>;
+template class ContractionHierarchy<float>;
+template class ContractionHierarchy<double>;
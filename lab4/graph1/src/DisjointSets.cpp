@@ -0,0 +1,31 @@
+#include "../include/DisjointSets.hpp"
+
+#include <numeric>
+#include <utility>
+
+/**
+ * Starts with every element in a set of its own.
+ *
+ * @param size Number of elements.
+ */
+DisjointSets::DisjointSets(int size) : parent(size), sizes(size, 1) {
+  std::iota(parent.begin(), parent.end(), 0);
+}
+
+/**
+ * Merges the sets of two elements, hanging the smaller tree below the
+ * root of the larger one.
+ *
+ * @param a An element.
+ * @param b Another element.
+ * @return bool False if both were in the same set already.
+ */
+bool DisjointSets::unite(int a, int b) {
+  a = find(a);
+  b = find(b);
+  if (a == b) return false;
+  if (sizes[a] < sizes[b]) std::swap(a, b);
+  parent[b] = a;
+  sizes[a] += sizes[b];
+  return true;
+}
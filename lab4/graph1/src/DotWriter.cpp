@@ -0,0 +1,99 @@
+#include "../include/DotWriter.hpp"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+DotWriter::DotWriter(std::ostream &os)
+    : stream(&os), fd(-1), buffer(new char[BUFFER_SIZE]), used(0) {}
+
+/**
+ * Writes to an open file descriptor, which stays owned by the caller.
+ *
+ * @param fileDescriptor Descriptor opened for writing.
+ */
+DotWriter::DotWriter(int fileDescriptor)
+    : stream(nullptr), fd(fileDescriptor), buffer(new char[BUFFER_SIZE]),
+      used(0) {}
+
+/**
+ * Hands any buffered text over on a best-effort basis; call flush() to see
+ * write errors.
+ */
+DotWriter::~DotWriter() {
+  try {
+    drain();
+  } catch (...) {
+  }
+}
+
+/**
+ * Empties the buffer into the destination.
+ */
+void DotWriter::drain() {
+  if (used == 0) return;
+  if (stream != nullptr) {
+    stream->write(buffer.get(), static_cast<std::streamsize>(used));
+    if (!*stream) throw std::runtime_error("Could not write DOT output");
+  } else {
+    const char *data = buffer.get();
+    std::size_t left = used;
+    while (left > 0) {
+      ssize_t written = ::write(fd, data, left);
+      if (written < 0) {
+        if (errno == EINTR) continue;
+        throw std::runtime_error(std::string("Could not write DOT output: ") +
+                                 std::strerror(errno));
+      }
+      data += written;
+      left -= static_cast<std::size_t>(written);
+    }
+  }
+  used = 0;
+}
+
+/**
+ * Writes out everything buffered so far and flushes the stream.
+ */
+void DotWriter::flush() {
+  drain();
+  if (stream != nullptr && !stream->flush()) {
+    throw std::runtime_error("Could not write DOT output");
+  }
+}
+
+DotWriter &DotWriter::operator<<(std::string_view text) {
+  if (text.size() > BUFFER_SIZE - used) {
+    drain();
+    if (text.size() > BUFFER_SIZE) {
+      // Too big to buffer: pass it through in buffer-sized pieces
+      for (std::size_t i = 0; i < text.size(); i += BUFFER_SIZE) {
+        *this << text.substr(i, BUFFER_SIZE);
+      }
+      return *this;
+    }
+  }
+  std::memcpy(buffer.get() + used, text.data(), text.size());
+  used += text.size();
+  return *this;
+}
+
+/**
+ * Decides whether the sampling options keep an edge, using a SplitMix64
+ * hash of the edge index so the choice needs no state.
+ *
+ * @param options Sampling options.
+ * @param edge Position of the edge in the graph's edge array.
+ * @return bool True if the edge should be written.
+ */
+bool DotWriter::keepEdge(const DotOptions &options, std::size_t edge) {
+  if (options.sampleRate >= 1.0) return true;
+  if (options.sampleRate <= 0.0) return false;
+  std::uint64_t x = edge + options.seed * 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return static_cast<double>(x >> 11) * 0x1.0p-53 < options.sampleRate;
+}
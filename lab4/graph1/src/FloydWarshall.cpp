@@ -0,0 +1,218 @@
+#include "../include/FloydWarshall.hpp"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FLOYD_WARSHALL_AVX2 1
+#endif
+
+namespace {
+
+constexpr std::size_t TILE = FLOYD_WARSHALL_TILE;
+
+/**
+ * Floyd-Warshall restricted to one tile, with the pivots k of the tile's
+ * block as the outer loop: c[i][j] = min(c[i][j], a[i][k] + b[k][j]). c may
+ * be the same tile as a or b, which is how the pivot tile and its row and
+ * column are closed.
+ */
+template <typename T>
+void closeTile(T *c, const T *a, const T *b, std::size_t stride) {
+  const T INF = floydWarshallInfinity<T>();
+  for (std::size_t k = 0; k < TILE; ++k) {
+    const T *bk = b + k * stride;
+    for (std::size_t i = 0; i < TILE; ++i) {
+      T aik = a[i * stride + k];
+      if (aik == INF) continue;
+      T *ci = c + i * stride;
+      for (std::size_t j = 0; j < TILE; ++j) {
+        ci[j] = std::min(ci[j], aik + bk[j]);
+      }
+    }
+  }
+}
+
+/**
+ * Min-plus product c = min(c, a * b) of three distinct tiles, one row of c
+ * at a time so that it stays in cache while the k loop runs.
+ */
+template <typename T>
+void multiplyTile(T *c, const T *a, const T *b, std::size_t stride) {
+  const T INF = floydWarshallInfinity<T>();
+  for (std::size_t i = 0; i < TILE; ++i) {
+    T *ci = c + i * stride;
+    for (std::size_t k = 0; k < TILE; ++k) {
+      T aik = a[i * stride + k];
+      if (aik == INF) continue;
+      const T *bk = b + k * stride;
+      for (std::size_t j = 0; j < TILE; ++j) {
+        ci[j] = std::min(ci[j], aik + bk[j]);
+      }
+    }
+  }
+}
+
+#ifdef FLOYD_WARSHALL_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+// One AVX2 vector of T with the operations the kernels need
+template <typename T>
+struct Avx2;
+
+template <>
+struct Avx2<int> {
+  using Vector = __m256i;
+  static constexpr std::size_t LANES = 8;
+  static Vector load(const int *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+  static void store(int *p, Vector v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+  }
+  static Vector broadcast(int x) { return _mm256_set1_epi32(x); }
+  static Vector minPlus(Vector c, Vector a, Vector b) {
+    return _mm256_min_epi32(c, _mm256_add_epi32(a, b));
+  }
+};
+
+template <>
+struct Avx2<float> {
+  using Vector = __m256;
+  static constexpr std::size_t LANES = 8;
+  static Vector load(const float *p) { return _mm256_loadu_ps(p); }
+  static void store(float *p, Vector v) { _mm256_storeu_ps(p, v); }
+  static Vector broadcast(float x) { return _mm256_set1_ps(x); }
+  static Vector minPlus(Vector c, Vector a, Vector b) {
+    return _mm256_min_ps(c, _mm256_add_ps(a, b));
+  }
+};
+
+template <>
+struct Avx2<double> {
+  using Vector = __m256d;
+  static constexpr std::size_t LANES = 4;
+  static Vector load(const double *p) { return _mm256_loadu_pd(p); }
+  static void store(double *p, Vector v) { _mm256_storeu_pd(p, v); }
+  static Vector broadcast(double x) { return _mm256_set1_pd(x); }
+  static Vector minPlus(Vector c, Vector a, Vector b) {
+    return _mm256_min_pd(c, _mm256_add_pd(a, b));
+  }
+};
+
+/**
+ * closeTile with every tile row handled as whole vectors.
+ */
+template <typename T>
+void closeTileAvx2(T *c, const T *a, const T *b, std::size_t stride) {
+  using V = Avx2<T>;
+  const T INF = floydWarshallInfinity<T>();
+  for (std::size_t k = 0; k < TILE; ++k) {
+    const T *bk = b + k * stride;
+    for (std::size_t i = 0; i < TILE; ++i) {
+      T aik = a[i * stride + k];
+      if (aik == INF) continue;
+      auto x = V::broadcast(aik);
+      T *ci = c + i * stride;
+      for (std::size_t j = 0; j < TILE; j += V::LANES) {
+        V::store(ci + j, V::minPlus(V::load(ci + j), x, V::load(bk + j)));
+      }
+    }
+  }
+}
+
+/**
+ * multiplyTile with a strip of eight vectors of the c row held in
+ * registers for the whole k loop, so each step only loads the b row.
+ */
+template <typename T>
+void multiplyTileAvx2(T *c, const T *a, const T *b, std::size_t stride) {
+  using V = Avx2<T>;
+  constexpr std::size_t STRIP = 8;
+  constexpr std::size_t WIDTH = STRIP * V::LANES;
+  const T INF = floydWarshallInfinity<T>();
+  for (std::size_t i = 0; i < TILE; ++i) {
+    T *ci = c + i * stride;
+    const T *ai = a + i * stride;
+    for (std::size_t j = 0; j < TILE; j += WIDTH) {
+      typename V::Vector strip[STRIP];
+#pragma GCC unroll 8
+      for (std::size_t s = 0; s < STRIP; ++s) {
+        strip[s] = V::load(ci + j + s * V::LANES);
+      }
+      for (std::size_t k = 0; k < TILE; ++k) {
+        if (ai[k] == INF) continue;
+        auto x = V::broadcast(ai[k]);
+        const T *bk = b + k * stride + j;
+#pragma GCC unroll 8
+        for (std::size_t s = 0; s < STRIP; ++s) {
+          strip[s] = V::minPlus(strip[s], x, V::load(bk + s * V::LANES));
+        }
+      }
+#pragma GCC unroll 8
+      for (std::size_t s = 0; s < STRIP; ++s) {
+        V::store(ci + j + s * V::LANES, strip[s]);
+      }
+    }
+  }
+}
+
+#pragma GCC pop_options
+#endif /* FLOYD_WARSHALL_AVX2 */
+
+}  // namespace
+
+/**
+ * Runs Floyd-Warshall in place.
+ *
+ * @param matrix Row-major side x side matrix: the edge weights on input,
+ * zero on the diagonal; the distances on return.
+ * @param side Number of rows, a multiple of FLOYD_WARSHALL_TILE.
+ * @param pool Threads to run the tiles on.
+ */
+template <typename T>
+void floydWarshall(T *matrix, std::size_t side, ThreadPool &pool) {
+  const std::size_t stride = side;
+  using Kernel = void (*)(T *, const T *, const T *, std::size_t);
+  Kernel close = closeTile<T>;
+  Kernel multiply = multiplyTile<T>;
+#ifdef FLOYD_WARSHALL_AVX2
+  if (__builtin_cpu_supports("avx2")) {
+    close = closeTileAvx2<T>;
+    multiply = multiplyTileAvx2<T>;
+  }
+#endif
+
+  std::size_t tiles = side / TILE;
+  auto tile = [&](std::size_t row, std::size_t column) {
+    return matrix + (row * stride + column) * TILE;
+  };
+  for (std::size_t k = 0; k < tiles; ++k) {
+    T *pivot = tile(k, k);
+    close(pivot, pivot, pivot, stride);
+
+    pool.parallelFor(0, tiles, 1, [&](std::size_t lo, std::size_t hi,
+                                      unsigned) {
+      for (std::size_t t = lo; t < hi; ++t) {
+        if (t == k) continue;
+        close(tile(k, t), pivot, tile(k, t), stride);
+        close(tile(t, k), tile(t, k), pivot, stride);
+      }
+    });
+
+    pool.parallelFor(0, tiles * tiles, 1, [&](std::size_t lo, std::size_t hi,
+                                              unsigned) {
+      for (std::size_t t = lo; t < hi; ++t) {
+        std::size_t row = t / tiles, column = t % tiles;
+        if (row == k || column == k) continue;
+        multiply(tile(row, column), tile(row, k), tile(k, column), stride);
+      }
+    });
+  }
+}
+
+// Explicit template instantiation
+template void floydWarshall<int>(int *, std::size_t, ThreadPool &);
+template void floydWarshall<float>(float *, std::size_t, ThreadPool &);
+template void floydWarshall<double>(double *, std::size_t, ThreadPool &);
@@ -1,22 +1,57 @@
 #include "Graph.hpp"
 
-// Try multiple possible paths for json.hpp
-#if __has_include(<nlohmann/json.hpp>)
-#include <nlohmann/json.hpp>
-#elif __has_include("../../deps/nlohmann/json.hpp")
-#include "../../deps/nlohmann/json.hpp"
-#endif
-
 /**
- * The Graph constructor reads a graph from a file.
+ * The Graph constructor reads a graph from a file, either JSON or a binary
+ * snapshot written by save().
  *
  * @param filename The filename parameter is a string that
  * represents the name of the file from which the graph
  * data will be read.
  */
 template <typename T>
-Graph<T>::Graph(const std::string &filename) {
-  readGraphFromJson(filename);
+Graph<T>::Graph(const std::string &filename)
+    : numVertices(0), finalized(false) {
+  readGraphFromFile(filename);
+}
+
+/**
+ * The Graph constructor creates an empty graph with a fixed number of
+ * vertices, to be filled with addEdge and then finalized.
+ *
+ * @param vertices The number of vertices in the graph.
+ */
+template <typename T>
+Graph<T>::Graph(int vertices) : numVertices(vertices), finalized(false) {}
+
+template <typename T>
+Graph<T>::Graph() : numVertices(0), finalized(false) {}
+
+template <typename T>
+Graph<T>::Graph(const Graph &other) : numVertices(0), finalized(false) {
+  *this = other;
+}
+
+/**
+ * Copies the graph. A graph built in memory gets its own arrays and rebinds
+ * its views to them; a snapshot-backed graph shares the read-only mapping.
+ */
+template <typename T>
+Graph<T> &Graph<T>::operator=(const Graph &other) {
+  if (this == &other) return *this;
+  pendingEdges = other.pendingEdges;
+  offsetStorage = other.offsetStorage;
+  targetStorage = other.targetStorage;
+  weightStorage = other.weightStorage;
+  snapshot = other.snapshot;
+  negativeWeights = std::atomic_load(&other.negativeWeights);
+  reverseEdges = std::atomic_load(&other.reverseEdges);
+  numVertices = other.numVertices;
+  finalized = other.finalized;
+  offsets = other.offsets;
+  targets = other.targets;
+  weights = other.weights;
+  if (!snapshot) bindStorage();
+  return *this;
 }
 
 /**
@@ -33,7 +68,202 @@ Graph<T>::Graph(const std::string &filename) {
  */
 template <typename T>
 void Graph<T>::addEdge(int from, int to, T weight) {
-  adjList[from].push_back({to, weight});
+  if (finalized) {
+    throw std::logic_error("Cannot add edges to a finalized graph");
+  }
+  if (from < 0 || from >= numVertices || to < 0 || to >= numVertices) {
+    throw std::out_of_range("Edge endpoint out of range");
+  }
+  pendingEdges.push_back({from, to, weight});
+}
+
+/**
+ * The function freezes the graph into compressed sparse row form. Edges are
+ * bucketed by source with a counting sort, so every vertex keeps its edges
+ * in insertion order, and the builder buffer is released afterwards.
+ * Calling it again is a no-op.
+ */
+template <typename T>
+void Graph<T>::finalize() {
+  if (finalized) return;
+
+  offsetStorage.assign(numVertices + 1, 0);
+  for (const auto &edge : pendingEdges) {
+    ++offsetStorage[edge.from + 1];
+  }
+  for (int v = 0; v < numVertices; ++v) {
+    offsetStorage[v + 1] += offsetStorage[v];
+  }
+
+  targetStorage.resize(pendingEdges.size());
+  weightStorage.resize(pendingEdges.size());
+  std::vector<std::size_t> next(offsetStorage.begin(), offsetStorage.end() - 1);
+  for (const auto &edge : pendingEdges) {
+    std::size_t slot = next[edge.from]++;
+    targetStorage[slot] = edge.to;
+    weightStorage[slot] = edge.weight;
+  }
+
+  std::vector<Edge>().swap(pendingEdges);
+  bindStorage();
+  finalized = true;
+}
+
+/**
+ * Points the CSR views at the storage vectors owned by this graph.
+ */
+template <typename T>
+void Graph<T>::bindStorage() {
+  offsets = ArrayView<std::size_t>(offsetStorage.data(), offsetStorage.size());
+  targets = ArrayView<int>(targetStorage.data(), targetStorage.size());
+  weights = ArrayView<T>(weightStorage.data(), weightStorage.size());
+}
+
+/**
+ * Writes the finalized graph as a binary snapshot (see GraphSnapshot.hpp),
+ * which load() and the filename constructor can map back without parsing.
+ *
+ * @param filename Path of the snapshot file to create or overwrite.
+ */
+template <typename T>
+void Graph<T>::save(const std::string &filename) const {
+  static_assert(sizeof(std::size_t) == sizeof(std::uint64_t),
+                "Snapshot offsets are stored as 64-bit integers");
+  requireFinalized();
+  GraphSnapshot::write(
+      filename, {GraphSnapshot::weightTypeOf<T>(),
+                 static_cast<std::uint64_t>(numVertices), targets.size(),
+                 offsets.data(), targets.data(), weights.data(), sizeof(T)});
+}
+
+/**
+ * Opens a binary snapshot written by save(). The file is memory-mapped and
+ * the graph answers queries straight from the mapped pages, without copying
+ * them; loading only reads the offsets and targets once to check them.
+ *
+ * @param filename Path of the snapshot file.
+ * @param verifyChecksum Whether to hash the whole file before using it.
+ * @return Graph The finalized, read-only graph.
+ */
+template <typename T>
+Graph<T> Graph<T>::load(const std::string &filename, bool verifyChecksum) {
+  Graph graph;
+  graph.readGraphFromSnapshot(filename, verifyChecksum);
+  return graph;
+}
+
+/**
+ * The function reads a graph from a file, picking the format from its first
+ * bytes: binary snapshots are mapped, anything else is parsed as JSON.
+ *
+ * @param filename The filename parameter is a string that represents the name
+ * of the file from which the graph data will be read.
+ */
+template <typename T>
+void Graph<T>::readGraphFromFile(const std::string &filename) {
+  if (GraphSnapshot::isSnapshot(filename)) {
+    readGraphFromSnapshot(filename, false);
+  } else {
+    readGraphFromJson(filename);
+  }
+}
+
+/**
+ * Maps a snapshot and binds the CSR views to the arrays inside it.
+ *
+ * @param filename Path of the snapshot file.
+ * @param verifyChecksum Whether to hash the whole file before using it.
+ */
+template <typename T>
+void Graph<T>::readGraphFromSnapshot(const std::string &filename,
+                                     bool verifyChecksum) {
+  auto file = std::make_shared<const MappedFile>(filename, false);
+  const GraphSnapshot::Header &header = GraphSnapshot::validate(
+      *file, GraphSnapshot::weightTypeOf<T>(), verifyChecksum);
+  const char *base = file->data();
+
+  numVertices = static_cast<int>(header.numVertices);
+  offsets = ArrayView<std::size_t>(
+      reinterpret_cast<const std::size_t *>(base + header.offsetsStart),
+      header.numVertices + 1);
+  targets = ArrayView<int>(
+      reinterpret_cast<const int *>(base + header.targetsStart),
+      header.numEdges);
+  weights = ArrayView<T>(reinterpret_cast<const T *>(base + header.weightsStart),
+                         header.numEdges);
+
+  std::vector<Edge>().swap(pendingEdges);
+  offsetStorage.clear();
+  targetStorage.clear();
+  weightStorage.clear();
+  snapshot = std::move(file);
+  negativeWeights.reset();
+  reverseEdges.reset();
+  finalized = true;
+}
+
+/**
+ * Throws if the graph is still in its builder phase; every query runs on
+ * the CSR arrays.
+ */
+template <typename T>
+void Graph<T>::requireFinalized() const {
+  if (!finalized) {
+    throw std::logic_error("Graph must be finalized before it is queried");
+  }
+}
+
+/**
+ * Tells whether any edge weight is negative. The weights never change once
+ * the graph is finalized, so the scan runs on the first call only.
+ */
+template <typename T>
+bool Graph<T>::hasNegativeWeights() const {
+  std::shared_ptr<const bool> flag = std::atomic_load(&negativeWeights);
+  if (!flag) {
+    bool negative = std::any_of(weights.begin(), weights.end(),
+                                [](T weight) { return weight < 0; });
+    flag = std::make_shared<const bool>(negative);
+    std::atomic_store(&negativeWeights, flag);
+  }
+  return *flag;
+}
+
+/**
+ * Returns the incoming edges of every vertex, building them with a counting
+ * sort on the first call.
+ */
+template <typename T>
+const typename Graph<T>::ReverseEdges &Graph<T>::reverse() const {
+  std::shared_ptr<const ReverseEdges> cached = std::atomic_load(&reverseEdges);
+  if (!cached) {
+    auto built = std::make_shared<ReverseEdges>();
+    built->offsets.assign(numVertices + 1, 0);
+    for (int v : targets) ++built->offsets[v + 1];
+    for (int v = 0; v < numVertices; ++v) {
+      built->offsets[v + 1] += built->offsets[v];
+    }
+    built->sources.resize(targets.size());
+    built->weights.resize(targets.size());
+    std::vector<std::size_t> next(built->offsets.begin(),
+                                  built->offsets.end() - 1);
+    for (int u = 0; u < numVertices; ++u) {
+      for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+        std::size_t slot = next[targets[e]]++;
+        built->sources[slot] = u;
+        built->weights[slot] = weights[e];
+      }
+    }
+    // Another thread may have built them meanwhile; the first one stays
+    std::shared_ptr<const ReverseEdges> expected;
+    if (!std::atomic_compare_exchange_strong(
+            &reverseEdges, &expected,
+            std::shared_ptr<const ReverseEdges>(std::move(built)))) {
+      return *expected;
+    }
+    cached = std::atomic_load(&reverseEdges);
+  }
+  return *cached;
 }
 
 /**
@@ -44,13 +274,15 @@ void Graph<T>::addEdge(int from, int to, T weight) {
  */
 template <typename T>
 std::ostream &operator<<(std::ostream &os, const Graph<T> &graph) {
+  graph.requireFinalized();
   os << "Graph Representation (Adjacency List):\n";
   for (int i = 0; i < graph.numVertices; ++i) {
     os << "Vertex " << i << " connects to: ";
-    for (const auto &edge : graph.adjList[i]) {
-      os << "[Vertex " << edge.to << " with weight " << edge.weight << "] ";
+    for (std::size_t e = graph.offsets[i]; e < graph.offsets[i + 1]; ++e) {
+      os << "[Vertex " << graph.targets[e] << " with weight "
+         << graph.weights[e] << "] ";
     }
-    if (graph.adjList[i].empty()) {
+    if (graph.offsets[i] == graph.offsets[i + 1]) {
       os << "No connections";
     }
     os << "\n";
@@ -60,63 +292,1444 @@ std::ostream &operator<<(std::ostream &os, const Graph<T> &graph) {
 
 /**
  * The function reads a graph from a file and populates the adjacency list with
- * the graph data.
+ * the graph data. The file is memory-mapped and parsed in a single streaming
+ * pass; edges are written straight into the pre-reserved builder buffer, so
+ * no JSON document tree is ever materialised.
  *
  * @param filename The filename parameter is a string that represents the name
  * of the file from which the graph data will be read.
  */
 template <typename T>
 void Graph<T>::readGraphFromJson(const std::string &filename) {
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    throw std::runtime_error("Could not open file: " + filename);
-  }
+  MappedFile file(filename);
+  GraphJsonReader reader(file.data(), file.size());
+  pendingEdges.reserve(reader.estimateEdges());
 
-  nlohmann::json json;
-  file >> json;
+  // "vertices" may come after "edges", so endpoints are checked at the end
+  reader.parse([&](int vertices) { numVertices = vertices; },
+               [&](const GraphJsonReader::EdgeRecord &edge) {
+                 pendingEdges.push_back(
+                     {edge.from, edge.to, static_cast<T>(edge.weight)});
+               });
 
-  numVertices = json["vertices"];
-  adjList.resize(numVertices);
-
-  for (const auto &edge : json["edges"]) {
-    int from = edge["from"];
-    int to = edge["to"];
-    T weight = edge["weight"];
-    addEdge(from, to, weight);
+  for (const auto &edge : pendingEdges) {
+    if (edge.from < 0 || edge.from >= numVertices || edge.to < 0 ||
+        edge.to >= numVertices) {
+      throw std::out_of_range("Edge endpoint out of range in " + filename);
+    }
   }
+  finalize();
+}
+
+/**
+ * Writes the graph in Graphviz DOT format to a stream. The text goes out
+ * through a fixed-size buffer, so memory use does not grow with the graph.
+ *
+ * @param os Stream that receives the DOT text.
+ * @param options Edge sampling, edge cap and clusters.
+ */
+template <typename T>
+void Graph<T>::toDot(std::ostream &os, const DotOptions &options) const {
+  DotWriter dot(os);
+  writeDot(dot, options);
 }
 
 /**
- * The function converts a graph into a DOT format string representation.
+ * Writes the graph in Graphviz DOT format to a file descriptor, bypassing
+ * iostreams entirely.
  *
- * @return a string representation of a graph in the DOT language.
+ * @param fd Descriptor opened for writing; it is not closed.
+ * @param options Edge sampling, edge cap and clusters.
+ */
+template <typename T>
+void Graph<T>::toDot(int fd, const DotOptions &options) const {
+  DotWriter dot(fd);
+  writeDot(dot, options);
+}
+
+/**
+ * Emits the cluster blocks, if any, followed by the sampled and capped
+ * edges in CSR order.
  */
 template <typename T>
-std::string Graph<T>::toDot() const {
-  std::ostringstream dot;
+void Graph<T>::writeDot(DotWriter &dot, const DotOptions &options) const {
+  requireFinalized();
+  const std::vector<int> *clusters = options.clusters;
+  if (clusters != nullptr &&
+      clusters->size() != static_cast<std::size_t>(numVertices)) {
+    throw std::invalid_argument("DOT clusters need one entry per vertex");
+  }
+
   dot << "digraph G {\n";  // Use "digraph" for directed graphs
-  for (int i = 0; i < numVertices; ++i) {
-    for (const auto &edge : adjList[i]) {
-      dot << "  " << i << " -> " << edge.to << " [label=" << edge.weight
+
+  if (clusters != nullptr) {
+    // Group the clustered vertices; this index is the only per-vertex
+    // memory the export needs
+    std::vector<int> members;
+    for (int v = 0; v < numVertices; ++v) {
+      if ((*clusters)[v] >= 0) members.push_back(v);
+    }
+    std::stable_sort(members.begin(), members.end(), [&](int a, int b) {
+      return (*clusters)[a] < (*clusters)[b];
+    });
+    for (std::size_t i = 0; i < members.size(); ++i) {
+      int id = (*clusters)[members[i]];
+      if (i == 0 || (*clusters)[members[i - 1]] != id) {
+        dot << "  subgraph cluster_" << id << " {\n    label=\"" << id
+            << "\";\n";
+      }
+      dot << "    " << members[i] << ";\n";
+      if (i + 1 == members.size() || (*clusters)[members[i + 1]] != id) {
+        dot << "  }\n";
+      }
+    }
+  }
+
+  std::size_t limit = options.maxEdges == 0
+                          ? std::numeric_limits<std::size_t>::max()
+                          : options.maxEdges;
+  std::size_t written = 0;
+  for (int i = 0; i < numVertices && written < limit; ++i) {
+    for (std::size_t e = offsets[i]; e < offsets[i + 1] && written < limit;
+         ++e) {
+      if (!DotWriter::keepEdge(options, e)) continue;
+      dot << "  " << i << " -> " << targets[e] << " [label=" << weights[e]
           << "];\n";
+      ++written;
     }
   }
   dot << "}\n";
-  return dot.str();
+  dot.flush();
 }
 
+/**
+ * Looks for a cycle in the shortest path tree given by the parent pointers.
+ * Any such cycle was closed by a strictly improving relaxation, so it is a
+ * negative weight cycle of the graph.
+ *
+ * @param parent Parent of every vertex in the shortest path tree, -1 if none.
+ * @param cycle Output vector receiving the cycle in edge order, so that
+ * cycle[i] -> cycle[i + 1] and cycle.back() -> cycle.front() are edges.
+ * @return bool True if a cycle was found, false otherwise.
+ */
+template <typename T>
+bool Graph<T>::findParentCycle(const std::vector<int> &parent,
+                               std::vector<int> &cycle) const {
+  // 0 = unvisited, otherwise the id of the walk that first reached the vertex
+  std::vector<int> walk(numVertices, 0);
+  for (int start = 0; start < numVertices; ++start) {
+    int v = start;
+    while (v != -1 && walk[v] == 0) {
+      walk[v] = start + 1;
+      v = parent[v];
+    }
+    if (v == -1 || walk[v] != start + 1) continue;
+
+    // v lies on a cycle that this walk closed; collect it backwards
+    cycle.clear();
+    int u = v;
+    do {
+      cycle.push_back(u);
+      u = parent[u];
+    } while (u != v);
+    std::reverse(cycle.begin(), cycle.end());
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Bellman-Ford with whole-graph relaxation passes. The search stops as soon
+ * as a pass changes nothing; if passes keep improving after |V| - 1 of them
+ * the parent pointers are checked after every further pass until the
+ * negative cycle shows up in them.
+ *
+ * @return bool False if a negative cycle is reachable from the source.
+ */
+template <typename T>
+bool Graph<T>::bellmanFordRounds(int src, std::vector<T> &distances,
+                                 std::vector<int> &parent,
+                                 std::vector<int> &negativeCycle) const {
+  const T INF = std::numeric_limits<T>::max();
+  distances[src] = 0;
+
+  for (int round = 1;; ++round) {
+    bool changed = false;
+    for (int u = 0; u < numVertices; ++u) {
+      if (distances[u] == INF) continue;
+      for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+        int v = targets[e];
+        T candidate = distances[u] + weights[e];
+        if (candidate < distances[v]) {
+          distances[v] = candidate;
+          parent[v] = u;
+          changed = true;
+        }
+      }
+    }
+    if (!changed) return true;
+    if (round >= numVertices && findParentCycle(parent, negativeCycle)) {
+      return false;
+    }
+  }
+}
+
+/**
+ * Queue based Bellman-Ford (SPFA). Only vertices whose distance improved are
+ * rescanned. A vertex entering the queue goes to the front if it beats the
+ * current front (small-label-first), and vertices above the average queued
+ * label are rotated to the back before being scanned (large-label-last).
+ * Every |V| relaxations the parent pointers are checked for a cycle, which
+ * keeps negative cycle detection amortized O(1) per relaxation.
+ *
+ * @param src The source vertex, or -1 for a virtual source with a zero
+ * weight edge to every vertex, which all start at distance 0 then.
+ * @return bool False if a negative cycle is reachable from the source.
+ */
+template <typename T>
+bool Graph<T>::bellmanFordSpfa(int src, std::vector<T> &distances,
+                               std::vector<int> &parent,
+                               std::vector<int> &negativeCycle) const {
+  std::deque<int> queue;
+  std::vector<char> inQueue(numVertices, 0);
+  double queuedSum = 0;  // sum of labels in the queue, for large-label-last
+  long long relaxations = 0;
+
+  if (src == -1) {
+    for (int v = 0; v < numVertices; ++v) {
+      distances[v] = 0;
+      queue.push_back(v);
+      inQueue[v] = 1;
+    }
+  } else {
+    distances[src] = 0;
+    queue.push_back(src);
+    inQueue[src] = 1;
+  }
+
+  while (!queue.empty()) {
+    double average = queuedSum / static_cast<double>(queue.size());
+    for (size_t rotations = queue.size();
+         rotations > 1 && distances[queue.front()] > average; --rotations) {
+      queue.push_back(queue.front());
+      queue.pop_front();
+    }
+
+    int u = queue.front();
+    queue.pop_front();
+    inQueue[u] = 0;
+    queuedSum -= static_cast<double>(distances[u]);
+
+    for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+      int v = targets[e];
+      T candidate = distances[u] + weights[e];
+      if (!(candidate < distances[v])) continue;
+
+      if (inQueue[v]) {
+        queuedSum += static_cast<double>(candidate) -
+                     static_cast<double>(distances[v]);
+      }
+      distances[v] = candidate;
+      parent[v] = u;
+
+      if (++relaxations % numVertices == 0 &&
+          findParentCycle(parent, negativeCycle)) {
+        return false;
+      }
+
+      if (!inQueue[v]) {
+        if (!queue.empty() && candidate < distances[queue.front()]) {
+          queue.push_front(v);
+        } else {
+          queue.push_back(v);
+        }
+        inQueue[v] = 1;
+        queuedSum += static_cast<double>(candidate);
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Computes single-source shortest path distances with the Bellman-Ford
+ * algorithm, reporting whether a negative cycle is reachable from the source.
+ *
+ * @param src The source vertex.
+ * @param distances Vector to store shortest path distances.
+ * @return bool False if a negative cycle exists, true otherwise.
+ */
 template <typename T>
 bool Graph<T>::bellmanFord(int src, std::vector<T> &distances) {
-  // TODO: Implement this
+  std::vector<int> negativeCycle;
+  return bellmanFord(src, distances, negativeCycle);
+}
+
+/**
+ * Computes single-source shortest path distances with the Bellman-Ford
+ * algorithm and extracts a witness when a negative cycle is reachable.
+ *
+ * @param src The source vertex.
+ * @param distances Vector to store shortest path distances. Unreachable
+ * vertices keep std::numeric_limits<T>::max(); the contents are meaningless
+ * when a negative cycle is found.
+ * @param negativeCycle Receives the vertices of a negative cycle in edge
+ * order, or is cleared if there is none.
+ * @param mode Whether to use full relaxation passes or the SPFA work queue.
+ * @return bool False if a negative cycle exists or the source is out of
+ * range, true otherwise.
+ */
+template <typename T>
+bool Graph<T>::bellmanFord(int src, std::vector<T> &distances,
+                           std::vector<int> &negativeCycle,
+                           BellmanFordMode mode) {
+  requireFinalized();
+  negativeCycle.clear();
+  if (src < 0 || src >= numVertices) return false;
+
+  distances.assign(numVertices, std::numeric_limits<T>::max());
+  std::vector<int> parent(numVertices, -1);
+
+  if (mode == BellmanFordMode::Rounds) {
+    return bellmanFordRounds(src, distances, parent, negativeCycle);
+  }
+  return bellmanFordSpfa(src, distances, parent, negativeCycle);
+}
+
+/**
+ * Runs Dijkstra's algorithm from a single source using the given priority
+ * queue. Vertices are settled in order of increasing distance; a vertex is
+ * pushed the first time it is reached and its key is decreased in place on
+ * every later improvement.
+ *
+ * @tparam Heap An indexed min-heap from Heap.hpp.
+ * @param src The source vertex.
+ * @param distances Output vector, pre-filled with infinity.
+ * @param edgeOffsets CSR offsets of the edges to follow, either the graph's
+ * own or those of reverse().
+ * @param edgeTargets CSR edge heads.
+ * @param edgeWeights CSR edge weights.
+ */
+template <typename T>
+template <typename Heap>
+void Graph<T>::dijkstraWithHeap(int src, std::vector<T> &distances,
+                                const std::size_t *edgeOffsets,
+                                const int *edgeTargets,
+                                const T *edgeWeights) const {
+  const T INF = std::numeric_limits<T>::max();
+  std::vector<char> settled(numVertices, 0);
+  Heap heap(numVertices);
+
+  distances[src] = 0;
+  heap.push(src, 0);
+
+  while (!heap.empty()) {
+    auto [u, distU] = heap.pop();
+    settled[u] = 1;
+
+    for (std::size_t e = edgeOffsets[u]; e < edgeOffsets[u + 1]; ++e) {
+      int v = edgeTargets[e];
+      if (settled[v]) continue;
+
+      T candidate = distU + edgeWeights[e];
+      if (candidate < distances[v]) {
+        if (distances[v] == INF) {
+          heap.push(v, candidate);
+        } else {
+          heap.decreaseKey(v, candidate);
+        }
+        distances[v] = candidate;
+      }
+    }
+  }
+}
+
+/**
+ * Computes single-source shortest path distances with Dijkstra's algorithm.
+ * Unreachable vertices keep the value std::numeric_limits<T>::max().
+ *
+ * @param src The source vertex.
+ * @param distances Vector to store shortest path distances.
+ * @param heapType The priority queue backing the search. The radix heap is
+ * monotone and relies on all weights being non-negative.
+ * @return bool True if successful, false if the source is out of range or the
+ * graph has a negative edge weight.
+ */
+template <typename T>
+bool Graph<T>::dijkstra(int src, std::vector<T> &distances,
+                        HeapType heapType) {
+  requireFinalized();
+  if (src < 0 || src >= numVertices) return false;
+  if (hasNegativeWeights()) return false;
+
+  distances.assign(numVertices, std::numeric_limits<T>::max());
+
+  switch (heapType) {
+    case HeapType::Binary:
+      dijkstraWithHeap<BinaryHeap<T>>(src, distances, offsets.data(),
+                                      targets.data(), weights.data());
+      break;
+    case HeapType::FourAry:
+      dijkstraWithHeap<FourAryHeap<T>>(src, distances, offsets.data(),
+                                       targets.data(), weights.data());
+      break;
+    case HeapType::Pairing:
+      dijkstraWithHeap<PairingHeap<T>>(src, distances, offsets.data(),
+                                       targets.data(), weights.data());
+      break;
+    case HeapType::Radix:
+      dijkstraWithHeap<RadixHeap<T>>(src, distances, offsets.data(),
+                                     targets.data(), weights.data());
+      break;
+  }
+  return true;
+}
+
+/**
+ * Bucket width used when deltaStepping is not given one: the mean edge
+ * weight, so a typical edge is light and most buckets hold one hop of the
+ * search frontier.
+ */
+template <typename T>
+T Graph<T>::defaultDelta() const {
+  double total = 0;
+  for (T weight : weights) total += static_cast<double>(weight);
+  double mean = weights.empty() ? 1.0 : total / weights.size();
+  if constexpr (std::is_integral_v<T>) {
+    return std::max<T>(1, static_cast<T>(mean));
+  } else {
+    return mean > 0 ? static_cast<T>(mean) : T(1);
+  }
+}
+
+/**
+ * Computes single-source shortest path distances with parallel
+ * delta-stepping. Tentative distances are sorted into buckets of width
+ * delta. The lowest bucket is emptied in rounds that relax the light edges
+ * (weight <= delta) of all its vertices in parallel, since these can put
+ * vertices back into the same bucket; the heavy edges of every vertex that
+ * left the bucket are relaxed once afterwards. Relaxations lower distances
+ * with an atomic compare-and-swap minimum, and each thread files the
+ * vertices it improved in its own buckets, so no locks are taken.
+ *
+ * The distances equal those of dijkstra() exactly: both compute, for every
+ * vertex, the smallest d(u) + w over its incoming edges.
+ *
+ * @param src The source vertex.
+ * @param distances Vector to store shortest path distances.
+ * @param delta Bucket width; zero or less picks the mean edge weight. Small
+ * values do less redundant work, large values expose more parallelism.
+ * @param pool Threads to run on.
+ * @return bool True if successful, false if the source is out of range or the
+ * graph has a negative edge weight.
+ */
+template <typename T>
+bool Graph<T>::deltaStepping(int src, std::vector<T> &distances, T delta,
+                             ThreadPool &pool) const {
+  requireFinalized();
+  if (src < 0 || src >= numVertices) return false;
+  if (hasNegativeWeights()) return false;
+  if (!(delta > 0)) delta = defaultDelta();
+
+  const T INF = std::numeric_limits<T>::max();
+  const std::size_t GRAIN = 256;
+  const std::size_t n = static_cast<std::size_t>(numVertices);
+
+  // Reorder every vertex's edges so its light edges come first
+  std::vector<std::size_t> lightEnd(n);
+  std::vector<int> splitTargets(targets.size());
+  std::vector<T> splitWeights(targets.size());
+  pool.parallelFor(0, n, 4096, [&](std::size_t lo, std::size_t hi, unsigned) {
+    for (std::size_t u = lo; u < hi; ++u) {
+      std::size_t light = offsets[u], heavy = offsets[u + 1];
+      for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+        std::size_t slot = weights[e] <= delta ? light++ : --heavy;
+        splitTargets[slot] = targets[e];
+        splitWeights[slot] = weights[e];
+      }
+      lightEnd[u] = light;
+    }
+  });
+
+  std::unique_ptr<std::atomic<T>[]> tentative(new std::atomic<T>[n]);
+  // Light round and bucket phase a vertex was last expanded in, so
+  // duplicate bucket entries are expanded once
+  std::unique_ptr<std::atomic<std::uint32_t>[]> lightRound(
+      new std::atomic<std::uint32_t>[n]);
+  std::unique_ptr<std::atomic<std::uint32_t>[]> heavyPhase(
+      new std::atomic<std::uint32_t>[n]);
+  pool.parallelFor(0, n, 4096, [&](std::size_t lo, std::size_t hi, unsigned) {
+    for (std::size_t v = lo; v < hi; ++v) {
+      tentative[v].store(INF, std::memory_order_relaxed);
+      lightRound[v].store(0, std::memory_order_relaxed);
+      heavyPhase[v].store(0, std::memory_order_relaxed);
+    }
+  });
+
+  struct alignas(64) WorkerBuckets {
+    std::vector<std::vector<int>> buckets;
+  };
+  std::vector<WorkerBuckets> local(pool.size());
+
+  auto bucketOf = [&](T distance) {
+    return static_cast<std::size_t>(distance / delta);
+  };
+  auto relax = [&](int v, T candidate, unsigned worker) {
+    T current = tentative[v].load(std::memory_order_relaxed);
+    while (candidate < current) {
+      if (tentative[v].compare_exchange_weak(current, candidate,
+                                             std::memory_order_relaxed)) {
+        auto &buckets = local[worker].buckets;
+        std::size_t b = bucketOf(candidate);
+        if (b >= buckets.size()) buckets.resize(b + 1);
+        buckets[b].push_back(v);
+        return;
+      }
+    }
+  };
+
+  tentative[src].store(0, std::memory_order_relaxed);
+  local[0].buckets.resize(1);
+  local[0].buckets[0].push_back(src);
+
+  std::vector<int> frontier;
+  std::vector<int> emptied;
+  std::uint32_t round = 0;
+  std::uint32_t phase = 0;
+  std::size_t bucket = 0;
+  while (true) {
+    // The lowest non-empty bucket over all threads
+    std::size_t next = std::numeric_limits<std::size_t>::max();
+    for (const auto &worker : local) {
+      for (std::size_t b = bucket; b < worker.buckets.size() && b < next;
+           ++b) {
+        if (!worker.buckets[b].empty()) {
+          next = b;
+          break;
+        }
+      }
+    }
+    if (next == std::numeric_limits<std::size_t>::max()) break;
+    bucket = next;
+    ++phase;
+
+    emptied.clear();
+    while (true) {
+      frontier.clear();
+      for (auto &worker : local) {
+        if (bucket >= worker.buckets.size()) continue;
+        auto &entries = worker.buckets[bucket];
+        frontier.insert(frontier.end(), entries.begin(), entries.end());
+        entries.clear();
+      }
+      if (frontier.empty()) break;
+      emptied.insert(emptied.end(), frontier.begin(), frontier.end());
+
+      ++round;
+      pool.parallelFor(
+          0, frontier.size(), GRAIN,
+          [&](std::size_t lo, std::size_t hi, unsigned worker) {
+            for (std::size_t i = lo; i < hi; ++i) {
+              int u = frontier[i];
+              if (lightRound[u].exchange(round, std::memory_order_relaxed) ==
+                  round) {
+                continue;
+              }
+              // Skip entries left behind when u moved to a lower bucket
+              T distU = tentative[u].load(std::memory_order_relaxed);
+              if (bucketOf(distU) != bucket) continue;
+              for (std::size_t e = offsets[u]; e < lightEnd[u]; ++e) {
+                relax(splitTargets[e], distU + splitWeights[e], worker);
+              }
+            }
+          });
+    }
+
+    pool.parallelFor(
+        0, emptied.size(), GRAIN,
+        [&](std::size_t lo, std::size_t hi, unsigned worker) {
+          for (std::size_t i = lo; i < hi; ++i) {
+            int u = emptied[i];
+            if (heavyPhase[u].exchange(phase, std::memory_order_relaxed) ==
+                phase) {
+              continue;
+            }
+            T distU = tentative[u].load(std::memory_order_relaxed);
+            if (bucketOf(distU) != bucket) continue;
+            for (std::size_t e = lightEnd[u]; e < offsets[u + 1]; ++e) {
+              relax(splitTargets[e], distU + splitWeights[e], worker);
+            }
+          }
+        });
+    // The next scan starts at this bucket again: rounding can file a
+    // floating point heavy relaxation in the bucket just emptied
+  }
+
+  distances.resize(n);
+  pool.parallelFor(0, n, 4096, [&](std::size_t lo, std::size_t hi, unsigned) {
+    for (std::size_t v = lo; v < hi; ++v) {
+      distances[v] = tentative[v].load(std::memory_order_relaxed);
+    }
+  });
   return true;
 }
 
+/**
+ * Answers a batch of source -> target shortest path queries. Queries are
+ * grouped by source and each group is answered by one Dijkstra search
+ * that stops as soon as all of the group's targets are settled. Groups are
+ * spread over the thread pool; every thread keeps a SearchWorkspace
+ * between calls, so a search costs time proportional to the part of the
+ * graph it explores rather than O(V).
+ *
+ * @param queries The (source, target) pairs to answer.
+ * @param distances Output vector, one distance per query in query order;
+ * std::numeric_limits<T>::max() if the target is unreachable.
+ * @return bool False if a query names a vertex outside the graph or the
+ * graph has a negative weight.
+ */
+template <typename T>
+bool Graph<T>::shortestPaths(const std::vector<PathQuery> &queries,
+                             std::vector<T> &distances) const {
+  requireFinalized();
+  for (const auto &query : queries) {
+    if (query.source < 0 || query.source >= numVertices || query.target < 0 ||
+        query.target >= numVertices) {
+      return false;
+    }
+  }
+  if (hasNegativeWeights()) return false;
+
+  distances.assign(queries.size(), std::numeric_limits<T>::max());
+  std::vector<std::size_t> order(queries.size());
+  for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t a, std::size_t b) {
+                     return queries[a].source < queries[b].source;
+                   });
+
+  std::vector<std::size_t> groupStarts;
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    if (i == 0 || queries[order[i]].source != queries[order[i - 1]].source) {
+      groupStarts.push_back(i);
+    }
+  }
+  groupStarts.push_back(order.size());
+
+  ThreadPool::shared().parallelFor(
+      0, groupStarts.size() - 1, 1,
+      [&](std::size_t lo, std::size_t hi, unsigned) {
+        for (std::size_t g = lo; g < hi; ++g) {
+          answerQueryGroup(queries, order, groupStarts[g], groupStarts[g + 1],
+                           distances);
+        }
+      });
+  return true;
+}
+
+/**
+ * Runs the early-exit Dijkstra search for queries order[first..last), which
+ * all share one source, on the calling thread's workspace.
+ */
+template <typename T>
+void Graph<T>::answerQueryGroup(const std::vector<PathQuery> &queries,
+                                const std::vector<std::size_t> &order,
+                                std::size_t first, std::size_t last,
+                                std::vector<T> &distances) const {
+  static thread_local SearchWorkspace<T> workspace;
+  workspace.begin(numVertices);
+  FourAryHeap<T> &heap = workspace.heap();
+
+  std::size_t remaining = 0;
+  for (std::size_t i = first; i < last; ++i) {
+    if (workspace.markTarget(queries[order[i]].target)) ++remaining;
+  }
+
+  int src = queries[order[first]].source;
+  workspace.setDistance(src, 0);
+  heap.push(src, 0);
+
+  while (!heap.empty()) {
+    auto [u, distU] = heap.pop();
+    workspace.settle(u);
+    if (workspace.isTarget(u) && --remaining == 0) break;
+
+    for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+      int v = targets[e];
+      if (workspace.isSettled(v)) continue;
+
+      T candidate = distU + weights[e];
+      if (!workspace.isReached(v)) {
+        heap.push(v, candidate);
+        workspace.setDistance(v, candidate);
+      } else if (candidate < workspace.distance(v)) {
+        heap.decreaseKey(v, candidate);
+        workspace.setDistance(v, candidate);
+      }
+    }
+  }
+
+  for (std::size_t i = first; i < last; ++i) {
+    int target = queries[order[i]].target;
+    if (workspace.isSettled(target)) {
+      distances[order[i]] = workspace.distance(target);
+    }
+  }
+}
+
+/**
+ * Runs A* from source to target. Vertices leave the queue in order of
+ * distance plus heuristic; a vertex reached again on a shorter path is put
+ * back in the queue, so an admissible heuristic that is not consistent
+ * still gives the exact distance.
+ *
+ * @tparam Heuristic Callable mapping a vertex to a lower bound on its
+ * distance to the target, or the maximum of T if it cannot reach it.
+ * @param source The source vertex.
+ * @param target The target vertex.
+ * @param heuristic The lower bound.
+ * @param distance Set to the distance, or the maximum of T if unreachable.
+ * @param settled If not null, set to the number of vertices taken from the
+ * queue.
+ * @return bool True if successful, false if a vertex is out of range or the
+ * graph has a negative edge weight.
+ */
+template <typename T>
+template <typename Heuristic>
+bool Graph<T>::aStarSearch(int source, int target, const Heuristic &heuristic,
+                           T &distance, std::size_t *settled) const {
+  requireFinalized();
+  if (source < 0 || source >= numVertices || target < 0 ||
+      target >= numVertices) {
+    return false;
+  }
+  if (hasNegativeWeights()) return false;
+
+  const T INF = std::numeric_limits<T>::max();
+  static thread_local SearchWorkspace<T> workspace;
+  workspace.begin(numVertices);
+  FourAryHeap<T> &heap = workspace.heap();
+
+  distance = INF;
+  std::size_t popped = 0;
+  T sourceBound = heuristic(source);
+  if (sourceBound != INF) {
+    workspace.setDistance(source, 0);
+    heap.push(source, sourceBound);
+  }
+
+  while (!heap.empty()) {
+    int u = heap.pop().first;
+    ++popped;
+    T distU = workspace.distance(u);
+    if (u == target) {
+      distance = distU;
+      break;
+    }
+
+    for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+      int v = targets[e];
+      T candidate = distU + weights[e];
+      if (workspace.isReached(v) && !(candidate < workspace.distance(v))) {
+        continue;
+      }
+      T bound = heuristic(v);
+      if (bound == INF) continue;
+
+      workspace.setDistance(v, candidate);
+      if (heap.contains(v)) {
+        heap.decreaseKey(v, candidate + bound);
+      } else {
+        heap.push(v, candidate + bound);
+      }
+    }
+  }
+
+  if (settled != nullptr) *settled = popped;
+  return true;
+}
+
+/**
+ * Computes the shortest path distance from source to target with A*.
+ *
+ * @param source The source vertex.
+ * @param target The target vertex.
+ * @param heuristic Lower bound on the distance from a vertex to the target.
+ * It must never overestimate; the maximum of T marks vertices that cannot
+ * reach the target.
+ * @param distance Set to the distance, or the maximum of T if unreachable.
+ * @param settled If not null, set to the number of vertices taken from the
+ * queue.
+ * @return bool True if successful, false if a vertex is out of range or the
+ * graph has a negative edge weight.
+ */
+template <typename T>
+bool Graph<T>::aStar(int source, int target,
+                     const std::function<T(int)> &heuristic, T &distance,
+                     std::size_t *settled) const {
+  return aStarSearch(source, target, heuristic, distance, settled);
+}
+
+/**
+ * Computes the shortest path distance from source to target with two
+ * Dijkstra searches, forward from the source and backward from the target
+ * over reverse(). The side with the smaller next key goes next, and the
+ * search ends once the two next keys add up to at least the best path
+ * found where the searches meet.
+ *
+ * @param source The source vertex.
+ * @param target The target vertex.
+ * @param distance Set to the distance, or the maximum of T if unreachable.
+ * @param settled If not null, set to the number of vertices settled by both
+ * searches together.
+ * @return bool True if successful, false if a vertex is out of range or the
+ * graph has a negative edge weight.
+ */
+template <typename T>
+bool Graph<T>::bidirectionalDijkstra(int source, int target, T &distance,
+                                     std::size_t *settled) const {
+  requireFinalized();
+  if (source < 0 || source >= numVertices || target < 0 ||
+      target >= numVertices) {
+    return false;
+  }
+  if (hasNegativeWeights()) return false;
+
+  const ReverseEdges &incoming = reverse();
+  static thread_local SearchWorkspace<T> forward;
+  static thread_local SearchWorkspace<T> backward;
+  forward.begin(numVertices);
+  backward.begin(numVertices);
+
+  T best = source == target ? 0 : std::numeric_limits<T>::max();
+  std::size_t popped = 0;
+  forward.setDistance(source, 0);
+  forward.heap().push(source, 0);
+  backward.setDistance(target, 0);
+  backward.heap().push(target, 0);
+
+  auto step = [&](SearchWorkspace<T> &own, const SearchWorkspace<T> &other,
+                  const std::size_t *edgeOffsets, const int *edgeTargets,
+                  const T *edgeWeights) {
+    auto [u, distU] = own.heap().pop();
+    own.settle(u);
+    ++popped;
+    for (std::size_t e = edgeOffsets[u]; e < edgeOffsets[u + 1]; ++e) {
+      int v = edgeTargets[e];
+      if (own.isSettled(v)) continue;
+      T candidate = distU + edgeWeights[e];
+      if (!own.isReached(v)) {
+        own.heap().push(v, candidate);
+        own.setDistance(v, candidate);
+      } else if (candidate < own.distance(v)) {
+        own.heap().decreaseKey(v, candidate);
+        own.setDistance(v, candidate);
+      }
+      if (other.isReached(v) && candidate + other.distance(v) < best) {
+        best = candidate + other.distance(v);
+      }
+    }
+  };
+
+  while (!forward.heap().empty() && !backward.heap().empty()) {
+    T forwardKey = forward.heap().topKey();
+    T backwardKey = backward.heap().topKey();
+    if (!(forwardKey + backwardKey < best)) break;
+    if (forwardKey <= backwardKey) {
+      step(forward, backward, offsets.data(), targets.data(), weights.data());
+    } else {
+      step(backward, forward, incoming.offsets.data(),
+           incoming.sources.data(), incoming.weights.data());
+    }
+  }
+
+  distance = best;
+  if (settled != nullptr) *settled = popped;
+  return true;
+}
+
+/**
+ * Picks landmarks for alt() by farthest-point selection and stores the
+ * distances from and to each of them. Every new landmark is the vertex
+ * farthest from all landmarks chosen so far, which spreads them over the
+ * edge of the graph where their bounds are tightest.
+ *
+ * @param count Number of landmarks, at most the number of vertices. Fewer
+ * are returned once every vertex left is at distance 0 from a landmark.
+ * @return Landmarks<T> The landmarks and their distance tables.
+ */
+template <typename T>
+Landmarks<T> Graph<T>::selectLandmarks(int count) const {
+  requireFinalized();
+  if (hasNegativeWeights()) {
+    throw std::invalid_argument("Landmarks need non-negative edge weights");
+  }
+  count = std::max(0, std::min(count, numVertices));
+  const T INF = std::numeric_limits<T>::max();
+  const ReverseEdges &incoming = reverse();
+
+  Landmarks<T> landmarks;
+  landmarks.fromLandmark.resize(static_cast<std::size_t>(numVertices) * count);
+  landmarks.toLandmark.resize(static_cast<std::size_t>(numVertices) * count);
+
+  // Distance from each vertex to the nearest landmark chosen so far; the
+  // first landmark is the vertex farthest from vertex 0
+  std::vector<T> nearest(numVertices, INF);
+  std::vector<T> rows[2];
+  if (count > 0) {
+    rows[0].assign(numVertices, INF);
+    dijkstraWithHeap<FourAryHeap<T>>(0, rows[0], offsets.data(),
+                                     targets.data(), weights.data());
+    nearest = rows[0];
+  }
+
+  std::vector<bool> chosen(numVertices, false);
+  for (int i = 0; i < count; ++i) {
+    // Vertices already chosen, and any at distance 0 from them, would only
+    // repeat bounds the tables already give
+    int landmark = -1;
+    for (int v = 0; v < numVertices; ++v) {
+      if (!chosen[v] && nearest[v] > T{0} &&
+          (landmark < 0 || nearest[v] > nearest[landmark])) {
+        landmark = v;
+      }
+    }
+    if (landmark < 0) break;
+    chosen[landmark] = true;
+    landmarks.vertices.push_back(landmark);
+
+    ThreadPool::shared().parallelFor(
+        0, 2, 1, [&](std::size_t lo, std::size_t hi, unsigned) {
+          for (std::size_t side = lo; side < hi; ++side) {
+            rows[side].assign(numVertices, INF);
+            if (side == 0) {
+              dijkstraWithHeap<FourAryHeap<T>>(landmark, rows[0],
+                                               offsets.data(), targets.data(),
+                                               weights.data());
+            } else {
+              dijkstraWithHeap<FourAryHeap<T>>(
+                  landmark, rows[1], incoming.offsets.data(),
+                  incoming.sources.data(), incoming.weights.data());
+            }
+          }
+        });
+
+    for (int v = 0; v < numVertices; ++v) {
+      std::size_t slot = static_cast<std::size_t>(v) * count + i;
+      landmarks.fromLandmark[slot] = rows[0][v];
+      landmarks.toLandmark[slot] = rows[1][v];
+      nearest[v] = std::min(nearest[v], rows[0][v]);
+    }
+    // Vertices the landmark cannot reach stay candidates, so later
+    // landmarks cover other parts of a disconnected graph
+  }
+
+  // Fewer landmarks than asked for: pack the rows to the count found
+  int found = landmarks.count();
+  if (found < count) {
+    for (int v = 0; v < numVertices; ++v) {
+      for (int i = 0; i < found; ++i) {
+        std::size_t from = static_cast<std::size_t>(v) * count + i;
+        std::size_t to = static_cast<std::size_t>(v) * found + i;
+        landmarks.fromLandmark[to] = landmarks.fromLandmark[from];
+        landmarks.toLandmark[to] = landmarks.toLandmark[from];
+      }
+    }
+    std::size_t cells = static_cast<std::size_t>(numVertices) * found;
+    landmarks.fromLandmark.resize(cells);
+    landmarks.toLandmark.resize(cells);
+  }
+  return landmarks;
+}
+
+/**
+ * Computes the shortest path distance from source to target with ALT: A*
+ * with lower bounds taken from the landmark distances by the triangle
+ * inequality, d(v, t) >= d(L, t) - d(L, v) and d(v, t) >= d(v, L) - d(t, L).
+ * Missing distances prove that v cannot reach t at all, and such vertices
+ * are skipped.
+ *
+ * @param landmarks Landmarks from selectLandmarks() on this graph.
+ * @param source The source vertex.
+ * @param target The target vertex.
+ * @param distance Set to the distance, or the maximum of T if unreachable.
+ * @param settled If not null, set to the number of vertices taken from the
+ * queue.
+ * @return bool True if successful, false if a vertex is out of range or the
+ * graph has a negative edge weight.
+ */
 template <typename T>
-bool Graph<T>::dijkstra(int src, std::vector<T> &distances) {
-  // TODO: Implement this
+bool Graph<T>::alt(const Landmarks<T> &landmarks, int source, int target,
+                   T &distance, std::size_t *settled) const {
+  std::size_t k = landmarks.vertices.size();
+  std::size_t cells = static_cast<std::size_t>(numVertices) * k;
+  if (landmarks.fromLandmark.size() != cells ||
+      landmarks.toLandmark.size() != cells) {
+    throw std::invalid_argument("Landmarks belong to a different graph");
+  }
+  if (target < 0 || target >= numVertices) return false;
+
+  const T INF = std::numeric_limits<T>::max();
+  const T *fromTarget = landmarks.fromLandmark.data() + target * k;
+  const T *toTarget = landmarks.toLandmark.data() + target * k;
+  auto bound = [&](int v) {
+    const T *fromV = landmarks.fromLandmark.data() + v * k;
+    const T *toV = landmarks.toLandmark.data() + v * k;
+    T best = 0;
+    for (std::size_t i = 0; i < k; ++i) {
+      if (fromV[i] != INF) {
+        // The landmark reaches v, so it reaches t if v does
+        if (fromTarget[i] == INF) return INF;
+        if (fromTarget[i] - fromV[i] > best) best = fromTarget[i] - fromV[i];
+      }
+      if (toTarget[i] != INF) {
+        // t reaches the landmark, so v does if it reaches t
+        if (toV[i] == INF) return INF;
+        if (toV[i] - toTarget[i] > best) best = toV[i] - toTarget[i];
+      }
+    }
+    return best;
+  };
+  return aStarSearch(source, target, bound, distance, settled);
+}
+
+/**
+ * Computes the shortest path distance between every pair of vertices.
+ * Negative weights are allowed: both modes first run Bellman-Ford from a
+ * virtual source, which finds negative cycles and gives Johnson its
+ * potentials. The matrix takes V^2 entries of T.
+ *
+ * @param distances Set to the distances; emptied if there is a negative
+ * cycle.
+ * @param mode The algorithm to run. Both give the same distances, up to
+ * rounding for floating point weights.
+ * @param pool Threads to run on.
+ * @return bool True if successful, false if the graph has a negative
+ * cycle.
+ */
+template <typename T>
+bool Graph<T>::allPairsShortestPaths(DistanceMatrix<T> &distances,
+                                     AllPairsMode mode,
+                                     ThreadPool &pool) const {
+  requireFinalized();
+  distances.size = 0;
+  distances.values.clear();
+
+  std::vector<T> potentials(numVertices, 0);
+  if (hasNegativeWeights() && !johnsonPotentials(potentials)) return false;
+
+  if (mode == AllPairsMode::FloydWarshall) {
+    floydWarshallMatrix(distances, pool);
+  } else {
+    johnson(distances, potentials, pool);
+  }
   return true;
 }
 
+/**
+ * Runs Bellman-Ford from a virtual source joined to every vertex by a
+ * zero weight edge. The distances h satisfy h(v) <= h(u) + w(u, v), so the
+ * weights w(u, v) + h(u) - h(v) are non-negative.
+ *
+ * @param potentials Set to the distances h.
+ * @return bool False if the graph has a negative cycle.
+ */
+template <typename T>
+bool Graph<T>::johnsonPotentials(std::vector<T> &potentials) const {
+  potentials.assign(numVertices, 0);
+  std::vector<int> parent(numVertices, -1);
+  std::vector<int> negativeCycle;
+  return bellmanFordSpfa(-1, potentials, parent, negativeCycle);
+}
+
+/**
+ * Fills the matrix with blocked Floyd-Warshall. The rows are padded with
+ * unreachable vertices to a whole number of tiles while the kernels run,
+ * and packed afterwards.
+ *
+ * @param distances Set to the distances.
+ * @param pool Threads to run on.
+ */
+template <typename T>
+void Graph<T>::floydWarshallMatrix(DistanceMatrix<T> &distances,
+                                   ThreadPool &pool) const {
+  const T INF = floydWarshallInfinity<T>();
+  const std::size_t n = static_cast<std::size_t>(numVertices);
+  const std::size_t side = (n + FLOYD_WARSHALL_TILE - 1) /
+                           FLOYD_WARSHALL_TILE * FLOYD_WARSHALL_TILE;
+
+  if constexpr (std::is_integral_v<T>) {
+    // Every path is shorter than (V - 1) * max |w|, and so are the sums
+    // the kernels form from INF; keeping it under INF / 2 tells them apart
+    double longest = 0;
+    for (T weight : weights) {
+      longest = std::max(longest, std::abs(static_cast<double>(weight)));
+    }
+    if (longest * static_cast<double>(n) >= INF / 2) {
+      throw std::overflow_error(
+          "Path lengths may not fit in the weight type for Floyd-Warshall");
+    }
+  }
+
+  std::vector<T> &values = distances.values;
+  values.resize(side * side);
+  pool.parallelFor(0, side, 64, [&](std::size_t lo, std::size_t hi,
+                                    unsigned) {
+    for (std::size_t u = lo; u < hi; ++u) {
+      T *row = values.data() + u * side;
+      std::fill(row, row + side, INF);
+      row[u] = 0;
+      if (u >= n) continue;
+      for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+        row[targets[e]] = std::min(row[targets[e]], weights[e]);
+      }
+    }
+  });
+
+  floydWarshall(values.data(), side, pool);
+
+  // Rows move towards the front, so packing them in order never
+  // overwrites a row that is still to be read
+  for (std::size_t u = 0; u < n && side != n; ++u) {
+    std::copy(values.begin() + u * side, values.begin() + u * side + n,
+              values.begin() + u * n);
+  }
+  values.resize(n * n);
+  values.shrink_to_fit();
+  pool.parallelFor(0, n, 64, [&](std::size_t lo, std::size_t hi, unsigned) {
+    for (std::size_t i = lo * n; i < hi * n; ++i) {
+      if (values[i] >= INF / 2) values[i] = std::numeric_limits<T>::max();
+    }
+  });
+  distances.size = numVertices;
+}
+
+/**
+ * Fills the matrix with Johnson's algorithm: one Dijkstra search from
+ * every vertex, spread over the thread pool, on the weights reweighted by
+ * the potentials. A distance d' found that way is d'(s, v) = d(s, v) +
+ * h(s) - h(v), which is undone as the row is written.
+ *
+ * @param distances Set to the distances.
+ * @param potentials The potentials from johnsonPotentials, all zero if no
+ * weight is negative.
+ * @param pool Threads to run on.
+ */
+template <typename T>
+void Graph<T>::johnson(DistanceMatrix<T> &distances,
+                       const std::vector<T> &potentials,
+                       ThreadPool &pool) const {
+  const T INF = std::numeric_limits<T>::max();
+  const std::size_t n = static_cast<std::size_t>(numVertices);
+
+  const T *edgeWeights = weights.data();
+  std::vector<T> reweighted;
+  if (hasNegativeWeights()) {
+    reweighted.resize(weights.size());
+    pool.parallelFor(0, n, 4096, [&](std::size_t lo, std::size_t hi,
+                                     unsigned) {
+      for (std::size_t u = lo; u < hi; ++u) {
+        for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+          // Rounding can leave a floating point weight just below zero
+          T weight = weights[e] + potentials[u] - potentials[targets[e]];
+          reweighted[e] = std::max<T>(weight, 0);
+        }
+      }
+    });
+    edgeWeights = reweighted.data();
+  }
+
+  distances.values.resize(n * n);
+  std::vector<std::vector<T>> rows(pool.size());
+  pool.parallelFor(0, n, 4, [&](std::size_t lo, std::size_t hi,
+                                unsigned worker) {
+    std::vector<T> &row = rows[worker];
+    for (std::size_t s = lo; s < hi; ++s) {
+      row.assign(n, INF);
+      dijkstraWithHeap<FourAryHeap<T>>(static_cast<int>(s), row,
+                                       offsets.data(), targets.data(),
+                                       edgeWeights);
+      T *out = distances.values.data() + s * n;
+      for (std::size_t v = 0; v < n; ++v) {
+        out[v] = row[v] == INF ? INF : row[v] - potentials[s] + potentials[v];
+      }
+    }
+  });
+  distances.size = numVertices;
+}
+
+/**
+ * Computes a minimum spanning forest: a minimum spanning tree of every
+ * connected component. Edge directions are ignored, so an edge u -> v
+ * joins u and v either way; a graph that stores both directions of a road
+ * offers it twice, which only costs time. Negative weights are fine.
+ *
+ * @param mode The algorithm to run. All three find a forest of the same
+ * total weight; with equal weights they may pick different edges.
+ * @param pool Threads for the Kruskal sort and the Boruvka rounds; Prim
+ * runs on the calling thread.
+ * @return SpanningForest<T> The forest, with n - k edges for a graph of n
+ * vertices and k connected components.
+ */
+template <typename T>
+SpanningForest<T> Graph<T>::minimumSpanningForest(SpanningForestMode mode,
+                                                  ThreadPool &pool) const {
+  requireFinalized();
+  SpanningForest<T> forest;
+  switch (mode) {
+    case SpanningForestMode::Kruskal:
+      kruskal(forest, pool);
+      break;
+    case SpanningForestMode::Prim:
+      prim(forest);
+      break;
+    case SpanningForestMode::Boruvka:
+      boruvka(forest, pool);
+      break;
+  }
+  for (const auto &edge : forest.edges) forest.totalWeight += edge.weight;
+  return forest;
+}
+
+/**
+ * Kruskal's algorithm: sorts all edges by weight with the thread pool,
+ * then keeps every edge that joins two different trees of a union-find.
+ * The scan stops once the forest is a single tree.
+ *
+ * @param forest Receives the edges.
+ * @param pool Threads for the sort.
+ */
+template <typename T>
+void Graph<T>::kruskal(SpanningForest<T> &forest, ThreadPool &pool) const {
+  using Edge = typename SpanningForest<T>::Edge;
+  std::vector<Edge> edges(targets.size());
+  pool.parallelFor(0, numVertices, 4096,
+                   [&](std::size_t lo, std::size_t hi, unsigned) {
+                     for (std::size_t u = lo; u < hi; ++u) {
+                       for (std::size_t e = offsets[u]; e < offsets[u + 1];
+                            ++e) {
+                         edges[e] = {static_cast<int>(u), targets[e],
+                                     weights[e]};
+                       }
+                     }
+                   });
+  pool.parallelSort(edges.begin(), edges.end(),
+                    [](const Edge &a, const Edge &b) {
+                      return a.weight < b.weight;
+                    });
+
+  DisjointSets trees(numVertices);
+  std::size_t limit = numVertices > 0 ? numVertices - 1 : 0;
+  for (const Edge &edge : edges) {
+    if (forest.edges.size() == limit) break;
+    if (trees.unite(edge.from, edge.to)) forest.edges.push_back(edge);
+  }
+}
+
+/**
+ * Prim's algorithm: grows one tree at a time from the lowest unreached
+ * vertex. An indexed 4-ary heap holds every vertex next to the tree, keyed
+ * by the lightest edge joining it, and decreaseKey lowers that key when a
+ * lighter edge shows up. Both out- and in-edges are scanned, the latter
+ * from the cached reverse CSR.
+ *
+ * @param forest Receives the edges.
+ */
+template <typename T>
+void Graph<T>::prim(SpanningForest<T> &forest) const {
+  using Edge = typename SpanningForest<T>::Edge;
+  const ReverseEdges &incoming = reverse();
+  std::vector<char> inTree(numVertices, 0);
+  std::vector<Edge> link(numVertices);  // lightest edge to the tree so far
+  FourAryHeap<T> heap(numVertices);
+
+  auto offer = [&](int v, const Edge &edge) {
+    if (inTree[v]) return;
+    if (!heap.contains(v)) {
+      heap.push(v, edge.weight);
+      link[v] = edge;
+    } else if (edge.weight < link[v].weight) {
+      heap.decreaseKey(v, edge.weight);
+      link[v] = edge;
+    }
+  };
+
+  for (int root = 0; root < numVertices; ++root) {
+    if (inTree[root]) continue;
+    int u = root;
+    while (true) {
+      inTree[u] = 1;
+      for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+        offer(targets[e], {u, targets[e], weights[e]});
+      }
+      for (std::size_t e = incoming.offsets[u]; e < incoming.offsets[u + 1];
+           ++e) {
+        offer(incoming.sources[e], {incoming.sources[e], u,
+                                    incoming.weights[e]});
+      }
+      if (heap.empty()) break;
+      u = heap.pop().first;
+      forest.edges.push_back(link[u]);
+    }
+  }
+}
+
+/**
+ * Boruvka's algorithm, one parallel pass over the edges per round. Every
+ * component finds the lightest edge leaving it with an atomic
+ * compare-and-swap minimum and hooks onto the component at its other end.
+ * Ties are broken by edge index, which makes the order strict: the only
+ * cycles among the hooks are two components that picked the same edge,
+ * and the smaller of the two becomes the root. Pointer jumping then
+ * flattens the hooks, and edges inside a component are dropped. The
+ * number of components at least halves every round.
+ *
+ * @param forest Receives the edges.
+ * @param pool Threads for the rounds.
+ */
+template <typename T>
+void Graph<T>::boruvka(SpanningForest<T> &forest, ThreadPool &pool) const {
+  const std::size_t NONE = std::numeric_limits<std::size_t>::max();
+  const std::size_t GRAIN = 4096;
+  const std::size_t BLOCK = 1 << 16;
+  const std::size_t n = static_cast<std::size_t>(numVertices);
+
+  std::vector<int> sources(targets.size());
+  // Component of every vertex, named after one of its vertices
+  std::vector<int> component(n);
+  std::vector<int> hook(n);
+  std::vector<int> jumped(n);
+  std::unique_ptr<std::atomic<std::size_t>[]> lightest(
+      new std::atomic<std::size_t>[n]);
+  pool.parallelFor(0, n, GRAIN, [&](std::size_t lo, std::size_t hi, unsigned) {
+    for (std::size_t u = lo; u < hi; ++u) {
+      for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+        sources[e] = static_cast<int>(u);
+      }
+      component[u] = static_cast<int>(u);
+      lightest[u].store(NONE, std::memory_order_relaxed);
+    }
+  });
+  std::vector<int> roots(component);
+
+  auto lighter = [&](std::size_t a, std::size_t b) {
+    return weights[a] < weights[b] || (!(weights[b] < weights[a]) && a < b);
+  };
+  auto offer = [&](int c, std::size_t arc) {
+    std::size_t current = lightest[c].load(std::memory_order_relaxed);
+    while (current == NONE || lighter(arc, current)) {
+      if (lightest[c].compare_exchange_weak(current, arc,
+                                            std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  };
+
+  // Keeps the edges whose ends lie in different components, block by
+  // block: count the survivors of every block, then copy them out
+  auto crossing = [&](std::size_t arc) {
+    return component[sources[arc]] != component[targets[arc]];
+  };
+  auto compact = [&](std::size_t count, auto arcAt) {
+    std::size_t blocks = (count + BLOCK - 1) / BLOCK;
+    std::vector<std::size_t> start(blocks + 1, 0);
+    pool.parallelFor(0, blocks, 1,
+                     [&](std::size_t lo, std::size_t hi, unsigned) {
+                       for (std::size_t b = lo; b < hi; ++b) {
+                         std::size_t end = std::min(count, (b + 1) * BLOCK);
+                         for (std::size_t i = b * BLOCK; i < end; ++i) {
+                           if (crossing(arcAt(i))) ++start[b + 1];
+                         }
+                       }
+                     });
+    for (std::size_t b = 0; b < blocks; ++b) start[b + 1] += start[b];
+    std::vector<std::size_t> kept(start[blocks]);
+    pool.parallelFor(0, blocks, 1,
+                     [&](std::size_t lo, std::size_t hi, unsigned) {
+                       for (std::size_t b = lo; b < hi; ++b) {
+                         std::size_t end = std::min(count, (b + 1) * BLOCK);
+                         std::size_t slot = start[b];
+                         for (std::size_t i = b * BLOCK; i < end; ++i) {
+                           std::size_t arc = arcAt(i);
+                           if (crossing(arc)) kept[slot++] = arc;
+                         }
+                       }
+                     });
+    return kept;
+  };
+  std::vector<std::size_t> live =
+      compact(targets.size(), [](std::size_t i) { return i; });
+
+  // Moves every current component c to next(c), computed for all of them
+  // before any moves; tells whether one of them moved
+  auto step = [&](auto next) {
+    std::atomic<bool> changed(false);
+    pool.parallelFor(0, roots.size(), GRAIN,
+                     [&](std::size_t lo, std::size_t hi, unsigned) {
+                       for (std::size_t i = lo; i < hi; ++i) {
+                         int c = roots[i];
+                         jumped[c] = next(c);
+                         if (jumped[c] != hook[c]) {
+                           changed.store(true, std::memory_order_relaxed);
+                         }
+                       }
+                     });
+    pool.parallelFor(0, roots.size(), GRAIN,
+                     [&](std::size_t lo, std::size_t hi, unsigned) {
+                       for (std::size_t i = lo; i < hi; ++i) {
+                         hook[roots[i]] = jumped[roots[i]];
+                       }
+                     });
+    return changed.load(std::memory_order_relaxed);
+  };
+
+  while (!live.empty()) {
+    pool.parallelFor(0, live.size(), GRAIN,
+                     [&](std::size_t lo, std::size_t hi, unsigned) {
+                       for (std::size_t i = lo; i < hi; ++i) {
+                         std::size_t arc = live[i];
+                         offer(component[sources[arc]], arc);
+                         offer(component[targets[arc]], arc);
+                       }
+                     });
+
+    step([&](int c) {
+      std::size_t arc = lightest[c].load(std::memory_order_relaxed);
+      if (arc == NONE) return c;
+      int from = component[sources[arc]];
+      return from == c ? component[targets[arc]] : from;
+    });
+    step([&](int c) {
+      int h = hook[c];
+      return hook[h] == c && c < h ? c : h;
+    });
+
+    // Every component that hooks onto another adds its edge; one without
+    // an edge to another component is finished
+    std::vector<int> remaining;
+    for (int c : roots) {
+      std::size_t arc = lightest[c].load(std::memory_order_relaxed);
+      if (hook[c] != c) {
+        forest.edges.push_back({sources[arc], targets[arc], weights[arc]});
+      } else if (arc != NONE) {
+        remaining.push_back(c);
+      }
+      lightest[c].store(NONE, std::memory_order_relaxed);
+    }
+
+    // Pointer jumping until every component points at its root
+    while (step([&](int c) { return hook[hook[c]]; })) continue;
+    pool.parallelFor(0, n, GRAIN,
+                     [&](std::size_t lo, std::size_t hi, unsigned) {
+                       for (std::size_t v = lo; v < hi; ++v) {
+                         component[v] = hook[component[v]];
+                       }
+                     });
+    roots.swap(remaining);
+    live = compact(live.size(), [&](std::size_t i) { return live[i]; });
+  }
+}
+
 // Explicit template instantiation
 template class Graph<int>;
 template class Graph<float>;
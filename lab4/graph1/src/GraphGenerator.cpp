@@ -0,0 +1,252 @@
+#include "../include/GraphGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+#include "../include/DotWriter.hpp"
+
+namespace GraphGenerator {
+
+namespace {
+
+/**
+ * Seeded source of the random numbers the generators use.
+ */
+class Random {
+ private:
+  std::mt19937_64 engine;
+
+ public:
+  explicit Random(std::uint64_t seed) : engine(seed) {}
+
+  // Uniform in [0, n); the modulo bias is below 2^-40 for any vertex count
+  std::uint64_t below(std::uint64_t n) { return engine() % n; }
+
+  // Uniform in [0, 1)
+  double unit() { return static_cast<double>(engine() >> 11) * 0x1.0p-53; }
+};
+
+void requireVertices(const Options &options, int minimum) {
+  if (options.vertices < minimum) {
+    throw std::invalid_argument("Need at least " + std::to_string(minimum) +
+                                " vertices");
+  }
+  if (options.averageDegree < 0 || options.maxWeight < 1) {
+    throw std::invalid_argument("Invalid average degree or maximum weight");
+  }
+}
+
+std::size_t edgeCount(const Options &options, int vertices) {
+  return static_cast<std::size_t>(
+      std::llround(options.averageDegree * vertices));
+}
+
+double randomWeight(Random &random, const Options &options) {
+  return static_cast<double>(1 + random.below(options.maxWeight));
+}
+
+int randomVertex(Random &random, int vertices) {
+  return static_cast<int>(random.below(vertices));
+}
+
+/**
+ * Random permutation of [0, size), by Fisher-Yates.
+ */
+std::vector<int> shuffledIds(Random &random, int size) {
+  std::vector<int> ids(size);
+  for (int i = 0; i < size; ++i) ids[i] = i;
+  for (int i = size - 1; i > 0; --i) {
+    std::swap(ids[i], ids[random.below(static_cast<std::uint64_t>(i) + 1)]);
+  }
+  return ids;
+}
+
+}  // namespace
+
+EdgeList erdosRenyi(const Options &options) {
+  requireVertices(options, 2);
+  Random random(options.seed);
+  EdgeList graph{options.vertices, {}};
+  std::size_t count = edgeCount(options, options.vertices);
+  graph.edges.reserve(count);
+  while (graph.edges.size() < count) {
+    int from = randomVertex(random, options.vertices);
+    int to = randomVertex(random, options.vertices);
+    if (from == to) continue;
+    graph.edges.push_back({from, to, randomWeight(random, options)});
+  }
+  return graph;
+}
+
+/**
+ * Every edge descends the 2^scale x 2^scale adjacency matrix one level at
+ * a time, picking a quadrant with the R-MAT probabilities. Edges that land
+ * outside the vertex range or on the diagonal are drawn again.
+ */
+EdgeList rmat(const Options &options) {
+  requireVertices(options, 2);
+  constexpr double A = 0.57, B = 0.19, C = 0.19;
+  Random random(options.seed);
+  int scale = 0;
+  while ((1LL << scale) < options.vertices) ++scale;
+
+  std::vector<int> ids = shuffledIds(random, options.vertices);
+  EdgeList graph{options.vertices, {}};
+  std::size_t count = edgeCount(options, options.vertices);
+  graph.edges.reserve(count);
+  while (graph.edges.size() < count) {
+    long long from = 0, to = 0;
+    for (int level = 0; level < scale; ++level) {
+      double r = random.unit();
+      from = 2 * from + (r >= A + B);
+      to = 2 * to + ((r >= A && r < A + B) || r >= A + B + C);
+    }
+    if (from >= options.vertices || to >= options.vertices || from == to) {
+      continue;
+    }
+    graph.edges.push_back(
+        {ids[from], ids[to], randomWeight(random, options)});
+  }
+  return graph;
+}
+
+EdgeList grid(const Options &options) {
+  requireVertices(options, 1);
+  Random random(options.seed);
+  int width = static_cast<int>(std::ceil(std::sqrt(options.vertices)));
+  EdgeList graph{options.vertices, {}};
+  graph.edges.reserve(4 * static_cast<std::size_t>(options.vertices));
+
+  auto connect = [&](int a, int b) {
+    double weight = randomWeight(random, options);
+    graph.edges.push_back({a, b, weight});
+    graph.edges.push_back({b, a, weight});
+  };
+  for (int v = 0; v < options.vertices; ++v) {
+    if (v % width + 1 < width && v + 1 < options.vertices) connect(v, v + 1);
+    if (v + width < options.vertices) connect(v, v + width);
+  }
+  return graph;
+}
+
+EdgeList randomDag(const Options &options) {
+  requireVertices(options, 2);
+  Random random(options.seed);
+  std::vector<int> rank = shuffledIds(random, options.vertices);
+  EdgeList graph{options.vertices, {}};
+  std::size_t count = edgeCount(options, options.vertices);
+  graph.edges.reserve(count);
+  while (graph.edges.size() < count) {
+    int from = randomVertex(random, options.vertices);
+    int to = randomVertex(random, options.vertices);
+    if (from == to) continue;
+    if (rank[from] > rank[to]) std::swap(from, to);
+    graph.edges.push_back({from, to, randomWeight(random, options)});
+  }
+  return graph;
+}
+
+EdgeList layeredFlowNetwork(const Options &options) {
+  requireVertices(options, 2);
+  Random random(options.seed);
+  int source = 0, sink = options.vertices - 1;
+  int inner = options.vertices - 2;
+  EdgeList graph{options.vertices, {}};
+  if (inner == 0) {
+    graph.edges.push_back({source, sink, randomWeight(random, options)});
+    return graph;
+  }
+
+  // Layer i holds the vertices [start(i), start(i + 1))
+  int layers = std::max(1, static_cast<int>(std::lround(std::sqrt(inner))));
+  auto start = [&](int layer) {
+    return 1 + static_cast<int>(static_cast<long long>(inner) * layer /
+                                layers);
+  };
+  int degree =
+      std::max(1, static_cast<int>(std::lround(options.averageDegree)));
+  graph.edges.reserve(static_cast<std::size_t>(inner) * degree + inner);
+
+  for (int v = start(0); v < start(1); ++v) {
+    graph.edges.push_back({source, v, randomWeight(random, options)});
+  }
+  for (int layer = 0; layer + 1 < layers; ++layer) {
+    int next = start(layer + 1), width = start(layer + 2) - next;
+    for (int v = start(layer); v < next; ++v) {
+      for (int e = 0; e < degree; ++e) {
+        graph.edges.push_back({v, next + randomVertex(random, width),
+                               randomWeight(random, options)});
+      }
+    }
+  }
+  for (int v = start(layers - 1); v < start(layers); ++v) {
+    graph.edges.push_back({v, sink, randomWeight(random, options)});
+  }
+  return graph;
+}
+
+EdgeList bipartite(const Options &options) {
+  requireVertices(options, 2);
+  Random random(options.seed);
+  int left = options.vertices / 2, right = options.vertices - left;
+  EdgeList graph{options.vertices, {}};
+  std::size_t count = edgeCount(options, left);
+  graph.edges.reserve(count);
+  while (graph.edges.size() < count) {
+    graph.edges.push_back({randomVertex(random, left),
+                           left + randomVertex(random, right),
+                           randomWeight(random, options)});
+  }
+  return graph;
+}
+
+const std::vector<std::string> &names() {
+  static const std::vector<std::string> families = {
+      "erdos-renyi", "rmat", "grid", "dag", "flow", "bipartite"};
+  return families;
+}
+
+EdgeList generate(const std::string &family, const Options &options) {
+  if (family == "erdos-renyi") return erdosRenyi(options);
+  if (family == "rmat") return rmat(options);
+  if (family == "grid") return grid(options);
+  if (family == "dag") return randomDag(options);
+  if (family == "flow") return layeredFlowNetwork(options);
+  if (family == "bipartite") return bipartite(options);
+  throw std::invalid_argument("Unknown graph family: " + family);
+}
+
+/**
+ * Writes the graph as JSON, one edge per line like the hand-written inputs.
+ * The text goes through the buffered DOT writer, which formats numbers
+ * straight into its buffer.
+ *
+ * @param graph The graph to write.
+ * @param filename Path of the JSON file.
+ */
+void writeJson(const EdgeList &graph, const std::string &filename) {
+  std::ofstream file(filename, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Could not open file for writing: " + filename);
+  }
+  {
+    DotWriter out(file);
+    out << "{\n  \"vertices\": " << graph.vertices << ",\n  \"edges\": [";
+    for (std::size_t i = 0; i < graph.edges.size(); ++i) {
+      const Edge &edge = graph.edges[i];
+      out << (i == 0 ? "\n" : ",\n") << "    { \"from\": " << edge.from
+          << ", \"to\": " << edge.to << ", \"weight\": " << edge.weight
+          << " }";
+    }
+    out << "\n  ]\n}\n";
+    out.flush();
+  }
+  if (!file.flush()) {
+    throw std::runtime_error("Could not write file: " + filename);
+  }
+}
+
+}  // namespace GraphGenerator
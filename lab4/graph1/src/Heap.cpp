@@ -0,0 +1,318 @@
+#include "../include/Heap.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Returns a human readable name for a heap type, used by the benchmark
+ * tables.
+ *
+ * @param type The heap type.
+ * @return const char* The display name of the heap.
+ */
+const char *heapTypeName(HeapType type) {
+  switch (type) {
+    case HeapType::Binary:
+      return "binary";
+    case HeapType::FourAry:
+      return "4-ary";
+    case HeapType::Pairing:
+      return "pairing";
+    case HeapType::Radix:
+      return "radix";
+  }
+  return "unknown";
+}
+
+/* ------------------------------ DaryHeap ------------------------------ */
+
+template <typename T, int D>
+DaryHeap<T, D>::DaryHeap(int capacity)
+    : position(capacity, -1), keys(capacity) {
+  heap.reserve(capacity);
+}
+
+/**
+ * Moves the vertex at the given heap position towards the root until its
+ * parent has a smaller or equal key.
+ *
+ * @param index Heap position of the vertex to move.
+ */
+template <typename T, int D>
+void DaryHeap<T, D>::siftUp(int index) {
+  int vertex = heap[index];
+  T key = keys[vertex];
+  while (index > 0) {
+    int parent = (index - 1) / D;
+    if (!(key < keys[heap[parent]])) break;
+    heap[index] = heap[parent];
+    position[heap[index]] = index;
+    index = parent;
+  }
+  heap[index] = vertex;
+  position[vertex] = index;
+}
+
+/**
+ * Moves the vertex at the given heap position towards the leaves until all
+ * of its children have larger or equal keys.
+ *
+ * @param index Heap position of the vertex to move.
+ */
+template <typename T, int D>
+void DaryHeap<T, D>::siftDown(int index) {
+  int size = static_cast<int>(heap.size());
+  int vertex = heap[index];
+  T key = keys[vertex];
+  while (true) {
+    int first = index * D + 1;
+    if (first >= size) break;
+    int last = std::min(first + D, size);
+    int best = first;
+    for (int c = first + 1; c < last; ++c) {
+      if (keys[heap[c]] < keys[heap[best]]) best = c;
+    }
+    if (!(keys[heap[best]] < key)) break;
+    heap[index] = heap[best];
+    position[heap[index]] = index;
+    index = best;
+  }
+  heap[index] = vertex;
+  position[vertex] = index;
+}
+
+template <typename T, int D>
+void DaryHeap<T, D>::push(int vertex, T key) {
+  keys[vertex] = key;
+  heap.push_back(vertex);
+  siftUp(static_cast<int>(heap.size()) - 1);
+}
+
+template <typename T, int D>
+void DaryHeap<T, D>::decreaseKey(int vertex, T key) {
+  keys[vertex] = key;
+  siftUp(position[vertex]);
+}
+
+template <typename T, int D>
+std::pair<int, T> DaryHeap<T, D>::pop() {
+  int top = heap.front();
+  position[top] = -1;
+  int tail = heap.back();
+  heap.pop_back();
+  if (!heap.empty()) {
+    heap[0] = tail;
+    siftDown(0);
+  }
+  return {top, keys[top]};
+}
+
+/**
+ * Empties the heap in time proportional to its current size, so a search
+ * that stopped early can hand the heap to the next one.
+ */
+template <typename T, int D>
+void DaryHeap<T, D>::clear() {
+  for (int vertex : heap) position[vertex] = -1;
+  heap.clear();
+}
+
+/* ----------------------------- PairingHeap ---------------------------- */
+
+template <typename T>
+PairingHeap<T>::PairingHeap(int capacity)
+    : keys(capacity),
+      child(capacity, -1),
+      sibling(capacity, -1),
+      prev(capacity, -1),
+      inHeap(capacity, 0),
+      root(-1) {}
+
+/**
+ * Links two heap-ordered trees, making the root with the larger key the
+ * leftmost child of the other.
+ *
+ * @param a Root of the first tree (may be -1).
+ * @param b Root of the second tree (may be -1).
+ * @return int The root of the combined tree.
+ */
+template <typename T>
+int PairingHeap<T>::meld(int a, int b) {
+  if (a == -1) return b;
+  if (b == -1) return a;
+  if (keys[b] < keys[a]) std::swap(a, b);
+  sibling[b] = child[a];
+  if (child[a] != -1) prev[child[a]] = b;
+  prev[b] = a;
+  child[a] = b;
+  sibling[a] = -1;
+  prev[a] = -1;
+  return a;
+}
+
+/**
+ * Detaches the subtree rooted at a non-root vertex from its parent.
+ *
+ * @param vertex The vertex whose subtree is cut out.
+ */
+template <typename T>
+void PairingHeap<T>::cut(int vertex) {
+  int p = prev[vertex];
+  if (child[p] == vertex) {
+    child[p] = sibling[vertex];
+  } else {
+    sibling[p] = sibling[vertex];
+  }
+  if (sibling[vertex] != -1) prev[sibling[vertex]] = p;
+  sibling[vertex] = -1;
+  prev[vertex] = -1;
+}
+
+template <typename T>
+void PairingHeap<T>::push(int vertex, T key) {
+  keys[vertex] = key;
+  child[vertex] = sibling[vertex] = prev[vertex] = -1;
+  inHeap[vertex] = 1;
+  root = meld(root, vertex);
+}
+
+template <typename T>
+void PairingHeap<T>::decreaseKey(int vertex, T key) {
+  keys[vertex] = key;
+  if (vertex == root) return;
+  cut(vertex);
+  root = meld(root, vertex);
+}
+
+/**
+ * Removes the minimum and rebuilds the heap from its children with the
+ * standard two-pass (left-to-right pairing, right-to-left melding) strategy.
+ *
+ * @return std::pair<int, T> The vertex with the minimum key and that key.
+ */
+template <typename T>
+std::pair<int, T> PairingHeap<T>::pop() {
+  int top = root;
+  inHeap[top] = 0;
+
+  pairs.clear();
+  for (int c = child[top]; c != -1;) {
+    int a = c;
+    int b = sibling[a];
+    c = (b != -1) ? sibling[b] : -1;
+    sibling[a] = prev[a] = -1;
+    if (b != -1) sibling[b] = prev[b] = -1;
+    pairs.push_back(meld(a, b));
+  }
+
+  root = -1;
+  for (auto it = pairs.rbegin(); it != pairs.rend(); ++it) {
+    root = meld(*it, root);
+  }
+  child[top] = -1;
+  return {top, keys[top]};
+}
+
+/* ------------------------------ RadixHeap ----------------------------- */
+
+template <typename T>
+RadixHeap<T>::RadixHeap(int capacity)
+    : keys(capacity), inHeap(capacity, 0), last(0), count(0) {}
+
+/**
+ * Maps a non-negative key to an unsigned integer with the same ordering.
+ *
+ * @param key The key to convert.
+ * @return std::uint64_t The order preserving radix of the key.
+ */
+template <typename T>
+std::uint64_t RadixHeap<T>::toRadix(T key) {
+  if constexpr (std::is_integral_v<T>) {
+    return static_cast<std::uint64_t>(key);
+  } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return bits;
+  } else {
+    std::uint64_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return bits;
+  }
+}
+
+/**
+ * Bucket i holds radices whose highest bit differing from the last popped
+ * radix is bit i - 1; bucket 0 holds radices equal to it.
+ */
+template <typename T>
+int RadixHeap<T>::bucketIndex(std::uint64_t radix) const {
+  std::uint64_t diff = radix ^ last;
+  return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+}
+
+template <typename T>
+void RadixHeap<T>::insert(int vertex, T key) {
+  keys[vertex] = key;
+  std::uint64_t radix = toRadix(key);
+  buckets[bucketIndex(radix)].push_back({radix, vertex});
+}
+
+template <typename T>
+void RadixHeap<T>::push(int vertex, T key) {
+  inHeap[vertex] = 1;
+  ++count;
+  insert(vertex, key);
+}
+
+/**
+ * Radix heaps have no cheap way to find an entry, so a decreased key is
+ * inserted again and the outdated entry is skipped when it surfaces.
+ */
+template <typename T>
+void RadixHeap<T>::decreaseKey(int vertex, T key) {
+  insert(vertex, key);
+}
+
+template <typename T>
+std::pair<int, T> RadixHeap<T>::pop() {
+  while (true) {
+    if (buckets[0].empty()) {
+      int i = 1;
+      while (buckets[i].empty()) ++i;
+
+      std::uint64_t minRadix = buckets[i].front().radix;
+      for (const auto &entry : buckets[i]) {
+        minRadix = std::min(minRadix, entry.radix);
+      }
+      last = minRadix;
+      for (const auto &entry : buckets[i]) {
+        buckets[bucketIndex(entry.radix)].push_back(entry);
+      }
+      buckets[i].clear();
+    }
+
+    Entry entry = buckets[0].back();
+    buckets[0].pop_back();
+    int vertex = entry.vertex;
+    if (inHeap[vertex] && toRadix(keys[vertex]) == entry.radix) {
+      inHeap[vertex] = 0;
+      --count;
+      return {vertex, keys[vertex]};
+    }
+  }
+}
+
+// Explicit template instantiation
+template class DaryHeap<int, 2>;
+template class DaryHeap<float, 2>;
+template class DaryHeap<double, 2>;
+template class DaryHeap<int, 4>;
+template class DaryHeap<float, 4>;
+template class DaryHeap<double, 4>;
+template class PairingHeap<int>;
+template class PairingHeap<float>;
+template class PairingHeap<double>;
+template class RadixHeap<int>;
+template class RadixHeap<float>;
+template class RadixHeap<double>;
@@ -0,0 +1,163 @@
+#include "../include/IncrementalShortestPaths.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+/**
+ * Runs a full Dijkstra search from the source to start from.
+ *
+ * @param graph The graph to follow; must outlive this object
+ * @param source The source vertex
+ * @throws std::out_of_range If the source is not a vertex of the graph
+ * @throws std::invalid_argument If the graph has a negative edge weight
+ */
+template <typename T>
+IncrementalShortestPaths<T>::IncrementalShortestPaths(
+    const DynamicGraph<T> &graph, int source)
+    : graph(&graph), source(source), queue(0), lastTouched(0) {
+  if (source < 0 || source >= graph.getNumVertices()) {
+    throw std::out_of_range("Source vertex out of range");
+  }
+  for (int u = 0; u < graph.getNumVertices(); ++u) {
+    for (const auto &arc : graph.outEdges(u)) {
+      if (arc.weight < T()) {
+        throw std::invalid_argument(
+            "Incremental shortest paths need non-negative edge weights");
+      }
+    }
+  }
+
+  grow();
+  dist[source] = T();
+  queue.push(source, T());
+  propagate();
+}
+
+/**
+ * Repairs the distances after a batch was applied to the graph.
+ *
+ * Heavier and removed edges are handled first. A vertex whose tree edge
+ * got worse loses its distance together with its whole subtree; each of
+ * these orphans restarts from the best edge coming in from outside the
+ * orphaned set. Lighter and new edges then seed the same queue wherever
+ * they improve their head, and one Dijkstra pass settles everything.
+ * Vertices that are neither orphaned nor improved are never visited.
+ *
+ * @param changes The changes returned by DynamicGraph::apply
+ * @throws std::invalid_argument If the batch introduced a negative weight;
+ * the distances are left as they were before the batch
+ */
+template <typename T>
+void IncrementalShortestPaths<T>::update(
+    const std::vector<EdgeChange<T>> &changes) {
+  for (const EdgeChange<T> &change : changes) {
+    if (change.exists && change.newWeight < T()) {
+      throw std::invalid_argument(
+          "Incremental shortest paths need non-negative edge weights");
+    }
+  }
+  grow();
+
+  // Roots of the orphaned subtrees: heads of worsened tree edges
+  std::vector<int> orphans;
+  for (const EdgeChange<T> &change : changes) {
+    bool worse = change.existed &&
+                 (!change.exists || change.oldWeight < change.newWeight);
+    if (worse && parent[change.to] == change.from && !orphan[change.to]) {
+      orphan[change.to] = 1;
+      orphans.push_back(change.to);
+    }
+  }
+  for (std::size_t i = 0; i < orphans.size(); ++i) {
+    int u = orphans[i];
+    for (const auto &arc : graph->outEdges(u)) {
+      if (parent[arc.vertex] == u && !orphan[arc.vertex]) {
+        orphan[arc.vertex] = 1;
+        orphans.push_back(arc.vertex);
+      }
+    }
+  }
+
+  const T INF = std::numeric_limits<T>::max();
+  for (int v : orphans) {
+    dist[v] = INF;
+    parent[v] = -1;
+  }
+  for (int v : orphans) {
+    for (const auto &arc : graph->inEdges(v)) {
+      if (orphan[arc.vertex] || dist[arc.vertex] == INF) continue;
+      T candidate = dist[arc.vertex] + arc.weight;
+      if (candidate < dist[v]) {
+        dist[v] = candidate;
+        parent[v] = arc.vertex;
+      }
+    }
+    if (dist[v] != INF) queue.push(v, dist[v]);
+  }
+  for (int v : orphans) orphan[v] = 0;
+  lastTouched = orphans.size();
+
+  for (const EdgeChange<T> &change : changes) {
+    if (change.exists && dist[change.from] != INF) {
+      improve(change.to, dist[change.from] + change.newWeight, change.from);
+    }
+  }
+  propagate();
+}
+
+/**
+ * Extends the per-vertex arrays to vertices added to the graph since the
+ * last call. New vertices start unreachable.
+ */
+template <typename T>
+void IncrementalShortestPaths<T>::grow() {
+  int n = graph->getNumVertices();
+  dist.resize(n, std::numeric_limits<T>::max());
+  parent.resize(n, -1);
+  orphan.resize(n, 0);
+  if (queue.capacity() < n) {
+    // The queue is empty between updates; grow it geometrically so that
+    // adding vertices one batch at a time stays cheap
+    queue = FourAryHeap<T>(std::max(n, 2 * queue.capacity()));
+  }
+}
+
+/**
+ * Lowers the distance of a vertex if the new one is shorter and queues it.
+ *
+ * @param v The vertex
+ * @param distance Candidate distance of v
+ * @param from Predecessor of v on the candidate path
+ */
+template <typename T>
+void IncrementalShortestPaths<T>::improve(int v, T distance, int from) {
+  if (!(distance < dist[v])) return;
+  dist[v] = distance;
+  parent[v] = from;
+  if (queue.contains(v)) {
+    queue.decreaseKey(v, distance);
+  } else {
+    queue.push(v, distance);
+  }
+}
+
+/**
+ * Dijkstra over the queued vertices: settles them in distance order and
+ * relaxes their out-edges until nothing improves.
+ */
+template <typename T>
+void IncrementalShortestPaths<T>::propagate() {
+  while (!queue.empty()) {
+    auto [u, d] = queue.pop();
+    ++lastTouched;
+    for (const auto &arc : graph->outEdges(u)) {
+      improve(arc.vertex, d + arc.weight, u);
+    }
+  }
+}
+
+// Explicit template instantiation
+template class IncrementalShortestPaths<int>;
+template class IncrementalShortestPaths<float>;
+template class IncrementalShortestPaths<double>;
@@ -0,0 +1,49 @@
+#include "../include/SearchWorkspace.hpp"
+
+#include <algorithm>
+
+template <typename T>
+SearchWorkspace<T>::SearchWorkspace() : version(0), queue(0) {}
+
+/**
+ * Starts a new search over a graph with the given number of vertices. The
+ * arrays only grow, so one workspace can serve graphs of different sizes;
+ * stamps left behind by another graph are older than the new version and
+ * read as untouched.
+ *
+ * @param vertices Number of vertices of the graph to search.
+ */
+template <typename T>
+void SearchWorkspace<T>::begin(int vertices) {
+  std::size_t n = static_cast<std::size_t>(vertices);
+  if (entries.size() < n) entries.resize(n, Entry{T(), 0, 0, 0});
+  if (queue.capacity() < vertices) {
+    queue = FourAryHeap<T>(vertices);
+  } else {
+    queue.clear();
+  }
+
+  if (++version == 0) {
+    // The counter wrapped: old stamps could now look current
+    std::fill(entries.begin(), entries.end(), Entry{T(), 0, 0, 0});
+    version = 1;
+  }
+}
+
+/**
+ * Marks a vertex as a target of the current search.
+ *
+ * @param v The target vertex.
+ * @return bool True if v was not marked yet in this search.
+ */
+template <typename T>
+bool SearchWorkspace<T>::markTarget(int v) {
+  if (entries[v].wanted == version) return false;
+  entries[v].wanted = version;
+  return true;
+}
+
+// Explicit template instantiation
+template class SearchWorkspace<int>;
+template class SearchWorkspace<float>;
+template class SearchWorkspace<double>;
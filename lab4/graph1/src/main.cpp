@@ -1,4 +1,10 @@
 // main.cpp
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
@@ -6,7 +12,37 @@
 #include <iostream>
 
 #include "Color.hpp"
+#include "ContractionHierarchy.hpp"
+#include "DynamicGraph.hpp"
 #include "Graph.cpp"
+#include "IncrementalShortestPaths.hpp"
+
+extern char** environ;
+
+/**
+ * Renders a DOT file as PNG with Graphviz. The program is started directly
+ * rather than through a shell, so the paths need no quoting.
+ *
+ * @param dotPath Path of the DOT file to render
+ * @param imgPath Path of the PNG file to create
+ * @return bool True if Graphviz ran and succeeded
+ */
+bool renderPng(const std::string& dotPath, const std::string& imgPath) {
+  std::string program = "dot", format = "-Tpng", output = "-o";
+  std::string input = dotPath, image = imgPath;
+  char* argv[] = {program.data(), format.data(), input.data(),
+                  output.data(),  image.data(),  nullptr};
+
+  pid_t pid;
+  if (posix_spawnp(&pid, "dot", nullptr, nullptr, argv, environ) != 0) {
+    return false;
+  }
+  int status = 0;
+  while (waitpid(pid, &status, 0) == -1) {
+    if (errno != EINTR) return false;
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
 
 /**
  * Generates DOT file and converts it to PNG format
@@ -26,26 +62,26 @@ bool generateGraphVisualization(const Graph<int>& graph,
     std::filesystem::create_directories("outputs/dots");
     std::filesystem::create_directories("outputs/img");
 
-    // Generate DOT file
-    std::string dotRepresentation = graph.toDot();
+    // Stream the DOT file straight to disk
     std::string dotPath = "outputs/dots/" + graphName + ".dot";
     std::string imgPath = "outputs/img/" + graphName + ".png";
 
-    std::ofstream dotFile(dotPath);
-    if (!dotFile.is_open()) {
+    int dotFile = ::open(dotPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (dotFile == -1) {
       std::cerr << Color::RED << "Error: Could not create DOT file: " << dotPath
                 << Color::RESET << std::endl;
       return false;
     }
-
-    dotFile << dotRepresentation;
-    dotFile.close();
+    try {
+      graph.toDot(dotFile);
+    } catch (...) {
+      ::close(dotFile);
+      throw;
+    }
+    ::close(dotFile);
 
     // Convert DOT to PNG
-    std::string command = "dot -Tpng " + dotPath + " -o " + imgPath;
-    int result = system(command.c_str());
-
-    if (result != 0) {
+    if (!renderPng(dotPath, imgPath)) {
       std::cerr << Color::YELLOW
                 << "Warning: Could not generate PNG visualization. "
                 << "Is Graphviz installed?" << Color::RESET << std::endl;
@@ -93,6 +129,127 @@ void printDistances(const std::string& graphName,
   std::cout << std::endl;
 }
 
+/**
+ * Prints the answers to a batch of shortest path queries in a table
+ *
+ * @param graphName Name of the graph being processed
+ * @param queries The (source, target) pairs that were asked
+ * @param answers Distance for each query, in the same order
+ */
+void printQueryAnswers(const std::string& graphName,
+                       const std::vector<PathQuery>& queries,
+                       const std::vector<int>& answers) {
+  std::cout << Color::CYAN << "=== Batch shortest path queries in "
+            << Color::BOLD << graphName << Color::RESET << Color::CYAN
+            << " ===" << Color::RESET << std::endl;
+
+  std::cout << std::setw(10) << "Source" << std::setw(10) << "Target"
+            << std::setw(10) << "Distance" << std::endl;
+  std::cout << std::string(30, '-') << std::endl;
+
+  for (size_t i = 0; i < queries.size(); ++i) {
+    std::cout << std::setw(10) << queries[i].source << std::setw(10)
+              << queries[i].target << std::setw(10);
+    if (answers[i] == std::numeric_limits<int>::max()) {
+      std::cout << Color::RED << "∞" << Color::RESET;
+    } else {
+      std::cout << Color::GREEN << answers[i] << Color::RESET;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+/**
+ * Prints a shortest path with its length
+ *
+ * @param path Vertices of the path from source to target
+ * @param distance Length of the path
+ */
+void printPath(const std::vector<int>& path, int distance) {
+  if (path.empty()) {
+    std::cout << Color::RED << "No path" << Color::RESET << std::endl;
+    return;
+  }
+  std::cout << "Path: " << Color::GREEN;
+  for (size_t i = 0; i < path.size(); ++i) {
+    std::cout << (i > 0 ? " -> " : "") << path[i];
+  }
+  std::cout << Color::RESET << " (distance " << distance << ")" << std::endl;
+}
+
+/**
+ * Prints the vertices of a cycle, closing it back to the first vertex
+ *
+ * @param cycle Vertices of the cycle in edge order
+ */
+void printCycle(const std::vector<int>& cycle) {
+  if (cycle.empty()) return;
+  std::cout << "Cycle: " << Color::RED;
+  for (int vertex : cycle) {
+    std::cout << vertex << " -> ";
+  }
+  std::cout << cycle.front() << Color::RESET << std::endl;
+}
+
+/**
+ * Prints the edges of a minimum spanning forest and its total weight
+ *
+ * @param graphName Name of the graph being processed
+ * @param forest The forest to print
+ */
+void printSpanningForest(const std::string& graphName,
+                         const SpanningForest<int>& forest) {
+  std::cout << Color::CYAN << "=== Minimum spanning forest of " << Color::BOLD
+            << graphName << Color::RESET << Color::CYAN << " ==="
+            << Color::RESET << std::endl;
+
+  std::cout << std::setw(10) << "From" << std::setw(10) << "To"
+            << std::setw(10) << "Weight" << std::endl;
+  std::cout << std::string(30, '-') << std::endl;
+
+  for (const auto& edge : forest.edges) {
+    std::cout << std::setw(10) << edge.from << std::setw(10) << edge.to
+              << std::setw(10) << edge.weight << std::endl;
+  }
+  std::cout << "Total weight: " << Color::GREEN << forest.totalWeight
+            << Color::RESET << std::endl;
+}
+
+/**
+ * Prints the distances between all pairs of vertices, one row per source
+ *
+ * @param graphName Name of the graph being processed
+ * @param distances The distance matrix to print
+ */
+void printDistanceMatrix(const std::string& graphName,
+                         const DistanceMatrix<int>& distances) {
+  std::cout << Color::CYAN << "=== All-pairs distances of " << Color::BOLD
+            << graphName << Color::RESET << Color::CYAN << " ==="
+            << Color::RESET << std::endl;
+
+  std::cout << std::setw(6) << "";
+  for (int to = 0; to < distances.size; ++to) {
+    std::cout << std::setw(6) << to;
+  }
+  std::cout << std::endl;
+  std::cout << std::string(6 * (distances.size + 1), '-') << std::endl;
+
+  for (int from = 0; from < distances.size; ++from) {
+    std::cout << std::setw(6) << from;
+    for (int to = 0; to < distances.size; ++to) {
+      int distance = distances.at(from, to);
+      if (distance == std::numeric_limits<int>::max()) {
+        // "∞" takes three bytes but one column
+        std::cout << Color::RED << std::setw(8) << "∞" << Color::RESET;
+      } else {
+        std::cout << Color::GREEN << std::setw(6) << distance << Color::RESET;
+      }
+    }
+    std::cout << std::endl;
+  }
+}
+
 int main() {
   try {
     // Flag to control visualization generation
@@ -111,6 +268,36 @@ int main() {
       printDistances("dijkstraGraph", distances);
     }
 
+    // Answer several point-to-point queries in one batch
+    std::vector<PathQuery> queries = {{0, 3}, {0, 2}, {1, 2}, {3, 0}};
+    std::vector<int> answers;
+    if (dijkstraGraph.shortestPaths(queries, answers)) {
+      printQueryAnswers("dijkstraGraph", queries, answers);
+    }
+
+    // Preprocess the graph once, then answer point-to-point queries fast
+    auto hierarchy = ContractionHierarchy<int>::build(dijkstraGraph);
+    std::vector<int> path;
+    int pathLength;
+    std::cout << Color::CYAN << "=== Contraction hierarchy query 0 -> 3 ==="
+              << Color::RESET << std::endl;
+    if (hierarchy.query(0, 3, pathLength, path)) {
+      printPath(path, pathLength);
+    }
+
+    // Connect all vertices as cheaply as possible, ignoring directions
+    printSpanningForest("dijkstraGraph", dijkstraGraph.minimumSpanningForest(
+                                             SpanningForestMode::Boruvka));
+
+    // Edit the graph in place and repair the distances incrementally
+    DynamicGraph<int> roads(dijkstraGraph);
+    IncrementalShortestPaths<int> fromZero(roads, 0);
+    std::vector<GraphEdit<int>> batch = {
+        GraphEdit<int>::setEdge(0, 1, 4), GraphEdit<int>::removeEdge(0, 3),
+        GraphEdit<int>::addVertex(), GraphEdit<int>::setEdge(2, 4, 2)};
+    fromZero.update(roads.apply(batch));
+    printDistances("dijkstraGraph after updates", fromZero.distances());
+
     // Test Bellman-Ford algorithm on normal graph
     std::cout << Color::BOLD << Color::MAGENTA
               << "\n[Testing Bellman-Ford Algorithm]" << Color::RESET
@@ -123,6 +310,13 @@ int main() {
       printDistances("bellmanFordGraph", distances);
     }
 
+    // Reweight the negative edges away, then search from every vertex
+    DistanceMatrix<int> allDistances;
+    if (bellmanFordGraph.allPairsShortestPaths(allDistances,
+                                               AllPairsMode::Johnson)) {
+      printDistanceMatrix("bellmanFordGraph", allDistances);
+    }
+
     // Test Bellman-Ford algorithm on graph with negative cycle
     std::cout << Color::BOLD << Color::MAGENTA
               << "\n[Testing Bellman-Ford Algorithm with Negative Cycle]"
@@ -131,10 +325,12 @@ int main() {
     generateGraphVisualization(bellmanFordGraphCycle, "bellmanFordGraphCycle",
                                GENERATE_VISUALS);
 
-    if (!bellmanFordGraphCycle.bellmanFord(0, distances)) {
+    std::vector<int> negativeCycle;
+    if (!bellmanFordGraphCycle.bellmanFord(0, distances, negativeCycle)) {
       std::cout << Color::RED << Color::BOLD
                 << "⚠ Graph contains negative weight cycle!" << Color::RESET
                 << std::endl;
+      printCycle(negativeCycle);
     }
 
   } catch (const std::exception& e) {
@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../include/ContractionHierarchy.hpp"
+#include "../src/Graph.cpp"
+
+/**
+ * Converts one JSON graph into a binary snapshot next to it, then maps the
+ * snapshot back with checksum verification and compares it to the source.
+ * Optionally also preprocesses the graph into a contraction hierarchy file.
+ *
+ * @tparam T The weight type stored in the snapshot.
+ * @param input Path of the JSON file.
+ * @param hierarchy Whether to write a contraction hierarchy as well.
+ * @return bool True if the snapshot was written and verified.
+ */
+template <typename T>
+bool convert(const std::string &input, bool hierarchy) {
+  std::string output =
+      std::filesystem::path(input).replace_extension(".graph").string();
+  try {
+    auto start = std::chrono::steady_clock::now();
+    Graph<T> graph(input);
+    auto parsed = std::chrono::steady_clock::now();
+    graph.save(output);
+
+    auto mapStart = std::chrono::steady_clock::now();
+    Graph<T> snapshot = Graph<T>::load(output);
+    auto mapped = std::chrono::steady_clock::now();
+    Graph<T>::load(output, true);
+
+    if (snapshot.getNumVertices() != graph.getNumVertices() ||
+        snapshot.getNumEdges() != graph.getNumEdges()) {
+      std::cerr << Color::RED << "Snapshot of " << input
+                << " does not match the source" << Color::RESET << "\n";
+      return false;
+    }
+
+    using Ms = std::chrono::duration<double, std::milli>;
+    std::cout << Color::GREEN << input << " -> " << output << Color::RESET
+              << " (" << graph.getNumVertices() << " vertices, "
+              << graph.getNumEdges() << " edges; parse "
+              << Ms(parsed - start).count() << " ms, map "
+              << Ms(mapped - mapStart).count() << " ms)\n";
+
+    if (hierarchy) {
+      std::string chOutput =
+          std::filesystem::path(input).replace_extension(".ch").string();
+      auto buildStart = std::chrono::steady_clock::now();
+      ContractionHierarchy<T>::build(snapshot).save(chOutput);
+      auto built = std::chrono::steady_clock::now();
+      ContractionHierarchy<T>::load(chOutput, true);
+      std::cout << Color::GREEN << input << " -> " << chOutput << Color::RESET
+                << " (build " << Ms(built - buildStart).count() << " ms)\n";
+    }
+    return true;
+  } catch (const std::exception &e) {
+    std::cerr << Color::RED << input << ": " << e.what() << Color::RESET
+              << "\n";
+    return false;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  std::string type = "int";
+  bool hierarchy = false;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--type") == 0 && i + 1 < argc) {
+      type = argv[++i];
+    } else if (std::strcmp(argv[i], "--hierarchy") == 0) {
+      hierarchy = true;
+    } else {
+      inputs.push_back(argv[i]);
+    }
+  }
+  if (inputs.empty() ||
+      (type != "int" && type != "float" && type != "double")) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--type int|float|double] [--hierarchy] input.json...\n";
+    return 1;
+  }
+
+  bool ok = true;
+  for (const auto &input : inputs) {
+    if (type == "int") {
+      ok &= convert<int>(input, hierarchy);
+    } else if (type == "float") {
+      ok &= convert<float>(input, hierarchy);
+    } else {
+      ok &= convert<double>(input, hierarchy);
+    }
+  }
+  return ok ? 0 : 1;
+}
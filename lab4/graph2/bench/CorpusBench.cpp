@@ -0,0 +1,245 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../src/Graph.cpp"
+
+// One algorithm the runner measures
+template <typename T>
+struct Algorithm {
+  std::string name;
+  bool parallel;
+  std::function<void(Graph<T> &)> run;
+};
+
+/**
+ * The algorithms of this lab. The parallel ones run on the shared thread
+ * pool, which has a thread per core.
+ */
+template <typename T>
+std::vector<Algorithm<T>> algorithms() {
+  return {
+      {"topological-sort", false,
+       [](Graph<T> &graph) { graph.topologicalSort(TopoSortMode::Kahn); }},
+      {"parallel-topological-sort", true,
+       [](Graph<T> &graph) {
+         graph.topologicalSort(TopoSortMode::ParallelKahn);
+       }},
+      {"scc-tarjan", false,
+       [](Graph<T> &graph) {
+         std::vector<int> component;
+         graph.stronglyConnectedComponents(component, SccMode::Tarjan);
+       }},
+      {"scc-forward-backward", true,
+       [](Graph<T> &graph) {
+         std::vector<int> component;
+         graph.stronglyConnectedComponents(component,
+                                           SccMode::ForwardBackward);
+       }},
+  };
+}
+
+// What a measuring child process reports back through its pipe
+struct Measurement {
+  long long vertices;
+  long long edges;
+  double loadMs;
+  double runMs;
+  char error[256];
+};
+
+/**
+ * Loads the graph and runs one algorithm on it, in the calling process.
+ * Snapshots are mapped, JSON files parsed.
+ */
+template <typename T>
+Measurement measure(const std::string &file, const Algorithm<T> &algorithm) {
+  using Ms = std::chrono::duration<double, std::milli>;
+  Measurement result{};
+  try {
+    auto start = std::chrono::steady_clock::now();
+    Graph<T> graph(file);
+    auto loaded = std::chrono::steady_clock::now();
+    auto runStart = std::chrono::steady_clock::now();
+    algorithm.run(graph);
+    auto end = std::chrono::steady_clock::now();
+
+    result.vertices = graph.getNumVertices();
+    result.edges = static_cast<long long>(graph.getNumEdges());
+    result.loadMs = Ms(loaded - start).count();
+    result.runMs = Ms(end - runStart).count();
+  } catch (const std::exception &e) {
+    std::strncpy(result.error, e.what(), sizeof(result.error) - 1);
+  }
+  return result;
+}
+
+/**
+ * Measures one algorithm on one graph in a forked child, so that the peak
+ * resident set size the kernel reports for the child belongs to that run
+ * alone: the loaded graph plus everything the algorithm allocated.
+ *
+ * @param peakRssKb Set to the child's peak resident set size in KiB.
+ */
+template <typename T>
+Measurement measureInChild(const std::string &file,
+                           const Algorithm<T> &algorithm, long &peakRssKb) {
+  Measurement result{};
+  int fds[2];
+  if (pipe(fds) != 0) {
+    std::strcpy(result.error, "pipe failed");
+    return result;
+  }
+  pid_t child = fork();
+  if (child == 0) {
+    close(fds[0]);
+    result = measure(file, algorithm);
+    ssize_t written = write(fds[1], &result, sizeof(result));
+    _exit(written == sizeof(result) ? 0 : 1);
+  }
+  close(fds[1]);
+  if (child < 0) {
+    close(fds[0]);
+    std::strcpy(result.error, "fork failed");
+    return result;
+  }
+
+  bool received = read(fds[0], &result, sizeof(result)) == sizeof(result);
+  close(fds[0]);
+  int status = 0;
+  struct rusage usage{};
+  wait4(child, &status, 0, &usage);
+  peakRssKb = usage.ru_maxrss;
+  if (!received) {
+    result = Measurement{};
+    std::strcpy(result.error, "crashed");
+  }
+  return result;
+}
+
+/**
+ * Quotes a CSV field, since error messages may hold commas and quotes.
+ */
+std::string csvQuoted(const std::string &text) {
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"') quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+/**
+ * Runs every algorithm on every graph file and appends one CSV row per
+ * run, writing the header first if the file is new.
+ */
+template <typename T>
+bool runCorpus(const std::vector<std::string> &files, const std::string &csv,
+               const std::string &typeName, unsigned threads,
+               int repetitions) {
+  bool newFile = !std::filesystem::exists(csv) ||
+                 std::filesystem::file_size(csv) == 0;
+  std::ofstream out(csv, std::ios::app);
+  if (!out) {
+    std::cerr << Color::RED << "Could not open " << csv << Color::RESET
+              << "\n";
+    return false;
+  }
+  if (newFile) {
+    out << "graph,type,vertices,edges,algorithm,threads,run,load_ms,time_ms,"
+           "peak_rss_kb,edges_per_sec,status\n";
+  }
+
+  std::cout << std::setw(24) << "Graph" << std::setw(27) << "Algorithm"
+            << std::setw(9) << "Threads" << std::setw(12) << "Time (ms)"
+            << std::setw(13) << "Peak RSS" << std::setw(14) << "Edges/s"
+            << std::endl;
+  std::cout << std::string(99, '-') << std::endl;
+
+  bool ok = true;
+  for (const auto &file : files) {
+    std::string name = std::filesystem::path(file).filename().string();
+    for (const auto &algorithm : algorithms<T>()) {
+      unsigned used = algorithm.parallel ? threads : 1;
+      for (int run = 0; run < repetitions; ++run) {
+        long peakRssKb = 0;
+        Measurement result = measureInChild(file, algorithm, peakRssKb);
+        bool success = result.error[0] == '\0';
+        double edgesPerSecond =
+            success && result.runMs > 0
+                ? static_cast<double>(result.edges) / (result.runMs / 1000)
+                : 0;
+        ok &= success;
+
+        out << name << "," << typeName << "," << result.vertices << ","
+            << result.edges << "," << algorithm.name << "," << used << ","
+            << run << "," << std::fixed << std::setprecision(3)
+            << result.loadMs << "," << result.runMs << "," << peakRssKb
+            << "," << std::setprecision(0) << edgesPerSecond << ","
+            << csvQuoted(success ? "ok" : result.error) << "\n";
+
+        std::cout << std::setw(24) << name << std::setw(27) << algorithm.name
+                  << std::setw(9) << used << std::setw(12) << std::fixed
+                  << std::setprecision(1) << result.runMs << std::setw(10)
+                  << peakRssKb / 1024 << " MB" << std::setw(14)
+                  << std::setprecision(0) << edgesPerSecond << "  "
+                  << (success ? Color::GREEN + "ok"
+                              : Color::RED + result.error)
+                  << Color::RESET << std::endl;
+      }
+    }
+  }
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  std::string type = "int", csv = "corpus/results.csv";
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  int repetitions = 1;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--type") == 0 && hasValue) {
+      type = argv[++i];
+    } else if (std::strcmp(argv[i], "--csv") == 0 && hasValue) {
+      csv = argv[++i];
+    } else if (std::strcmp(argv[i], "--repeat") == 0 && hasValue) {
+      repetitions = std::max(1, std::atoi(argv[++i]));
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+  if (files.empty() ||
+      (type != "int" && type != "float" && type != "double")) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--type int|float|double] [--csv results.csv]"
+                 " [--repeat N] graph...\n";
+    return 1;
+  }
+
+  std::cout << Color::BOLD << Color::MAGENTA << "\n[Benchmark corpus, "
+            << threads << " threads, results appended to " << csv << "]"
+            << Color::RESET << std::endl;
+  bool ok;
+  if (type == "int") {
+    ok = runCorpus<int>(files, csv, type, threads, repetitions);
+  } else if (type == "float") {
+    ok = runCorpus<float>(files, csv, type, threads, repetitions);
+  } else {
+    ok = runCorpus<double>(files, csv, type, threads, repetitions);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+#ifndef DYNAMIC_GRAPH_HPP
+#define DYNAMIC_GRAPH_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "Graph.hpp"
+
+/**
+ * One edit in a batch applied to a DynamicGraph. setEdge inserts the edge
+ * from -> to or replaces its weight; AddVertex ignores the other fields.
+ */
+template <typename T>
+struct GraphEdit {
+  enum class Kind { AddVertex, SetEdge, RemoveEdge };
+
+  Kind kind;
+  int from;
+  int to;
+  T weight;
+
+  static GraphEdit addVertex() { return {Kind::AddVertex, -1, -1, T()}; }
+  static GraphEdit setEdge(int from, int to, T weight) {
+    return {Kind::SetEdge, from, to, weight};
+  }
+  static GraphEdit removeEdge(int from, int to) {
+    return {Kind::RemoveEdge, from, to, T()};
+  }
+};
+
+// Net effect of a batch on one vertex pair, before and after the batch
+template <typename T>
+struct EdgeChange {
+  int from;
+  int to;
+  bool existed;
+  T oldWeight;
+  bool exists;
+  T newWeight;
+};
+
+/**
+ * Mutable adjacency-list graph for workloads where a small fraction of the
+ * edges changes between queries. Each vertex pair carries at most one
+ * edge. Edits are applied in batches; apply() reports the net change per
+ * vertex pair so incremental algorithms can repair their results instead
+ * of recomputing them. toGraph() freezes the current state into a CSR
+ * Graph<T> for the static algorithms.
+ */
+template <typename T>
+class DynamicGraph {
+ public:
+  struct Arc {
+    int vertex;  // head for out-arcs, tail for in-arcs
+    T weight;
+  };
+
+ private:
+  std::vector<std::vector<Arc>> outArcs;
+  std::vector<std::vector<Arc>> inArcs;
+  std::size_t numEdges;
+
+ public:
+  explicit DynamicGraph(int vertices);
+  explicit DynamicGraph(const Graph<T> &graph);
+
+  std::vector<EdgeChange<T>> apply(const std::vector<GraphEdit<T>> &batch);
+  bool findEdge(int from, int to, T &weight) const;
+  Graph<T> toGraph() const;
+
+  int getNumVertices() const { return static_cast<int>(outArcs.size()); }
+  std::size_t getNumEdges() const { return numEdges; }
+  const std::vector<Arc> &outEdges(int v) const { return outArcs[v]; }
+  const std::vector<Arc> &inEdges(int v) const { return inArcs[v]; }
+
+ private:
+  void validate(const std::vector<GraphEdit<T>> &batch) const;
+  bool setEdge(int from, int to, T weight);
+  bool removeEdge(int from, int to);
+};
+
+#endif /* DYNAMIC_GRAPH_HPP */
@@ -5,22 +5,37 @@
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
-// Try multiple possible paths for json.hpp
-#if __has_include(<nlohmann/json.hpp>)
-#include <nlohmann/json.hpp>
-#elif __has_include("../../deps/nlohmann/json.hpp")
-#include "../../deps/nlohmann/json.hpp"
-#else
-#error "Could not find nlohmann/json.hpp. Please run 'make deps' first."
-#endif
+#include "ArrayView.hpp"
+#include "DotWriter.hpp"
+#include "GraphLoader.hpp"
+#include "GraphSnapshot.hpp"
+#include "ThreadPool.hpp"
 
 template <typename T>
 class Graph;
 
+template <typename T>
+class DynamicGraph;
+
+// Kahn: FIFO queue of vertices whose in-degree dropped to zero.
+// ParallelKahn: level-synchronous Kahn over a thread pool with atomic
+// in-degree counters; the order inside each level is unspecified.
+enum class TopoSortMode { Kahn, ParallelKahn };
+
+// Tarjan: one iterative depth-first pass.
+// Kosaraju: iterative depth-first passes over the graph and its reverse.
+// ForwardBackward: trims trivial components, then splits the rest by
+// forward and backward reachability over a thread pool; pieces that get
+// small are finished by Tarjan.
+enum class SccMode { Tarjan, Kosaraju, ForwardBackward };
+
 template <typename T>
 std::ostream &operator<<(std::ostream &os, const Graph<T> &graph);
 
@@ -28,29 +43,73 @@ template <typename T>
 class Graph {
  private:
   struct Edge {
+    int from;
     int to;
     T weight;
   };
 
-  std::vector<std::vector<Edge>> adjList;
+  // Builder phase: edges collected by addEdge until finalize() is called
+  std::vector<Edge> pendingEdges;
+
+  // Frozen CSR layout: the out-edges of vertex v are the entries
+  // [offsets[v], offsets[v + 1]) of targets and weights. The views point
+  // either into the storage vectors below or into a mapped snapshot file.
+  ArrayView<std::size_t> offsets;
+  ArrayView<int> targets;
+  ArrayView<T> weights;
+  std::vector<std::size_t> offsetStorage;
+  std::vector<int> targetStorage;
+  std::vector<T> weightStorage;
+  std::shared_ptr<const MappedFile> snapshot;
   int numVertices;
+  bool finalized;
+
+  Graph();
 
  public:
   explicit Graph(const std::string &filename);
+  explicit Graph(int vertices);
+  Graph(const Graph &other);
+  Graph(Graph &&other) noexcept = default;
+  Graph &operator=(const Graph &other);
+  Graph &operator=(Graph &&other) noexcept = default;
   void addEdge(int from, int to, T weight);
+  void finalize();
+  bool isFinalized() const { return finalized; }
   friend std::ostream &operator<<<>(std::ostream &os, const Graph &graph);
+  friend class DynamicGraph<T>;
   void readGraphFromFile(const std::string &filename);
-  std::string toDot() const;
-  bool topologicalSort();
-  bool isDAG();
+  void save(const std::string &filename) const;
+  static Graph load(const std::string &filename, bool verifyChecksum = false);
+  void toDot(std::ostream &os, const DotOptions &options = DotOptions()) const;
+  void toDot(int fd, const DotOptions &options = DotOptions()) const;
+  int getNumVertices() const { return numVertices; }
+  std::size_t getNumEdges() const { return targets.size(); }
+  std::optional<std::vector<int>> topologicalSort(
+      TopoSortMode mode = TopoSortMode::Kahn) const;
+  std::optional<std::vector<int>> topologicalSort(
+      std::vector<int> &cycle, TopoSortMode mode = TopoSortMode::Kahn) const;
+  bool isDAG() const;
+  int stronglyConnectedComponents(std::vector<int> &component,
+                                  SccMode mode = SccMode::Tarjan) const;
+  Graph condensation(const std::vector<int> &component) const;
 
  private:
   void readGraphFromJson(const std::string &filename);
-  bool topologicalSortUtil(int v, std::vector<bool> &visited,
-                           std::vector<int> &result,
-                           std::vector<bool> &recStack);
-  bool isDAGUtil(int v, std::vector<bool> &visited,
-                 std::vector<bool> &recStack);
+  void readGraphFromSnapshot(const std::string &filename, bool verifyChecksum);
+  void bindStorage();
+  void requireFinalized() const;
+  void writeDot(DotWriter &dot, const DotOptions &options) const;
+  std::vector<int> kahnOrder() const;
+  std::vector<int> parallelKahnOrder() const;
+  void findCycle(const std::vector<int> &sorted, std::vector<int> &cycle) const;
+  void reverseEdges(std::vector<std::size_t> &inOffsets,
+                    std::vector<int> &sources) const;
+  int tarjanComponents(std::vector<int> &component, int next,
+                       const std::vector<int> *part) const;
+  int kosarajuComponents(std::vector<int> &component) const;
+  int forwardBackwardComponents(std::vector<int> &component) const;
+  void orderComponents(std::vector<int> &component, int count) const;
 };
 
 #endif /* GRAPH_HPP */
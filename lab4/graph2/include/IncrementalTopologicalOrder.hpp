@@ -0,0 +1,63 @@
+#ifndef INCREMENTAL_TOPOLOGICAL_ORDER_HPP
+#define INCREMENTAL_TOPOLOGICAL_ORDER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+#include "DynamicGraph.hpp"
+
+/**
+ * Topological order of a DynamicGraph kept up to date across edit batches
+ * with the Pearce-Kelly algorithm. An inserted edge x -> y that already
+ * agrees with the order costs nothing; otherwise only the vertices placed
+ * between y and x are searched and shuffled. Removed edges never break
+ * an order, so they are free as well.
+ *
+ * Once an insertion closes a cycle there is no order to maintain. Later
+ * insertions cannot break the cycle, but a batch that removes edges
+ * triggers a full Kahn pass to find out whether the graph became acyclic.
+ *
+ * The graph must outlive this object, and every batch applied to it must
+ * be passed to update() before the order is read again.
+ */
+template <typename T>
+class IncrementalTopologicalOrder {
+ private:
+  const DynamicGraph<T> *graph;
+  std::vector<int> order;     // index -> vertex
+  std::vector<int> position;  // vertex -> index
+  bool acyclic;
+
+  // Scratch state for the searches of one insertion
+  std::vector<std::uint32_t> visited;
+  std::uint32_t version;
+  std::vector<int> forward;
+  std::vector<int> backward;
+  std::vector<int> stack;
+  std::unordered_set<std::uint64_t> pending;  // batch edges not inserted yet
+
+ public:
+  explicit IncrementalTopologicalOrder(const DynamicGraph<T> &graph);
+
+  void update(const std::vector<EdgeChange<T>> &changes);
+
+  bool isDAG() const { return acyclic; }
+  std::optional<std::vector<int>> topologicalSort() const;
+  int positionOf(int v) const { return position[v]; }
+
+ private:
+  void grow();
+  void rebuild();
+  bool insertEdge(int from, int to);
+  bool search(int start, int stop, int bound, bool forwardSearch);
+  bool isPending(int from, int to) const;
+
+  static std::uint64_t key(int from, int to) {
+    return (static_cast<std::uint64_t>(from) << 32) |
+           static_cast<std::uint32_t>(to);
+  }
+};
+
+#endif /* INCREMENTAL_TOPOLOGICAL_ORDER_HPP */
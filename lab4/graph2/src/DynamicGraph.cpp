@@ -0,0 +1,220 @@
+#include "../include/DynamicGraph.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Creates a graph with the given number of vertices and no edges.
+ *
+ * @param vertices Number of vertices
+ */
+template <typename T>
+DynamicGraph<T>::DynamicGraph(int vertices) : numEdges(0) {
+  if (vertices < 0) {
+    throw std::invalid_argument("Number of vertices must be non-negative");
+  }
+  outArcs.resize(vertices);
+  inArcs.resize(vertices);
+}
+
+/**
+ * Copies a finalized graph. Parallel edges collapse into the lightest one,
+ * which is the only one a shortest path can use.
+ *
+ * @param graph The graph to copy
+ */
+template <typename T>
+DynamicGraph<T>::DynamicGraph(const Graph<T> &graph)
+    : DynamicGraph(graph.getNumVertices()) {
+  graph.requireFinalized();
+
+  // slot[v]: index of the arc u -> v in outArcs[u], valid if owner[v] == u
+  std::vector<std::size_t> slot(graph.numVertices);
+  std::vector<int> owner(graph.numVertices, -1);
+  for (int u = 0; u < graph.numVertices; ++u) {
+    outArcs[u].reserve(graph.offsets[u + 1] - graph.offsets[u]);
+    for (std::size_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+      int v = graph.targets[e];
+      T weight = graph.weights[e];
+      if (owner[v] == u) {
+        Arc &arc = outArcs[u][slot[v]];
+        if (weight < arc.weight) arc.weight = weight;
+        continue;
+      }
+      owner[v] = u;
+      slot[v] = outArcs[u].size();
+      outArcs[u].push_back({v, weight});
+    }
+    numEdges += outArcs[u].size();
+  }
+  for (int u = 0; u < graph.numVertices; ++u) {
+    for (const Arc &arc : outArcs[u]) {
+      inArcs[arc.vertex].push_back({u, arc.weight});
+    }
+  }
+}
+
+/**
+ * Applies a batch of edits in order. The whole batch is checked before
+ * anything changes, so an invalid edit leaves the graph untouched.
+ * Removing an edge that does not exist is a no-op.
+ *
+ * @param batch The edits to apply
+ * @return std::vector<EdgeChange<T>> One entry per vertex pair whose edge
+ * differs after the batch, in order of first edit
+ * @throws std::out_of_range If an edit names a vertex that does not exist
+ * at that point of the batch
+ */
+template <typename T>
+std::vector<EdgeChange<T>> DynamicGraph<T>::apply(
+    const std::vector<GraphEdit<T>> &batch) {
+  validate(batch);
+
+  std::vector<EdgeChange<T>> changes;
+  std::unordered_map<std::uint64_t, std::size_t> seen;
+  for (const GraphEdit<T> &edit : batch) {
+    if (edit.kind == GraphEdit<T>::Kind::AddVertex) {
+      outArcs.emplace_back();
+      inArcs.emplace_back();
+      continue;
+    }
+
+    std::uint64_t key = (static_cast<std::uint64_t>(edit.from) << 32) |
+                        static_cast<std::uint32_t>(edit.to);
+    if (seen.emplace(key, changes.size()).second) {
+      EdgeChange<T> change{edit.from, edit.to, false, T(), false, T()};
+      change.existed = findEdge(edit.from, edit.to, change.oldWeight);
+      changes.push_back(change);
+    }
+    if (edit.kind == GraphEdit<T>::Kind::SetEdge) {
+      setEdge(edit.from, edit.to, edit.weight);
+    } else {
+      removeEdge(edit.from, edit.to);
+    }
+  }
+
+  // Keep only the pairs whose edge ended up different
+  std::size_t kept = 0;
+  for (EdgeChange<T> &change : changes) {
+    change.exists = findEdge(change.from, change.to, change.newWeight);
+    bool same = change.existed == change.exists &&
+                (!change.exists || change.oldWeight == change.newWeight);
+    if (!same) changes[kept++] = change;
+  }
+  changes.resize(kept);
+  return changes;
+}
+
+/**
+ * Looks up the edge from -> to.
+ *
+ * @param from Tail of the edge
+ * @param to Head of the edge
+ * @param weight Output: the weight of the edge if it exists
+ * @return bool True if the edge exists
+ */
+template <typename T>
+bool DynamicGraph<T>::findEdge(int from, int to, T &weight) const {
+  for (const Arc &arc : outArcs[from]) {
+    if (arc.vertex == to) {
+      weight = arc.weight;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Freezes the current edges into a finalized CSR graph.
+ *
+ * @return Graph<T> A static copy of the graph
+ */
+template <typename T>
+Graph<T> DynamicGraph<T>::toGraph() const {
+  Graph<T> graph(getNumVertices());
+  for (int u = 0; u < getNumVertices(); ++u) {
+    for (const Arc &arc : outArcs[u]) graph.addEdge(u, arc.vertex, arc.weight);
+  }
+  graph.finalize();
+  return graph;
+}
+
+/**
+ * Checks every edit of a batch against the number of vertices the graph
+ * will have when the edit is reached.
+ *
+ * @param batch The edits to check
+ * @throws std::out_of_range If an edit names a vertex that does not exist
+ */
+template <typename T>
+void DynamicGraph<T>::validate(const std::vector<GraphEdit<T>> &batch) const {
+  int vertices = getNumVertices();
+  for (const GraphEdit<T> &edit : batch) {
+    if (edit.kind == GraphEdit<T>::Kind::AddVertex) {
+      ++vertices;
+    } else if (edit.from < 0 || edit.from >= vertices || edit.to < 0 ||
+               edit.to >= vertices) {
+      throw std::out_of_range("Edge (" + std::to_string(edit.from) + ", " +
+                              std::to_string(edit.to) +
+                              ") names a vertex that does not exist");
+    }
+  }
+}
+
+/**
+ * Inserts the edge from -> to or replaces its weight.
+ *
+ * @param from Tail of the edge
+ * @param to Head of the edge
+ * @param weight New weight of the edge
+ * @return bool True if the edge was inserted
+ */
+template <typename T>
+bool DynamicGraph<T>::setEdge(int from, int to, T weight) {
+  for (Arc &arc : outArcs[from]) {
+    if (arc.vertex == to) {
+      arc.weight = weight;
+      for (Arc &back : inArcs[to]) {
+        if (back.vertex == from) back.weight = weight;
+      }
+      return false;
+    }
+  }
+  outArcs[from].push_back({to, weight});
+  inArcs[to].push_back({from, weight});
+  ++numEdges;
+  return true;
+}
+
+/**
+ * Removes the edge from -> to. Arcs are unordered, so the last arc of each
+ * list takes the place of the removed one.
+ *
+ * @param from Tail of the edge
+ * @param to Head of the edge
+ * @return bool True if the edge existed
+ */
+template <typename T>
+bool DynamicGraph<T>::removeEdge(int from, int to) {
+  auto erase = [](std::vector<Arc> &arcs, int vertex) {
+    for (std::size_t i = 0; i < arcs.size(); ++i) {
+      if (arcs[i].vertex == vertex) {
+        arcs[i] = arcs.back();
+        arcs.pop_back();
+        return true;
+      }
+    }
+    return false;
+  };
+  if (!erase(outArcs[from], to)) return false;
+  erase(inArcs[to], from);
+  --numEdges;
+  return true;
+}
+
+// Explicit template instantiation
+template class DynamicGraph<int>;
+template class DynamicGraph<float>;
+template class DynamicGraph<double>;
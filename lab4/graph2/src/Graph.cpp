@@ -1,22 +1,55 @@
 #include "Graph.hpp"
 
-// Try multiple possible paths for json.hpp
-#if __has_include(<nlohmann/json.hpp>)
-#include <nlohmann/json.hpp>
-#elif __has_include("../../deps/nlohmann/json.hpp")
-#include "../../deps/nlohmann/json.hpp"
-#endif
-
 /**
- * The Graph constructor reads a graph from a file.
+ * The Graph constructor reads a graph from a file, either JSON or a binary
+ * snapshot written by save().
  *
  * @param filename The filename parameter is a string that
  * represents the name of the file from which the graph
  * data will be read.
  */
 template <typename T>
-Graph<T>::Graph(const std::string &filename) {
-  readGraphFromJson(filename);
+Graph<T>::Graph(const std::string &filename)
+    : numVertices(0), finalized(false) {
+  readGraphFromFile(filename);
+}
+
+/**
+ * The Graph constructor creates an empty graph with a fixed number of
+ * vertices, to be filled with addEdge and then finalized.
+ *
+ * @param vertices The number of vertices in the graph.
+ */
+template <typename T>
+Graph<T>::Graph(int vertices) : numVertices(vertices), finalized(false) {}
+
+template <typename T>
+Graph<T>::Graph() : numVertices(0), finalized(false) {}
+
+template <typename T>
+Graph<T>::Graph(const Graph &other) : numVertices(0), finalized(false) {
+  *this = other;
+}
+
+/**
+ * Copies the graph. A graph built in memory gets its own arrays and rebinds
+ * its views to them; a snapshot-backed graph shares the read-only mapping.
+ */
+template <typename T>
+Graph<T> &Graph<T>::operator=(const Graph &other) {
+  if (this == &other) return *this;
+  pendingEdges = other.pendingEdges;
+  offsetStorage = other.offsetStorage;
+  targetStorage = other.targetStorage;
+  weightStorage = other.weightStorage;
+  snapshot = other.snapshot;
+  numVertices = other.numVertices;
+  finalized = other.finalized;
+  offsets = other.offsets;
+  targets = other.targets;
+  weights = other.weights;
+  if (!snapshot) bindStorage();
+  return *this;
 }
 
 /**
@@ -33,7 +66,147 @@ Graph<T>::Graph(const std::string &filename) {
  */
 template <typename T>
 void Graph<T>::addEdge(int from, int to, T weight) {
-  adjList[from].push_back({to, weight});
+  if (finalized) {
+    throw std::logic_error("Cannot add edges to a finalized graph");
+  }
+  if (from < 0 || from >= numVertices || to < 0 || to >= numVertices) {
+    throw std::out_of_range("Edge endpoint out of range");
+  }
+  pendingEdges.push_back({from, to, weight});
+}
+
+/**
+ * The function freezes the graph into compressed sparse row form. Edges are
+ * bucketed by source with a counting sort, so every vertex keeps its edges
+ * in insertion order, and the builder buffer is released afterwards.
+ * Calling it again is a no-op.
+ */
+template <typename T>
+void Graph<T>::finalize() {
+  if (finalized) return;
+
+  offsetStorage.assign(numVertices + 1, 0);
+  for (const auto &edge : pendingEdges) {
+    ++offsetStorage[edge.from + 1];
+  }
+  for (int v = 0; v < numVertices; ++v) {
+    offsetStorage[v + 1] += offsetStorage[v];
+  }
+
+  targetStorage.resize(pendingEdges.size());
+  weightStorage.resize(pendingEdges.size());
+  std::vector<std::size_t> next(offsetStorage.begin(), offsetStorage.end() - 1);
+  for (const auto &edge : pendingEdges) {
+    std::size_t slot = next[edge.from]++;
+    targetStorage[slot] = edge.to;
+    weightStorage[slot] = edge.weight;
+  }
+
+  std::vector<Edge>().swap(pendingEdges);
+  bindStorage();
+  finalized = true;
+}
+
+/**
+ * Points the CSR views at the storage vectors owned by this graph.
+ */
+template <typename T>
+void Graph<T>::bindStorage() {
+  offsets = ArrayView<std::size_t>(offsetStorage.data(), offsetStorage.size());
+  targets = ArrayView<int>(targetStorage.data(), targetStorage.size());
+  weights = ArrayView<T>(weightStorage.data(), weightStorage.size());
+}
+
+/**
+ * Writes the finalized graph as a binary snapshot (see GraphSnapshot.hpp),
+ * which load() and the filename constructor can map back without parsing.
+ *
+ * @param filename Path of the snapshot file to create or overwrite.
+ */
+template <typename T>
+void Graph<T>::save(const std::string &filename) const {
+  static_assert(sizeof(std::size_t) == sizeof(std::uint64_t),
+                "Snapshot offsets are stored as 64-bit integers");
+  requireFinalized();
+  GraphSnapshot::write(
+      filename, {GraphSnapshot::weightTypeOf<T>(),
+                 static_cast<std::uint64_t>(numVertices), targets.size(),
+                 offsets.data(), targets.data(), weights.data(), sizeof(T)});
+}
+
+/**
+ * Opens a binary snapshot written by save(). The file is memory-mapped and
+ * the graph answers queries straight from the mapped pages, without copying
+ * them; loading only reads the offsets and targets once to check them.
+ *
+ * @param filename Path of the snapshot file.
+ * @param verifyChecksum Whether to hash the whole file before using it.
+ * @return Graph The finalized, read-only graph.
+ */
+template <typename T>
+Graph<T> Graph<T>::load(const std::string &filename, bool verifyChecksum) {
+  Graph graph;
+  graph.readGraphFromSnapshot(filename, verifyChecksum);
+  return graph;
+}
+
+/**
+ * The function reads a graph from a file, picking the format from its first
+ * bytes: binary snapshots are mapped, anything else is parsed as JSON.
+ *
+ * @param filename The filename parameter is a string that represents the name
+ * of the file from which the graph data will be read.
+ */
+template <typename T>
+void Graph<T>::readGraphFromFile(const std::string &filename) {
+  if (GraphSnapshot::isSnapshot(filename)) {
+    readGraphFromSnapshot(filename, false);
+  } else {
+    readGraphFromJson(filename);
+  }
+}
+
+/**
+ * Maps a snapshot and binds the CSR views to the arrays inside it.
+ *
+ * @param filename Path of the snapshot file.
+ * @param verifyChecksum Whether to hash the whole file before using it.
+ */
+template <typename T>
+void Graph<T>::readGraphFromSnapshot(const std::string &filename,
+                                     bool verifyChecksum) {
+  auto file = std::make_shared<const MappedFile>(filename, false);
+  const GraphSnapshot::Header &header = GraphSnapshot::validate(
+      *file, GraphSnapshot::weightTypeOf<T>(), verifyChecksum);
+  const char *base = file->data();
+
+  numVertices = static_cast<int>(header.numVertices);
+  offsets = ArrayView<std::size_t>(
+      reinterpret_cast<const std::size_t *>(base + header.offsetsStart),
+      header.numVertices + 1);
+  targets = ArrayView<int>(
+      reinterpret_cast<const int *>(base + header.targetsStart),
+      header.numEdges);
+  weights = ArrayView<T>(reinterpret_cast<const T *>(base + header.weightsStart),
+                         header.numEdges);
+
+  std::vector<Edge>().swap(pendingEdges);
+  offsetStorage.clear();
+  targetStorage.clear();
+  weightStorage.clear();
+  snapshot = std::move(file);
+  finalized = true;
+}
+
+/**
+ * Throws if the graph is still in its builder phase; every query runs on
+ * the CSR arrays.
+ */
+template <typename T>
+void Graph<T>::requireFinalized() const {
+  if (!finalized) {
+    throw std::logic_error("Graph must be finalized before it is queried");
+  }
 }
 
 /**
@@ -44,13 +217,15 @@ void Graph<T>::addEdge(int from, int to, T weight) {
  */
 template <typename T>
 std::ostream &operator<<(std::ostream &os, const Graph<T> &graph) {
+  graph.requireFinalized();
   os << "Graph Representation (Adjacency List):\n";
   for (int i = 0; i < graph.numVertices; ++i) {
     os << "Vertex " << i << " connects to: ";
-    for (const auto &edge : graph.adjList[i]) {
-      os << "[Vertex " << edge.to << " with weight " << edge.weight << "] ";
+    for (std::size_t e = graph.offsets[i]; e < graph.offsets[i + 1]; ++e) {
+      os << "[Vertex " << graph.targets[e] << " with weight "
+         << graph.weights[e] << "] ";
     }
-    if (graph.adjList[i].empty()) {
+    if (graph.offsets[i] == graph.offsets[i + 1]) {
       os << "No connections";
     }
     os << "\n";
@@ -60,109 +235,782 @@ std::ostream &operator<<(std::ostream &os, const Graph<T> &graph) {
 
 /**
  * The function reads a graph from a file and populates the adjacency list with
- * the graph data.
+ * the graph data. The file is memory-mapped and parsed in a single streaming
+ * pass; edges are written straight into the pre-reserved builder buffer, so
+ * no JSON document tree is ever materialised.
  *
  * @param filename The filename parameter is a string that represents the name
  * of the file from which the graph data will be read.
  */
 template <typename T>
 void Graph<T>::readGraphFromJson(const std::string &filename) {
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    throw std::runtime_error("Could not open file: " + filename);
-  }
+  MappedFile file(filename);
+  GraphJsonReader reader(file.data(), file.size());
+  pendingEdges.reserve(reader.estimateEdges());
 
-  nlohmann::json json;
-  file >> json;
+  // "vertices" may come after "edges", so endpoints are checked at the end
+  reader.parse([&](int vertices) { numVertices = vertices; },
+               [&](const GraphJsonReader::EdgeRecord &edge) {
+                 pendingEdges.push_back(
+                     {edge.from, edge.to, static_cast<T>(edge.weight)});
+               });
 
-  numVertices = json["vertices"];
-  adjList.resize(numVertices);
-
-  for (const auto &edge : json["edges"]) {
-    int from = edge["from"];
-    int to = edge["to"];
-    T weight = edge["weight"];
-    addEdge(from, to, weight);
+  for (const auto &edge : pendingEdges) {
+    if (edge.from < 0 || edge.from >= numVertices || edge.to < 0 ||
+        edge.to >= numVertices) {
+      throw std::out_of_range("Edge endpoint out of range in " + filename);
+    }
   }
+  finalize();
+}
+
+/**
+ * Writes the graph in Graphviz DOT format to a stream. The text goes out
+ * through a fixed-size buffer, so memory use does not grow with the graph.
+ *
+ * @param os Stream that receives the DOT text.
+ * @param options Edge sampling, edge cap and clusters.
+ */
+template <typename T>
+void Graph<T>::toDot(std::ostream &os, const DotOptions &options) const {
+  DotWriter dot(os);
+  writeDot(dot, options);
+}
+
+/**
+ * Writes the graph in Graphviz DOT format to a file descriptor, bypassing
+ * iostreams entirely.
+ *
+ * @param fd Descriptor opened for writing; it is not closed.
+ * @param options Edge sampling, edge cap and clusters.
+ */
+template <typename T>
+void Graph<T>::toDot(int fd, const DotOptions &options) const {
+  DotWriter dot(fd);
+  writeDot(dot, options);
 }
 
+/**
+ * Emits the cluster blocks, if any, followed by the sampled and capped
+ * edges in CSR order.
+ */
 template <typename T>
-std::string Graph<T>::toDot() const {
-  std::ostringstream dot;
+void Graph<T>::writeDot(DotWriter &dot, const DotOptions &options) const {
+  requireFinalized();
+  const std::vector<int> *clusters = options.clusters;
+  if (clusters != nullptr &&
+      clusters->size() != static_cast<std::size_t>(numVertices)) {
+    throw std::invalid_argument("DOT clusters need one entry per vertex");
+  }
+
   dot << "digraph G {\n";  // Use "digraph" for directed graphs
-  for (int i = 0; i < numVertices; ++i) {
-    for (const auto &edge : adjList[i]) {
-      dot << "  " << i << " -> " << edge.to << " [label=" << edge.weight
+
+  if (clusters != nullptr) {
+    // Group the clustered vertices; this index is the only per-vertex
+    // memory the export needs
+    std::vector<int> members;
+    for (int v = 0; v < numVertices; ++v) {
+      if ((*clusters)[v] >= 0) members.push_back(v);
+    }
+    std::stable_sort(members.begin(), members.end(), [&](int a, int b) {
+      return (*clusters)[a] < (*clusters)[b];
+    });
+    for (std::size_t i = 0; i < members.size(); ++i) {
+      int id = (*clusters)[members[i]];
+      if (i == 0 || (*clusters)[members[i - 1]] != id) {
+        dot << "  subgraph cluster_" << id << " {\n    label=\"" << id
+            << "\";\n";
+      }
+      dot << "    " << members[i] << ";\n";
+      if (i + 1 == members.size() || (*clusters)[members[i + 1]] != id) {
+        dot << "  }\n";
+      }
+    }
+  }
+
+  std::size_t limit = options.maxEdges == 0
+                          ? std::numeric_limits<std::size_t>::max()
+                          : options.maxEdges;
+  std::size_t written = 0;
+  for (int i = 0; i < numVertices && written < limit; ++i) {
+    for (std::size_t e = offsets[i]; e < offsets[i + 1] && written < limit;
+         ++e) {
+      if (!DotWriter::keepEdge(options, e)) continue;
+      dot << "  " << i << " -> " << targets[e] << " [label=" << weights[e]
           << "];\n";
+      ++written;
     }
   }
   dot << "}\n";
-  return dot.str();
+  dot.flush();
 }
 
+/**
+ * Sorts the vertices so that every edge points forward. Both modes finish
+ * in a single O(V + E) pass and use no recursion, so arbitrarily long
+ * chains are fine.
+ *
+ * @tparam T The type of the graph's weights
+ * @param mode Sequential or parallel level-synchronous Kahn
+ * @return std::optional<std::vector<int>> The order, or std::nullopt if the
+ * graph has a cycle
+ */
 template <typename T>
-bool Graph<T>::topologicalSortUtil(int v, std::vector<bool> &visited,
-                                   std::vector<int> &result,
-                                   std::vector<bool> &recStack) {
-  visited[v] = true;
-  recStack[v] = true;
+std::optional<std::vector<int>> Graph<T>::topologicalSort(
+    TopoSortMode mode) const {
+  requireFinalized();
+  std::vector<int> order =
+      mode == TopoSortMode::ParallelKahn ? parallelKahnOrder() : kahnOrder();
+  if (order.size() != static_cast<std::size_t>(numVertices)) {
+    return std::nullopt;
+  }
+  return order;
+}
 
-  for (const auto &edge : adjList[v]) {
-    if (!visited[edge.to] &&
-        topologicalSortUtil(edge.to, visited, result, recStack))
-      return true;
-    else if (recStack[edge.to])
-      return true;
+/**
+ * Same as topologicalSort(mode), but also reports a cycle when the sort
+ * fails. Only the vertices Kahn's algorithm could not place are searched.
+ *
+ * @tparam T The type of the graph's weights
+ * @param cycle Output: the vertices of a cycle in edge order, the last one
+ * leading back to the first; empty if the graph is acyclic
+ * @param mode Sequential or parallel level-synchronous Kahn
+ * @return std::optional<std::vector<int>> The order, or std::nullopt if the
+ * graph has a cycle
+ */
+template <typename T>
+std::optional<std::vector<int>> Graph<T>::topologicalSort(
+    std::vector<int> &cycle, TopoSortMode mode) const {
+  requireFinalized();
+  cycle.clear();
+  std::vector<int> order =
+      mode == TopoSortMode::ParallelKahn ? parallelKahnOrder() : kahnOrder();
+  if (order.size() != static_cast<std::size_t>(numVertices)) {
+    findCycle(order, cycle);
+    return std::nullopt;
   }
+  return order;
+}
 
-  recStack[v] = false;
-  result.push_back(v);
-  return false;
+/**
+ * Checks whether the graph is a directed acyclic graph.
+ *
+ * @tparam T The type of the graph's weights
+ * @return bool True if the graph has no directed cycle
+ */
+template <typename T>
+bool Graph<T>::isDAG() const {
+  return topologicalSort().has_value();
 }
 
+/**
+ * Kahn's algorithm. The result vector doubles as the FIFO queue: vertices
+ * are appended once their in-degree reaches zero and processed in turn.
+ *
+ * @return std::vector<int> The sorted prefix; shorter than numVertices if
+ * the remaining vertices lie on or behind a cycle
+ */
+template <typename T>
+std::vector<int> Graph<T>::kahnOrder() const {
+  std::vector<int> indegree(numVertices, 0);
+  for (int to : targets) ++indegree[to];
+
+  std::vector<int> order;
+  order.reserve(numVertices);
+  for (int v = 0; v < numVertices; v++) {
+    if (indegree[v] == 0) order.push_back(v);
+  }
+  for (std::size_t i = 0; i < order.size(); i++) {
+    int u = order[i];
+    for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+      if (--indegree[targets[e]] == 0) order.push_back(targets[e]);
+    }
+  }
+  return order;
+}
+
+/**
+ * Level-synchronous Kahn's algorithm. Each level is the set of vertices
+ * whose last predecessor was in the previous level; the threads share the
+ * level, decrement in-degrees atomically and collect newly ready vertices
+ * in per-thread buffers that are appended after the level.
+ *
+ * @return std::vector<int> The sorted prefix, as for kahnOrder
+ */
 template <typename T>
-bool Graph<T>::topologicalSort() {
-  std::vector<int> result;
-  std::vector<bool> visited(numVertices, false);
-  std::vector<bool> recStack(numVertices, false);
+std::vector<int> Graph<T>::parallelKahnOrder() const {
+  const std::size_t grain = 1024;
+  ThreadPool &pool = ThreadPool::shared();
+  std::size_t n = static_cast<std::size_t>(numVertices);
+
+  std::unique_ptr<std::atomic<int>[]> indegree(new std::atomic<int>[n]);
+  pool.parallelFor(0, n, grain, [&](std::size_t lo, std::size_t hi, unsigned) {
+    for (std::size_t v = lo; v < hi; ++v) indegree[v] = 0;
+  });
+  pool.parallelFor(0, n, grain, [&](std::size_t lo, std::size_t hi, unsigned) {
+    for (std::size_t e = offsets[lo]; e < offsets[hi]; ++e) {
+      indegree[targets[e]].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
 
-  for (int i = 0; i < numVertices; i++)
-    if (!visited[i])
-      if (topologicalSortUtil(i, visited, result, recStack)) return false;
+  std::vector<int> order;
+  order.reserve(n);
+  std::vector<std::vector<int>> ready(pool.size());
+  auto appendReady = [&]() {
+    for (auto &local : ready) {
+      order.insert(order.end(), local.begin(), local.end());
+      local.clear();
+    }
+  };
+
+  pool.parallelFor(
+      0, n, grain, [&](std::size_t lo, std::size_t hi, unsigned worker) {
+        for (std::size_t v = lo; v < hi; ++v) {
+          if (indegree[v].load(std::memory_order_relaxed) == 0) {
+            ready[worker].push_back(static_cast<int>(v));
+          }
+        }
+      });
+  appendReady();
+
+  for (std::size_t levelBegin = 0; levelBegin < order.size();) {
+    std::size_t levelEnd = order.size();
+    pool.parallelFor(
+        levelBegin, levelEnd, grain / 4,
+        [&](std::size_t lo, std::size_t hi, unsigned worker) {
+          for (std::size_t i = lo; i < hi; ++i) {
+            int u = order[i];
+            for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+              int v = targets[e];
+              if (indegree[v].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                ready[worker].push_back(v);
+              }
+            }
+          }
+        });
+    appendReady();
+    levelBegin = levelEnd;
+  }
+  return order;
+}
+
+/**
+ * Finds a cycle among the vertices a Kahn pass left unsorted, with an
+ * iterative depth-first search: every such vertex has a predecessor that
+ * is unsorted too, so the search is bound to meet a back edge.
+ *
+ * @param sorted The vertices Kahn's algorithm did place
+ * @param cycle Output: the vertices of the cycle in edge order
+ */
+template <typename T>
+void Graph<T>::findCycle(const std::vector<int> &sorted,
+                         std::vector<int> &cycle) const {
+  enum : char { UNVISITED, ON_STACK, DONE };
+  std::vector<char> state(numVertices, UNVISITED);
+  for (int v : sorted) state[v] = DONE;
+
+  // (vertex, next edge to follow) pairs along the current path
+  std::vector<std::pair<int, std::size_t>> path;
+  for (int start = 0; start < numVertices; start++) {
+    if (state[start] != UNVISITED) continue;
+    path.push_back({start, offsets[start]});
+    state[start] = ON_STACK;
+
+    while (!path.empty()) {
+      int u = path.back().first;
+      std::size_t e = path.back().second++;
+      if (e == offsets[u + 1]) {
+        state[u] = DONE;
+        path.pop_back();
+        continue;
+      }
+      int v = targets[e];
+      if (state[v] == ON_STACK) {
+        auto first =
+            std::find_if(path.begin(), path.end(),
+                         [v](const auto &step) { return step.first == v; });
+        for (auto it = first; it != path.end(); ++it) {
+          cycle.push_back(it->first);
+        }
+        return;
+      }
+      if (state[v] == UNVISITED) {
+        state[v] = ON_STACK;
+        path.push_back({v, offsets[v]});
+      }
+    }
+  }
+}
 
-  for (auto it = result.rbegin(); it != result.rend(); ++it) {
-    std::cout << *it << " ";
+/**
+ * Splits the graph into strongly connected components. Component ids
+ * follow a topological order of the condensation: every edge u -> v has
+ * component[u] <= component[v], so scheduling the components by id
+ * respects every dependency between them.
+ *
+ * @tparam T The type of the graph's weights
+ * @param component Output: the component id of every vertex
+ * @param mode Sequential Tarjan or Kosaraju, or parallel forward-backward
+ * @return int The number of components
+ */
+template <typename T>
+int Graph<T>::stronglyConnectedComponents(std::vector<int> &component,
+                                          SccMode mode) const {
+  requireFinalized();
+  if (mode == SccMode::Kosaraju) return kosarajuComponents(component);
+  if (mode == SccMode::ForwardBackward) {
+    return forwardBackwardComponents(component);
   }
-  return true;
+
+  // Tarjan completes the components sinks first
+  component.assign(numVertices, -1);
+  int count = tarjanComponents(component, 0, nullptr);
+  for (int &id : component) id = count - 1 - id;
+  return count;
 }
 
+/**
+ * Builds the condensation: one vertex per component and one edge for
+ * every pair of components joined by at least one edge. Parallel edges
+ * collapse into the lightest one. The result is a DAG whenever component
+ * comes from stronglyConnectedComponents.
+ *
+ * @tparam T The type of the graph's weights
+ * @param component Component id of every vertex, ids from 0 to count - 1
+ * @return Graph<T> The finalized condensation
+ */
 template <typename T>
-bool Graph<T>::isDAGUtil(int v, std::vector<bool> &visited,
-                         std::vector<bool> &recStack) {
-  if (!visited[v]) {
-    visited[v] = true;
-    recStack[v] = true;
+Graph<T> Graph<T>::condensation(const std::vector<int> &component) const {
+  requireFinalized();
+  if (component.size() != static_cast<std::size_t>(numVertices)) {
+    throw std::invalid_argument("Component list does not match the graph");
+  }
+  int count = 0;
+  for (int id : component) {
+    if (id < 0) throw std::invalid_argument("Negative component id");
+    count = std::max(count, id + 1);
+  }
+
+  // Group the vertices by component with a counting sort
+  std::vector<int> start(count + 1, 0);
+  for (int id : component) ++start[id + 1];
+  for (int c = 0; c < count; ++c) start[c + 1] += start[c];
+  std::vector<int> members(numVertices);
+  std::vector<int> fill(start.begin(), start.end() - 1);
+  for (int v = 0; v < numVertices; ++v) members[fill[component[v]]++] = v;
 
-    for (const auto &edge : adjList[v]) {
-      if (!visited[edge.to] && isDAGUtil(edge.to, visited, recStack))
-        return true;
-      else if (recStack[edge.to])
-        return true;
+  Graph dag(count);
+  std::vector<int> lastSeen(count, -1);
+  std::vector<T> lightest(count);
+  std::vector<int> touched;
+  for (int c = 0; c < count; ++c) {
+    touched.clear();
+    for (int i = start[c]; i < start[c + 1]; ++i) {
+      int u = members[i];
+      for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+        int d = component[targets[e]];
+        if (d == c) continue;
+        if (lastSeen[d] != c) {
+          lastSeen[d] = c;
+          lightest[d] = weights[e];
+          touched.push_back(d);
+        } else if (weights[e] < lightest[d]) {
+          lightest[d] = weights[e];
+        }
+      }
     }
+    for (int d : touched) dag.addEdge(c, d, lightest[d]);
   }
-  recStack[v] = false;
-  return false;
+  dag.finalize();
+  return dag;
 }
 
+/**
+ * Builds the reverse adjacency in CSR form: the in-edges of vertex v come
+ * from sources[inOffsets[v] .. inOffsets[v + 1]).
+ *
+ * @param inOffsets Output: per-vertex offsets into sources
+ * @param sources Output: tails of the in-edges
+ */
 template <typename T>
-bool Graph<T>::isDAG() {
-  std::vector<bool> visited(numVertices, false);
-  std::vector<bool> recStack(numVertices, false);
+void Graph<T>::reverseEdges(std::vector<std::size_t> &inOffsets,
+                            std::vector<int> &sources) const {
+  inOffsets.assign(static_cast<std::size_t>(numVertices) + 1, 0);
+  for (int to : targets) ++inOffsets[to + 1];
+  for (int v = 0; v < numVertices; ++v) inOffsets[v + 1] += inOffsets[v];
+  sources.resize(targets.size());
+  std::vector<std::size_t> fill(inOffsets.begin(), inOffsets.end() - 1);
+  for (int u = 0; u < numVertices; ++u) {
+    for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+      sources[fill[targets[e]]++] = u;
+    }
+  }
+}
 
-  for (int i = 0; i < numVertices; i++)
-    if (isDAGUtil(i, visited, recStack)) return false;
+/**
+ * Tarjan's algorithm with an explicit stack of (vertex, next edge) pairs,
+ * so deep graphs cannot overflow the call stack. Vertices that already
+ * have a component are skipped; with part set, edges between vertices of
+ * different parts are ignored as well. Components are completed, and
+ * numbered, sinks first.
+ *
+ * @param component In/out: -1 for vertices still to be placed
+ * @param next The id to give the first new component
+ * @param part Optional partition no component may cross
+ * @return int next plus the number of new components
+ */
+template <typename T>
+int Graph<T>::tarjanComponents(std::vector<int> &component, int next,
+                               const std::vector<int> *part) const {
+  std::vector<int> index(numVertices, -1);
+  std::vector<int> low(numVertices);
+  std::vector<int> open;  // visited vertices without a component yet
+  std::vector<std::pair<int, std::size_t>> path;
+  int counter = 0;
+
+  for (int start = 0; start < numVertices; ++start) {
+    if (index[start] != -1 || component[start] != -1) continue;
+    index[start] = low[start] = counter++;
+    open.push_back(start);
+    path.push_back({start, offsets[start]});
+
+    while (!path.empty()) {
+      int u = path.back().first;
+      std::size_t e = path.back().second;
+      if (e < offsets[u + 1]) {
+        path.back().second++;
+        int v = targets[e];
+        if (component[v] != -1) continue;
+        if (part && (*part)[v] != (*part)[u]) continue;
+        if (index[v] == -1) {
+          index[v] = low[v] = counter++;
+          open.push_back(v);
+          path.push_back({v, offsets[v]});
+        } else {
+          // Still open, so v is on the current path's stack
+          low[u] = std::min(low[u], index[v]);
+        }
+        continue;
+      }
+
+      path.pop_back();
+      if (!path.empty()) {
+        int parent = path.back().first;
+        low[parent] = std::min(low[parent], low[u]);
+      }
+      if (low[u] == index[u]) {
+        int v;
+        do {
+          v = open.back();
+          open.pop_back();
+          component[v] = next;
+        } while (v != u);
+        ++next;
+      }
+    }
+  }
+  return next;
+}
+
+/**
+ * Kosaraju's algorithm: a depth-first pass records finishing order, then
+ * searches over the reversed edges, started from the latest finisher
+ * still unplaced, each collect one component. Both passes use explicit
+ * stacks. Components come out in topological order of the condensation.
+ *
+ * @param component Output: the component id of every vertex
+ * @return int The number of components
+ */
+template <typename T>
+int Graph<T>::kosarajuComponents(std::vector<int> &component) const {
+  std::vector<int> finished;
+  finished.reserve(numVertices);
+  std::vector<char> seen(numVertices, 0);
+  std::vector<std::pair<int, std::size_t>> path;
+  for (int start = 0; start < numVertices; ++start) {
+    if (seen[start]) continue;
+    seen[start] = 1;
+    path.push_back({start, offsets[start]});
+    while (!path.empty()) {
+      int u = path.back().first;
+      std::size_t e = path.back().second;
+      if (e == offsets[u + 1]) {
+        finished.push_back(u);
+        path.pop_back();
+        continue;
+      }
+      path.back().second++;
+      int v = targets[e];
+      if (!seen[v]) {
+        seen[v] = 1;
+        path.push_back({v, offsets[v]});
+      }
+    }
+  }
+
+  std::vector<std::size_t> inOffsets;
+  std::vector<int> sources;
+  reverseEdges(inOffsets, sources);
+
+  component.assign(numVertices, -1);
+  int count = 0;
+  std::vector<int> stack;
+  for (auto it = finished.rbegin(); it != finished.rend(); ++it) {
+    if (component[*it] != -1) continue;
+    component[*it] = count;
+    stack.push_back(*it);
+    while (!stack.empty()) {
+      int u = stack.back();
+      stack.pop_back();
+      for (std::size_t e = inOffsets[u]; e < inOffsets[u + 1]; ++e) {
+        int v = sources[e];
+        if (component[v] == -1) {
+          component[v] = count;
+          stack.push_back(v);
+        }
+      }
+    }
+    ++count;
+  }
+  return count;
+}
+
+/**
+ * Forward-backward decomposition over the shared thread pool.
+ *
+ * Trimming comes first: a vertex without live predecessors or without
+ * live successors is a component of its own, and removing it may expose
+ * more such vertices. This runs level-synchronously like
+ * parallelKahnOrder, in both directions at once.
+ *
+ * Each remaining piece then picks a pivot and runs a parallel BFS forward
+ * and one backward, both confined to the piece. The vertices reached both
+ * ways form the pivot's component; those reached only forward, and those
+ * reached only backward, become pieces of their own, and the unreached
+ * rest stays in the piece for its next pivot. Pieces below the cutoff are
+ * left to one final Tarjan pass that ignores edges between pieces, since
+ * no component crosses them. Ids are put in topological order at the end.
+ *
+ * @param component Output: the component id of every vertex
+ * @return int The number of components
+ */
+template <typename T>
+int Graph<T>::forwardBackwardComponents(std::vector<int> &component) const {
+  const std::size_t grain = 1024;
+  const std::size_t cutoff = 16384;
+  ThreadPool &pool = ThreadPool::shared();
+  std::size_t n = static_cast<std::size_t>(numVertices);
+
+  std::vector<std::size_t> inOffsets;
+  std::vector<int> sources;
+  reverseEdges(inOffsets, sources);
+
+  component.assign(n, -1);
+  std::atomic<int> nextId(0);
+  std::vector<std::vector<int>> ready(pool.size());
+  auto collect = [&](std::vector<int> &list) {
+    for (auto &local : ready) {
+      list.insert(list.end(), local.begin(), local.end());
+      local.clear();
+    }
+  };
+
+  // Trim: live in- and out-degrees; whoever drops one to zero claims the
+  // vertex, so each is removed exactly once
+  std::unique_ptr<std::atomic<int>[]> liveIn(new std::atomic<int>[n]);
+  std::unique_ptr<std::atomic<int>[]> liveOut(new std::atomic<int>[n]);
+  std::unique_ptr<std::atomic<char>[]> alive(new std::atomic<char>[n]);
+  auto claim = [&](int v, unsigned worker) {
+    if (alive[v].exchange(0, std::memory_order_relaxed) == 1) {
+      component[v] = nextId.fetch_add(1, std::memory_order_relaxed);
+      ready[worker].push_back(v);
+    }
+  };
+  pool.parallelFor(0, n, grain, [&](std::size_t lo, std::size_t hi, unsigned) {
+    for (std::size_t v = lo; v < hi; ++v) {
+      liveIn[v] = static_cast<int>(inOffsets[v + 1] - inOffsets[v]);
+      liveOut[v] = static_cast<int>(offsets[v + 1] - offsets[v]);
+      alive[v] = 1;
+    }
+  });
+
+  std::vector<int> trimmed;
+  pool.parallelFor(
+      0, n, grain, [&](std::size_t lo, std::size_t hi, unsigned worker) {
+        for (std::size_t v = lo; v < hi; ++v) {
+          if (liveIn[v] == 0 || liveOut[v] == 0) {
+            claim(static_cast<int>(v), worker);
+          }
+        }
+      });
+  collect(trimmed);
+  for (std::size_t levelBegin = 0; levelBegin < trimmed.size();) {
+    std::size_t levelEnd = trimmed.size();
+    pool.parallelFor(
+        levelBegin, levelEnd, grain / 4,
+        [&](std::size_t lo, std::size_t hi, unsigned worker) {
+          for (std::size_t i = lo; i < hi; ++i) {
+            int u = trimmed[i];
+            for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+              int v = targets[e];
+              if (liveIn[v].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                claim(v, worker);
+              }
+            }
+            for (std::size_t e = inOffsets[u]; e < inOffsets[u + 1]; ++e) {
+              int v = sources[e];
+              if (liveOut[v].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                claim(v, worker);
+              }
+            }
+          }
+        });
+    collect(trimmed);
+    levelBegin = levelEnd;
+  }
+
+  // part[v]: the piece v belongs to, -1 once v has a component
+  std::vector<int> part(n, -1);
+  struct Piece {
+    int label;
+    std::vector<int> vertices;  // may include vertices that moved on
+    std::size_t remaining;
+  };
+  std::vector<Piece> pieces(1, Piece{0, {}, 0});
+  for (std::size_t v = 0; v < n; ++v) {
+    if (component[v] == -1) {
+      part[v] = 0;
+      pieces[0].vertices.push_back(static_cast<int>(v));
+    }
+  }
+  pieces[0].remaining = pieces[0].vertices.size();
+  int labels = 1;
+
+  std::unique_ptr<std::atomic<int>[]> forwardMark(new std::atomic<int>[n]);
+  std::unique_ptr<std::atomic<int>[]> backwardMark(new std::atomic<int>[n]);
+  pool.parallelFor(0, n, grain, [&](std::size_t lo, std::size_t hi, unsigned) {
+    for (std::size_t v = lo; v < hi; ++v) forwardMark[v] = backwardMark[v] = 0;
+  });
+  int round = 0;
+
+  // Level-synchronous BFS inside one piece; reached collects the vertices
+  auto reach = [&](int pivot, int label, std::atomic<int> *mark,
+                   const std::size_t *begin, const int *adjacent,
+                   std::vector<int> &reached) {
+    reached.clear();
+    mark[pivot] = round;
+    reached.push_back(pivot);
+    for (std::size_t levelBegin = 0; levelBegin < reached.size();) {
+      std::size_t levelEnd = reached.size();
+      pool.parallelFor(
+          levelBegin, levelEnd, grain / 4,
+          [&](std::size_t lo, std::size_t hi, unsigned worker) {
+            for (std::size_t i = lo; i < hi; ++i) {
+              int u = reached[i];
+              for (std::size_t e = begin[u]; e < begin[u + 1]; ++e) {
+                int v = adjacent[e];
+                if (part[v] != label) continue;
+                if (mark[v].load(std::memory_order_relaxed) != round &&
+                    mark[v].exchange(round, std::memory_order_relaxed) !=
+                        round) {
+                  ready[worker].push_back(v);
+                }
+              }
+            }
+          });
+      collect(reached);
+      levelBegin = levelEnd;
+    }
+  };
+
+  std::vector<int> forward, backward;
+  while (!pieces.empty()) {
+    Piece piece = std::move(pieces.back());
+    pieces.pop_back();
+    std::size_t cursor = 0;
+    while (piece.remaining >= cutoff) {
+      while (part[piece.vertices[cursor]] != piece.label) ++cursor;
+      int pivot = piece.vertices[cursor];
+      ++round;
+      reach(pivot, piece.label, forwardMark.get(), offsets.data(),
+            targets.data(), forward);
+      reach(pivot, piece.label, backwardMark.get(), inOffsets.data(),
+            sources.data(), backward);
+
+      int id = nextId++;
+      Piece ahead{labels++, {}, 0}, behind{labels++, {}, 0};
+      for (int v : forward) {
+        if (backwardMark[v] == round) {
+          component[v] = id;
+          part[v] = -1;
+        } else {
+          part[v] = ahead.label;
+          ahead.vertices.push_back(v);
+        }
+      }
+      for (int v : backward) {
+        if (part[v] == piece.label) {
+          part[v] = behind.label;
+          behind.vertices.push_back(v);
+        }
+      }
+      ahead.remaining = ahead.vertices.size();
+      behind.remaining = behind.vertices.size();
+      piece.remaining -= forward.size() + behind.remaining;
+      if (ahead.remaining >= cutoff) pieces.push_back(std::move(ahead));
+      if (behind.remaining >= cutoff) pieces.push_back(std::move(behind));
+    }
+  }
+
+  int count = tarjanComponents(component, nextId, &part);
+  orderComponents(component, count);
+  return count;
+}
+
+/**
+ * Renumbers components so that ids follow a topological order of the
+ * condensation, with Kahn's algorithm over the components.
+ *
+ * @param component In/out: the component id of every vertex
+ * @param count The number of components
+ */
+template <typename T>
+void Graph<T>::orderComponents(std::vector<int> &component, int count) const {
+  std::vector<int> start(count + 1, 0);
+  for (int id : component) ++start[id + 1];
+  for (int c = 0; c < count; ++c) start[c + 1] += start[c];
+  std::vector<int> members(numVertices);
+  std::vector<int> fill(start.begin(), start.end() - 1);
+  for (int v = 0; v < numVertices; ++v) members[fill[component[v]]++] = v;
+
+  std::vector<int> indegree(count, 0);
+  for (int u = 0; u < numVertices; ++u) {
+    for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+      if (component[targets[e]] != component[u]) {
+        ++indegree[component[targets[e]]];
+      }
+    }
+  }
+
+  std::vector<int> order;
+  order.reserve(count);
+  for (int c = 0; c < count; ++c) {
+    if (indegree[c] == 0) order.push_back(c);
+  }
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    int c = order[i];
+    for (int j = start[c]; j < start[c + 1]; ++j) {
+      int u = members[j];
+      for (std::size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+        int d = component[targets[e]];
+        if (d != c && --indegree[d] == 0) order.push_back(d);
+      }
+    }
+  }
 
-  return true;
+  std::vector<int> rank(count);
+  for (int i = 0; i < count; ++i) rank[order[i]] = i;
+  for (int &id : component) id = rank[id];
 }
 
 // Explicit template instantiation
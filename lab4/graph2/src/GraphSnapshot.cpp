@@ -0,0 +1,223 @@
+#include "../include/GraphSnapshot.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace GraphSnapshot {
+
+namespace {
+
+constexpr std::uint64_t CHECKSUM_BASIS = 0xcbf29ce484222325ULL;
+constexpr std::uint64_t CHECKSUM_PRIME = 0x100000001b3ULL;
+
+std::uint64_t alignUp(std::uint64_t position) { return (position + 7) & ~7ULL; }
+
+}  // namespace
+
+template <>
+WeightType weightTypeOf<int>() {
+  return WeightType::Int32;
+}
+
+template <>
+WeightType weightTypeOf<float>() {
+  return WeightType::Float32;
+}
+
+template <>
+WeightType weightTypeOf<double>() {
+  return WeightType::Float64;
+}
+
+/**
+ * Checks whether a file starts with the snapshot magic bytes.
+ *
+ * @param filename Path of the file to check.
+ * @return bool True if the file looks like a snapshot.
+ */
+bool isSnapshot(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  char magic[sizeof(MAGIC)] = {};
+  file.read(magic, sizeof(magic));
+  return file.gcount() == sizeof(magic) &&
+         std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+/**
+ * FNV-1a style hash that consumes eight bytes per step, so verifying a
+ * multi-GB snapshot runs at memory bandwidth rather than byte by byte.
+ *
+ * @param data Bytes to hash.
+ * @param size Number of bytes.
+ * @param seed Result of the previous section, or 0 to start a new chain.
+ * @return std::uint64_t The updated checksum.
+ */
+std::uint64_t checksum(const void *data, std::size_t size,
+                       std::uint64_t seed) {
+  const char *bytes = static_cast<const char *>(data);
+  std::uint64_t hash = seed == 0 ? CHECKSUM_BASIS : seed;
+  std::size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    hash = (hash ^ word) * CHECKSUM_PRIME;
+    hash ^= hash >> 29;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(bytes[i])) * CHECKSUM_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * Writes a snapshot file.
+ *
+ * @param filename Path of the file to create or overwrite.
+ * @param payload The CSR arrays of the graph.
+ */
+void write(const std::string &filename, const Payload &payload) {
+  std::size_t offsetsBytes = (payload.numVertices + 1) * sizeof(std::uint64_t);
+  std::size_t targetsBytes = payload.numEdges * sizeof(std::int32_t);
+  std::size_t weightsBytes = payload.numEdges * payload.weightSize;
+
+  Header header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.weightType = static_cast<std::uint32_t>(payload.weightType);
+  header.numVertices = payload.numVertices;
+  header.numEdges = payload.numEdges;
+  header.offsetsStart = alignUp(sizeof(Header));
+  header.targetsStart = alignUp(header.offsetsStart + offsetsBytes);
+  header.weightsStart = alignUp(header.targetsStart + targetsBytes);
+  header.checksumStart = alignUp(header.weightsStart + weightsBytes);
+
+  std::uint64_t sum = checksum(payload.offsets, offsetsBytes, 0);
+  sum = checksum(payload.targets, targetsBytes, sum);
+  sum = checksum(payload.weights, weightsBytes, sum);
+
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("Could not create file: " + filename);
+  }
+
+  const char padding[8] = {};
+  auto writeAt = [&](std::uint64_t start, const void *data, std::size_t size) {
+    std::uint64_t position = static_cast<std::uint64_t>(file.tellp());
+    file.write(padding, static_cast<std::streamsize>(start - position));
+    file.write(static_cast<const char *>(data),
+               static_cast<std::streamsize>(size));
+  };
+
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  writeAt(header.offsetsStart, payload.offsets, offsetsBytes);
+  writeAt(header.targetsStart, payload.targets, targetsBytes);
+  writeAt(header.weightsStart, payload.weights, weightsBytes);
+  writeAt(header.checksumStart, &sum, sizeof(sum));
+
+  if (!file) {
+    throw std::runtime_error("Could not write file: " + filename);
+  }
+}
+
+/**
+ * Checks that CSR arrays read from a file are safe to traverse: the offsets
+ * rise from 0 to numEdges and every target is a vertex.
+ *
+ * @param offsets numVertices + 1 edge offsets.
+ * @param targets numEdges edge targets.
+ * @param numVertices Number of vertices.
+ * @param numEdges Number of edges.
+ * @return bool True if the arrays are well formed.
+ */
+bool isValidCsr(const std::uint64_t *offsets, const std::int32_t *targets,
+                std::uint64_t numVertices, std::uint64_t numEdges) {
+  if (offsets[0] != 0 || offsets[numVertices] != numEdges) return false;
+  for (std::uint64_t v = 0; v < numVertices; ++v) {
+    if (offsets[v] > offsets[v + 1]) return false;
+  }
+  for (std::uint64_t e = 0; e < numEdges; ++e) {
+    if (targets[e] < 0 ||
+        static_cast<std::uint64_t>(targets[e]) >= numVertices) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Checks that a mapped file is a complete snapshot of the expected weight
+ * type. The offsets and targets are always checked, since traversals index
+ * with them unchecked; the weights are only read when verifyChecksum is set.
+ *
+ * @param file The mapped snapshot.
+ * @param expected Weight type of the graph being loaded.
+ * @param verifyChecksum Whether to hash all arrays and compare the checksum.
+ * @return const Header& The header at the start of the mapping.
+ */
+const Header &validate(const MappedFile &file, WeightType expected,
+                       bool verifyChecksum) {
+  if (file.size() < sizeof(Header)) {
+    throw std::runtime_error("Snapshot is truncated");
+  }
+  const Header &header = *reinterpret_cast<const Header *>(file.data());
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw std::runtime_error("Not a graph snapshot");
+  }
+  if (header.version != VERSION) {
+    throw std::runtime_error("Unsupported snapshot version " +
+                             std::to_string(header.version));
+  }
+  if (header.weightType != static_cast<std::uint32_t>(expected)) {
+    throw std::runtime_error("Snapshot weight type does not match the graph");
+  }
+  if (header.numVertices >= static_cast<std::uint64_t>(INT32_MAX)) {
+    throw std::runtime_error("Snapshot has too many vertices");
+  }
+  std::size_t weightSize = header.weightType ==
+                                   static_cast<std::uint32_t>(WeightType::Float64)
+                               ? 8
+                               : 4;
+  // Counts that could not fit in the file are rejected before the array
+  // sizes are computed from them, so the products cannot wrap around
+  if (header.numVertices >= file.size() / sizeof(std::uint64_t) ||
+      header.numEdges > file.size() / weightSize) {
+    throw std::runtime_error("Snapshot is truncated or corrupt");
+  }
+  std::uint64_t offsetsBytes =
+      (header.numVertices + 1) * sizeof(std::uint64_t);
+  std::uint64_t targetsBytes = header.numEdges * sizeof(std::int32_t);
+  std::uint64_t weightsBytes = header.numEdges * weightSize;
+  if (header.offsetsStart % 8 != 0 || header.targetsStart % 8 != 0 ||
+      header.weightsStart % 8 != 0 ||
+      header.offsetsStart < sizeof(Header) ||
+      !endsBy(header.offsetsStart, offsetsBytes, header.targetsStart) ||
+      !endsBy(header.targetsStart, targetsBytes, header.weightsStart) ||
+      !endsBy(header.weightsStart, weightsBytes, header.checksumStart) ||
+      !endsBy(header.checksumStart, sizeof(std::uint64_t), file.size())) {
+    throw std::runtime_error("Snapshot is truncated or corrupt");
+  }
+
+  const char *base = file.data();
+  const auto *offsets =
+      reinterpret_cast<const std::uint64_t *>(base + header.offsetsStart);
+  const auto *targets =
+      reinterpret_cast<const std::int32_t *>(base + header.targetsStart);
+  if (!isValidCsr(offsets, targets, header.numVertices, header.numEdges)) {
+    throw std::runtime_error("Snapshot offsets or targets are corrupt");
+  }
+
+  if (verifyChecksum) {
+    std::uint64_t sum = checksum(base + header.offsetsStart, offsetsBytes, 0);
+    sum = checksum(base + header.targetsStart, targetsBytes, sum);
+    sum = checksum(base + header.weightsStart, weightsBytes, sum);
+    std::uint64_t stored;
+    std::memcpy(&stored, base + header.checksumStart, sizeof(stored));
+    if (sum != stored) {
+      throw std::runtime_error("Snapshot checksum mismatch");
+    }
+  }
+  return header;
+}
+
+}  // namespace GraphSnapshot
@@ -0,0 +1,224 @@
+#include "../include/IncrementalTopologicalOrder.hpp"
+
+#include <algorithm>
+
+/**
+ * Computes the initial order with Kahn's algorithm.
+ *
+ * @param graph The graph to follow; must outlive this object
+ */
+template <typename T>
+IncrementalTopologicalOrder<T>::IncrementalTopologicalOrder(
+    const DynamicGraph<T> &graph)
+    : graph(&graph), acyclic(true), version(0) {
+  rebuild();
+}
+
+/**
+ * Brings the order up to date after a batch was applied to the graph.
+ *
+ * New edges are inserted one at a time. While an edge waits its turn it
+ * is hidden from the searches, so every edge they follow agrees with the
+ * current order, which is what lets Pearce-Kelly bound them. A cycle
+ * found this way only uses edges that are in the final graph, so the
+ * batch leaves the graph cyclic no matter what else it removed.
+ *
+ * @param changes The changes returned by DynamicGraph::apply
+ */
+template <typename T>
+void IncrementalTopologicalOrder<T>::update(
+    const std::vector<EdgeChange<T>> &changes) {
+  grow();
+
+  if (!acyclic) {
+    bool removed = std::any_of(
+        changes.begin(), changes.end(),
+        [](const EdgeChange<T> &change) { return !change.exists; });
+    if (removed) rebuild();
+    return;
+  }
+
+  for (const EdgeChange<T> &change : changes) {
+    if (!change.existed && change.exists) {
+      pending.insert(key(change.from, change.to));
+    }
+  }
+  for (const EdgeChange<T> &change : changes) {
+    if (change.existed || !change.exists) continue;
+    pending.erase(key(change.from, change.to));
+    if (!insertEdge(change.from, change.to)) {
+      acyclic = false;
+      break;
+    }
+  }
+  pending.clear();
+}
+
+/**
+ * Returns the maintained order.
+ *
+ * @return std::optional<std::vector<int>> The vertices in topological
+ * order, or std::nullopt if the graph has a cycle
+ */
+template <typename T>
+std::optional<std::vector<int>>
+IncrementalTopologicalOrder<T>::topologicalSort() const {
+  if (!acyclic) return std::nullopt;
+  return order;
+}
+
+/**
+ * Places vertices added to the graph since the last call at the end of
+ * the order. They had no edges when they were added; edges the batch gave
+ * them arrive as insertions.
+ */
+template <typename T>
+void IncrementalTopologicalOrder<T>::grow() {
+  int n = graph->getNumVertices();
+  for (int v = static_cast<int>(position.size()); v < n; ++v) {
+    position.push_back(static_cast<int>(order.size()));
+    order.push_back(v);
+  }
+  visited.resize(n, 0);
+}
+
+/**
+ * Recomputes the order from scratch with Kahn's algorithm. If the graph
+ * has a cycle, the vertices Kahn could not place are appended in id order
+ * so that order and position stay permutations of each other.
+ */
+template <typename T>
+void IncrementalTopologicalOrder<T>::rebuild() {
+  int n = graph->getNumVertices();
+  std::vector<int> indegree(n);
+  for (int v = 0; v < n; ++v) {
+    indegree[v] = static_cast<int>(graph->inEdges(v).size());
+  }
+
+  order.clear();
+  order.reserve(n);
+  for (int v = 0; v < n; ++v) {
+    if (indegree[v] == 0) order.push_back(v);
+  }
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    for (const auto &arc : graph->outEdges(order[i])) {
+      if (--indegree[arc.vertex] == 0) order.push_back(arc.vertex);
+    }
+  }
+  acyclic = order.size() == static_cast<std::size_t>(n);
+  for (int v = 0; v < n && !acyclic; ++v) {
+    if (indegree[v] > 0) order.push_back(v);
+  }
+
+  position.assign(n, 0);
+  for (int i = 0; i < n; ++i) position[order[i]] = i;
+  visited.assign(n, 0);
+  version = 0;
+}
+
+/**
+ * Pearce-Kelly insertion of the edge from -> to. If from already comes
+ * first there is nothing to do. Otherwise the vertices reachable from
+ * `to` that sit before `from`, and the vertices reaching `from` that sit
+ * after `to`, are the only ones out of place. They keep their relative
+ * order and trade slots so that the second group comes first.
+ *
+ * @param from Tail of the new edge
+ * @param to Head of the new edge
+ * @return bool False if the edge closes a cycle; the order is unchanged
+ */
+template <typename T>
+bool IncrementalTopologicalOrder<T>::insertEdge(int from, int to) {
+  if (from == to) return false;
+  int lower = position[to];
+  int upper = position[from];
+  if (lower > upper) return true;
+
+  if (++version == 0) {
+    // The counter wrapped: old stamps could now look current
+    std::fill(visited.begin(), visited.end(), 0);
+    version = 1;
+  }
+  forward.clear();
+  backward.clear();
+  if (!search(to, from, upper, true)) return false;
+  search(from, -1, lower, false);
+
+  auto byPosition = [this](int a, int b) {
+    return position[a] < position[b];
+  };
+  std::sort(forward.begin(), forward.end(), byPosition);
+  std::sort(backward.begin(), backward.end(), byPosition);
+
+  // The freed slots, in increasing order: both lists are sorted already
+  std::vector<int> slots;
+  slots.reserve(forward.size() + backward.size());
+  for (int v : backward) slots.push_back(position[v]);
+  for (int v : forward) slots.push_back(position[v]);
+  std::inplace_merge(slots.begin(), slots.begin() + backward.size(),
+                     slots.end());
+
+  std::size_t next = 0;
+  for (int v : backward) position[v] = slots[next++];
+  for (int v : forward) position[v] = slots[next++];
+  for (int v : backward) order[position[v]] = v;
+  for (int v : forward) order[position[v]] = v;
+  return true;
+}
+
+/**
+ * Depth-first search bounded by position, with an explicit stack. The
+ * forward search follows out-edges to vertices placed before the bound
+ * and collects them in `forward`; the backward search follows in-edges to
+ * vertices placed after the bound and collects them in `backward`.
+ *
+ * @param start Vertex to start from
+ * @param stop Vertex whose discovery means a cycle, -1 for none
+ * @param bound Position limit of the search
+ * @param forwardSearch Direction of the search
+ * @return bool False if `stop` was reached
+ */
+template <typename T>
+bool IncrementalTopologicalOrder<T>::search(int start, int stop, int bound,
+                                            bool forwardSearch) {
+  std::vector<int> &found = forwardSearch ? forward : backward;
+  stack.clear();
+  stack.push_back(start);
+  visited[start] = version;
+  while (!stack.empty()) {
+    int u = stack.back();
+    stack.pop_back();
+    found.push_back(u);
+
+    const auto &arcs = forwardSearch ? graph->outEdges(u) : graph->inEdges(u);
+    for (const auto &arc : arcs) {
+      int w = arc.vertex;
+      if (forwardSearch ? isPending(u, w) : isPending(w, u)) continue;
+      if (w == stop) return false;
+      bool inside = forwardSearch ? position[w] < bound : position[w] > bound;
+      if (inside && visited[w] != version) {
+        visited[w] = version;
+        stack.push_back(w);
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Checks whether an edge belongs to the current batch and has not been
+ * inserted yet.
+ *
+ * @param from Tail of the edge
+ * @param to Head of the edge
+ * @return bool True if the searches must not follow the edge
+ */
+template <typename T>
+bool IncrementalTopologicalOrder<T>::isPending(int from, int to) const {
+  return !pending.empty() && pending.count(key(from, to)) != 0;
+}
+
+// Explicit template instantiation
+template class IncrementalTopologicalOrder<int>;
+template class IncrementalTopologicalOrder<float>;
+template class IncrementalTopologicalOrder<double>;
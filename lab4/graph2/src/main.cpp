@@ -1,3 +1,9 @@
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
@@ -5,7 +11,36 @@
 #include <iostream>
 
 #include "Color.hpp"
+#include "DynamicGraph.hpp"
 #include "Graph.cpp"
+#include "IncrementalTopologicalOrder.hpp"
+
+extern char** environ;
+
+/**
+ * Renders a DOT file as PNG with Graphviz. The program is started directly
+ * rather than through a shell, so the paths need no quoting.
+ *
+ * @param dotPath Path of the DOT file to render
+ * @param imgPath Path of the PNG file to create
+ * @return bool True if Graphviz ran and succeeded
+ */
+bool renderPng(const std::string& dotPath, const std::string& imgPath) {
+  std::string program = "dot", format = "-Tpng", output = "-o";
+  std::string input = dotPath, image = imgPath;
+  char* argv[] = {program.data(), format.data(), input.data(),
+                  output.data(),  image.data(),  nullptr};
+
+  pid_t pid;
+  if (posix_spawnp(&pid, "dot", nullptr, nullptr, argv, environ) != 0) {
+    return false;
+  }
+  int status = 0;
+  while (waitpid(pid, &status, 0) == -1) {
+    if (errno != EINTR) return false;
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
 
 /**
  * Generates DOT file and converts it to PNG format
@@ -25,26 +60,26 @@ bool generateGraphVisualization(const Graph<int>& graph,
     std::filesystem::create_directories("outputs/dots");
     std::filesystem::create_directories("outputs/img");
 
-    // Generate DOT file
-    std::string dotRepresentation = graph.toDot();
+    // Stream the DOT file straight to disk
     std::string dotPath = "outputs/dots/" + graphName + ".dot";
     std::string imgPath = "outputs/img/" + graphName + ".png";
 
-    std::ofstream dotFile(dotPath);
-    if (!dotFile.is_open()) {
+    int dotFile = ::open(dotPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (dotFile == -1) {
       std::cerr << Color::RED << "Error: Could not create DOT file: " << dotPath
                 << Color::RESET << std::endl;
       return false;
     }
-
-    dotFile << dotRepresentation;
-    dotFile.close();
+    try {
+      graph.toDot(dotFile);
+    } catch (...) {
+      ::close(dotFile);
+      throw;
+    }
+    ::close(dotFile);
 
     // Convert DOT to PNG
-    std::string command = "dot -Tpng " + dotPath + " -o " + imgPath;
-    int result = system(command.c_str());
-
-    if (result != 0) {
+    if (!renderPng(dotPath, imgPath)) {
       std::cerr << Color::YELLOW
                 << "Warning: Could not generate PNG visualization. "
                 << "Is Graphviz installed?" << Color::RESET << std::endl;
@@ -92,6 +127,54 @@ void printDistances(const std::string& graphName,
   std::cout << std::endl;
 }
 
+/**
+ * Prints a vertex order on one line
+ *
+ * @param order The vertices to print
+ */
+void printOrder(const std::vector<int>& order) {
+  for (int vertex : order) {
+    std::cout << vertex << " ";
+  }
+  std::cout << std::endl;
+}
+
+/**
+ * Prints the vertices of a cycle, closing it back to the first vertex
+ *
+ * @param cycle Vertices of the cycle in edge order
+ */
+void printCycle(const std::vector<int>& cycle) {
+  if (cycle.empty()) return;
+  std::cout << "Cycle: " << Color::RED;
+  for (int vertex : cycle) {
+    std::cout << vertex << " -> ";
+  }
+  std::cout << cycle.front() << Color::RESET << std::endl;
+}
+
+/**
+ * Prints strongly connected components in id order, one brace group each
+ *
+ * @param component Component id of every vertex
+ * @param count Number of components
+ */
+void printComponents(const std::vector<int>& component, int count) {
+  std::vector<std::vector<int>> members(count);
+  for (size_t v = 0; v < component.size(); ++v) {
+    members[component[v]].push_back(static_cast<int>(v));
+  }
+  std::cout << "Components in schedule order: ";
+  for (const auto& group : members) {
+    std::cout << (group.size() > 1 ? Color::RED : Color::GREEN) << "{";
+    for (size_t i = 0; i < group.size(); ++i) {
+      std::cout << (i ? " " : "") << group[i];
+    }
+    std::cout << "}" << Color::RESET << " ";
+  }
+  std::cout << std::endl;
+}
+
 int main() {
   try {
     // Flag to control visualization generation
@@ -107,15 +190,45 @@ int main() {
     Graph<int> dagGraph("inputs/dagGraph.json");
     generateGraphVisualization(dagGraph, "dagGraph", GENERATE_VISUALS);
 
+    std::optional<std::vector<int>> order = dagGraph.topologicalSort();
     std::cout << "Is DAG: " << Color::GREEN << std::boolalpha
-              << dagGraph.isDAG() << Color::RESET << std::endl;
+              << order.has_value() << Color::RESET << std::endl;
 
     std::cout << "Topological Sort: ";
-    if (dagGraph.isDAG()) {
-      if (!dagGraph.topologicalSort()) {
-        std::cout << Color::RED << "Failed - Cycle detected!" << Color::RESET;
+    if (order) {
+      printOrder(*order);
+    } else {
+      std::cout << Color::RED << "Failed - Cycle detected!" << Color::RESET
+                << std::endl;
+    }
+
+    std::cout << "Topological Sort (parallel): ";
+    if (auto levels = dagGraph.topologicalSort(TopoSortMode::ParallelKahn)) {
+      printOrder(*levels);
+    }
+
+    // Keep the order up to date while edges come and go
+    std::cout << Color::CYAN << "\n[Testing Incremental Topological Order]"
+              << Color::RESET << std::endl;
+    DynamicGraph<int> tasks(dagGraph);
+    IncrementalTopologicalOrder<int> taskOrder(tasks);
+    std::vector<std::pair<std::string, std::vector<GraphEdit<int>>>> batches =
+        {{"add vertex 4 and edge 4 -> 3",
+          {GraphEdit<int>::addVertex(), GraphEdit<int>::setEdge(4, 3, 1)}},
+         {"add edge 0 -> 4", {GraphEdit<int>::setEdge(0, 4, 1)}},
+         {"remove edge 3 -> 2", {GraphEdit<int>::removeEdge(3, 2)}}};
+    for (const auto& [description, batch] : batches) {
+      taskOrder.update(tasks.apply(batch));
+      bool acyclic = taskOrder.isDAG();
+      std::cout << std::left << std::setw(30) << description << std::right
+                << "Is DAG: " << (acyclic ? Color::GREEN : Color::RED)
+                << std::boolalpha << acyclic << Color::RESET;
+      if (auto current = taskOrder.topologicalSort()) {
+        std::cout << "  Order: ";
+        printOrder(*current);
+      } else {
+        std::cout << std::endl;
       }
-      std::cout << std::endl;
     }
 
     // Test Cyclic Graph
@@ -124,20 +237,29 @@ int main() {
     Graph<int> cyclicGraph("inputs/dagGraphCyclic.json");
     generateGraphVisualization(cyclicGraph, "dagGraphCyclic", GENERATE_VISUALS);
 
+    std::vector<int> cycle;
+    std::optional<std::vector<int>> cyclicOrder =
+        cyclicGraph.topologicalSort(cycle);
     std::cout << "Is DAG: " << Color::RED << std::boolalpha
-              << cyclicGraph.isDAG() << Color::RESET << std::endl;
+              << cyclicOrder.has_value() << Color::RESET << std::endl;
 
     std::cout << "Topological Sort: ";
-    if (cyclicGraph.isDAG()) {
-      if (!cyclicGraph.topologicalSort()) {
-        std::cout << Color::RED << "Failed - Cycle detected!" << Color::RESET;
-      }
-      std::cout << std::endl;
+    if (cyclicOrder) {
+      printOrder(*cyclicOrder);
     } else {
       std::cout << Color::RED << "Not possible - Graph contains cycles"
                 << Color::RESET << std::endl;
+      printCycle(cycle);
     }
 
+    // Schedule the cyclic graph one strongly connected component at a time
+    std::vector<int> component;
+    int components = cyclicGraph.stronglyConnectedComponents(component);
+    printComponents(component, components);
+    std::cout << "Condensation is DAG: " << Color::GREEN << std::boolalpha
+              << cyclicGraph.condensation(component).isDAG() << Color::RESET
+              << std::endl;
+
   } catch (const std::exception& e) {
     std::cerr << Color::RED << "Error: " << e.what() << Color::RESET
               << std::endl;
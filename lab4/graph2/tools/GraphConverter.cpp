@@ -0,0 +1,83 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../src/Graph.cpp"
+
+/**
+ * Converts one JSON graph into a binary snapshot next to it, then maps the
+ * snapshot back with checksum verification and compares it to the source.
+ *
+ * @tparam T The weight type stored in the snapshot.
+ * @param input Path of the JSON file.
+ * @return bool True if the snapshot was written and verified.
+ */
+template <typename T>
+bool convert(const std::string &input) {
+  std::string output =
+      std::filesystem::path(input).replace_extension(".graph").string();
+  try {
+    auto start = std::chrono::steady_clock::now();
+    Graph<T> graph(input);
+    auto parsed = std::chrono::steady_clock::now();
+    graph.save(output);
+
+    auto mapStart = std::chrono::steady_clock::now();
+    Graph<T> snapshot = Graph<T>::load(output);
+    auto mapped = std::chrono::steady_clock::now();
+    Graph<T>::load(output, true);
+
+    if (snapshot.getNumVertices() != graph.getNumVertices() ||
+        snapshot.getNumEdges() != graph.getNumEdges()) {
+      std::cerr << Color::RED << "Snapshot of " << input
+                << " does not match the source" << Color::RESET << "\n";
+      return false;
+    }
+
+    using Ms = std::chrono::duration<double, std::milli>;
+    std::cout << Color::GREEN << input << " -> " << output << Color::RESET
+              << " (" << graph.getNumVertices() << " vertices, "
+              << graph.getNumEdges() << " edges; parse "
+              << Ms(parsed - start).count() << " ms, map "
+              << Ms(mapped - mapStart).count() << " ms)\n";
+    return true;
+  } catch (const std::exception &e) {
+    std::cerr << Color::RED << input << ": " << e.what() << Color::RESET
+              << "\n";
+    return false;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  std::string type = "int";
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--type") == 0 && i + 1 < argc) {
+      type = argv[++i];
+    } else {
+      inputs.push_back(argv[i]);
+    }
+  }
+  if (inputs.empty() ||
+      (type != "int" && type != "float" && type != "double")) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--type int|float|double] input.json...\n";
+    return 1;
+  }
+
+  bool ok = true;
+  for (const auto &input : inputs) {
+    if (type == "int") {
+      ok &= convert<int>(input);
+    } else if (type == "float") {
+      ok &= convert<float>(input);
+    } else {
+      ok &= convert<double>(input);
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/Color.hpp"
+#include "../src/Graph.cpp"
+
+/**
+ * Builds a transportation problem: a super source feeds every supplier its
+ * supply, every consumer drains its demand into a super sink, and each
+ * supplier ships to `degree` random consumers at a random unit cost, or to
+ * all of them if degree equals consumers. Vertex 0 is the source and the
+ * last vertex the sink.
+ */
+Graph<int> makeTransportation(int suppliers, int consumers, int degree,
+                              unsigned seed) {
+  int source = 0, sink = suppliers + consumers + 1;
+  Graph<int> graph(sink + 1);
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> amount(50, 500);
+  std::uniform_int_distribution<int> unitCost(1, 100);
+  std::uniform_int_distribution<int> anyConsumer(0, consumers - 1);
+
+  for (int s = 0; s < suppliers; ++s) {
+    graph.addEdge(source, 1 + s, amount(rng));
+    for (int k = 0; k < degree; ++k) {
+      int c = degree == consumers ? k : anyConsumer(rng);
+      graph.addEdge(1 + s, 1 + suppliers + c, amount(rng), unitCost(rng));
+    }
+  }
+  for (int c = 0; c < consumers; ++c) {
+    graph.addEdge(1 + suppliers + c, sink, amount(rng));
+  }
+  graph.finalize();
+  return graph;
+}
+
+/**
+ * Solves one instance with both modes and prints a row with the times,
+ * the flow and whether the two results agree. Successive shortest paths
+ * runs one Dijkstra search per distinct path cost, which takes tens of
+ * seconds on the large sparse instances, so it is skipped above
+ * `sspLimit` vertices.
+ */
+void benchmark(int suppliers, int consumers, int degree, int sspLimit) {
+  using Ms = std::chrono::duration<double, std::milli>;
+  Graph<int> graph = makeTransportation(suppliers, consumers, degree, 42);
+  int sink = graph.getNumVertices() - 1;
+
+  auto start = std::chrono::steady_clock::now();
+  int scalingCost = 0;
+  int scalingFlow = graph.getMinCostFlow(0, sink, scalingCost,
+                                         MinCostFlowMode::CostScaling);
+  double scalingMs = Ms(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << std::setw(10) << graph.getNumVertices() << std::setw(10)
+            << graph.getNumEdges() << std::setw(10) << scalingFlow
+            << std::setw(12) << scalingCost << std::fixed
+            << std::setprecision(1);
+  if (graph.getNumVertices() > sspLimit) {
+    std::cout << std::setw(12) << "-" << std::setw(14) << scalingMs
+              << std::endl;
+    return;
+  }
+
+  start = std::chrono::steady_clock::now();
+  int sspCost = 0;
+  int sspFlow = graph.getMinCostFlow(0, sink, sspCost);
+  double sspMs = Ms(std::chrono::steady_clock::now() - start).count();
+
+  bool ok = sspFlow == scalingFlow && sspCost == scalingCost;
+  std::cout << std::setw(12) << sspMs << std::setw(14) << scalingMs << "  "
+            << (ok ? Color::GREEN + "ok" : Color::RED + "MISMATCH")
+            << Color::RESET << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<int> sizes;
+  for (int i = 1; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+  if (sizes.empty()) sizes = {10000, 100000};
+
+  std::cout << Color::BOLD << Color::MAGENTA
+            << "\n[Min-cost flow on transportation problems]" << Color::RESET
+            << std::endl;
+  std::cout << std::setw(10) << "Vertices" << std::setw(10) << "Arcs"
+            << std::setw(10) << "Flow" << std::setw(12) << "Cost"
+            << std::setw(12) << "SSP (ms)" << std::setw(14) << "Scaling (ms)"
+            << std::endl;
+  std::cout << std::string(72, '-') << std::endl;
+
+  // Each size is the number of shipping arcs, laid out once as a complete
+  // bipartite network and once as many sparsely connected sites
+  for (int arcs : sizes) {
+    int side = static_cast<int>(std::sqrt(arcs));
+    benchmark(side, side, side, 5000);
+    benchmark(arcs / 10, arcs / 10, 10, 5000);
+  }
+  return 0;
+}
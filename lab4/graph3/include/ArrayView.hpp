@@ -0,0 +1,28 @@
+#ifndef ARRAY_VIEW_HPP
+#define ARRAY_VIEW_HPP
+
+#include <cstddef>
+
+/**
+ * Read-only view over a contiguous array that is owned elsewhere, either by
+ * a std::vector inside the graph or by a memory-mapped snapshot file.
+ */
+template <typename U>
+class ArrayView {
+ private:
+  const U *items;
+  std::size_t count;
+
+ public:
+  ArrayView() : items(nullptr), count(0) {}
+  ArrayView(const U *data, std::size_t size) : items(data), count(size) {}
+
+  const U &operator[](std::size_t index) const { return items[index]; }
+  const U *data() const { return items; }
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  const U *begin() const { return items; }
+  const U *end() const { return items + count; }
+};
+
+#endif /* ARRAY_VIEW_HPP */
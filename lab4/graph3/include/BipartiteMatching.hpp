@@ -0,0 +1,44 @@
+#ifndef BIPARTITE_MATCHING_HPP
+#define BIPARTITE_MATCHING_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "ParallelBfs.hpp"
+
+/**
+ * Hopcroft-Karp maximum matching used by Graph<T>::maximumMatching. The
+ * graph is an undirected CSR adjacency whose vertices are split into side
+ * 0 (left) and side 1 (right), with every edge joining the two sides.
+ *
+ * Each phase layers the left vertices with one BFS from all free left
+ * vertices, stopping at the first layer that reaches a free right vertex,
+ * and then augments along vertex-disjoint shortest alternating paths with
+ * DFS. There are O(sqrt(V)) phases of O(E) work each.
+ */
+class BipartiteMatching {
+ private:
+  int numVertices;
+  CsrView edges;
+  const std::vector<int> &side;
+
+  std::vector<int> mate;              // partner of each vertex, -1 if free
+  std::vector<int> layer;             // BFS layer of left vertices
+  std::vector<std::size_t> nextEdge;  // DFS cursor of left vertices
+  std::vector<int> queue;
+  std::vector<int> path;  // left vertices on the current DFS path
+  std::vector<int> via;   // right vertex taken out of each of them
+  int freeLayer;          // layer whose vertices may end a path
+
+  void matchGreedily();
+  bool buildLayers();
+  bool augment(int root);
+
+ public:
+  BipartiteMatching(int vertices, CsrView undirected,
+                    const std::vector<int> &side);
+
+  int run(std::vector<int> &matching);
+};
+
+#endif /* BIPARTITE_MATCHING_HPP */
@@ -0,0 +1,82 @@
+#ifndef DOT_WRITER_HPP
+#define DOT_WRITER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * What Graph<T>::toDot writes. By default every edge is written and no
+ * clusters are drawn.
+ */
+struct DotOptions {
+  // Keep each edge with this probability; the choice is a hash of the edge
+  // index and seed, so the same options always pick the same edges
+  double sampleRate = 1.0;
+  std::uint64_t seed = 0;
+
+  // Stop after this many edges, 0 for no limit
+  std::size_t maxEdges = 0;
+
+  // Optional cluster id of every vertex; vertices sharing a non-negative id
+  // are drawn inside one "subgraph cluster_<id>" block
+  const std::vector<int> *clusters = nullptr;
+};
+
+/**
+ * Buffered text writer for DOT export. Output is collected in a fixed
+ * buffer and handed to the stream or file descriptor in large blocks, and
+ * numbers are formatted with std::to_chars straight into the buffer, so
+ * memory use does not depend on how much is written.
+ */
+class DotWriter {
+ private:
+  static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+  static constexpr std::size_t MAX_NUMBER_LENGTH = 32;
+
+  std::ostream *stream;
+  int fd;
+  std::unique_ptr<char[]> buffer;
+  std::size_t used;
+
+  void drain();
+  void reserve(std::size_t bytes) {
+    if (BUFFER_SIZE - used < bytes) drain();
+  }
+
+ public:
+  explicit DotWriter(std::ostream &os);
+  explicit DotWriter(int fileDescriptor);
+  ~DotWriter();
+  DotWriter(const DotWriter &) = delete;
+  DotWriter &operator=(const DotWriter &) = delete;
+
+  void flush();
+  static bool keepEdge(const DotOptions &options, std::size_t edge);
+
+  DotWriter &operator<<(std::string_view text);
+  DotWriter &operator<<(char c) {
+    reserve(1);
+    buffer[used++] = c;
+    return *this;
+  }
+
+  template <typename Number>
+  DotWriter &writeNumber(Number value) {
+    reserve(MAX_NUMBER_LENGTH);
+    char *begin = buffer.get() + used;
+    used = std::to_chars(begin, begin + MAX_NUMBER_LENGTH, value).ptr -
+           buffer.get();
+    return *this;
+  }
+  DotWriter &operator<<(int value) { return writeNumber(value); }
+  DotWriter &operator<<(std::size_t value) { return writeNumber(value); }
+  DotWriter &operator<<(float value) { return writeNumber(value); }
+  DotWriter &operator<<(double value) { return writeNumber(value); }
+};
+
+#endif /* DOT_WRITER_HPP */
@@ -0,0 +1,77 @@
+#ifndef FLOW_NETWORK_HPP
+#define FLOW_NETWORK_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+enum class MaxFlowMode { Dinic, PushRelabel };
+enum class MinCostFlowMode { SuccessiveShortestPaths, CostScaling };
+
+/**
+ * Sparse residual network used by Graph<T>::getMaxFlow and getMinCostFlow.
+ * Every arc added with addArc is stored together with its reverse arc;
+ * after build() the arcs of each vertex are contiguous and reverse[a] gives
+ * the index of the partner of arc a, so pushing flow is two array updates.
+ * Arcs may carry a cost per unit of flow; reverse arcs carry the negated
+ * cost.
+ */
+template <typename T>
+class FlowNetwork {
+ private:
+  struct PendingArc {
+    int from;
+    int to;
+    T capacity;
+    T cost;
+  };
+
+  // Wide enough to add up capacity times cost over all arcs
+  using CostSum = std::conditional_t<std::is_integral_v<T>, long long, double>;
+
+  int numVertices;
+  std::vector<PendingArc> pendingArcs;
+
+  std::vector<std::size_t> offsets;  // arcs of v: [offsets[v], offsets[v+1])
+  std::vector<int> head;             // arc -> target vertex
+  std::vector<int> reverse;          // arc -> index of its reverse arc
+  std::vector<T> residual;           // arc -> remaining capacity
+  std::vector<T> cost;               // arc -> cost per unit of flow
+
+  // Dinic; the min-cost searches restrict both steps to the arcs for which
+  // usable(tail, arc) holds
+  template <typename Usable>
+  bool buildLevels(int source, int sink, std::vector<int> &level,
+                   Usable usable) const;
+  template <typename Usable>
+  T blockingFlow(int source, int sink, const std::vector<int> &level,
+                 Usable usable);
+
+  // Push-relabel
+  void globalRelabel(int source, int sink, std::vector<int> &height) const;
+
+  // Min-cost flow
+  void initialPotentials(std::vector<T> &potential) const;
+  bool updatePotentials(int source, int sink, std::vector<T> &potential,
+                        std::vector<std::size_t> &parent) const;
+  T augmentPath(int source, int sink, const std::vector<std::size_t> &parent);
+  void updatePrices(long long epsilon, const std::vector<long long> &scaled,
+                    const std::vector<T> &excess,
+                    std::vector<long long> &price) const;
+  void refine(long long epsilon, const std::vector<long long> &scaled,
+              std::vector<long long> &price);
+  CostSum residualCost() const;
+
+ public:
+  explicit FlowNetwork(int vertices);
+  void reserveArcs(std::size_t arcs) { pendingArcs.reserve(arcs); }
+  void addArc(int from, int to, T capacity, T cost = T());
+  void build();
+
+  T dinic(int source, int sink);
+  T pushRelabel(int source, int sink);
+  T successiveShortestPaths(int source, int sink, T &totalCost);
+  T costScaling(int source, int sink, T &totalCost);
+};
+
+#endif /* FLOW_NETWORK_HPP */
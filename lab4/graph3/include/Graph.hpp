@@ -5,20 +5,20 @@
 #include <fstream>
 #include <iostream>
 #include <limits>
-#include <queue>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <stack>
 #include <string>
 #include <vector>
 
-// Try multiple possible paths for json.hpp
-#if __has_include(<nlohmann/json.hpp>)
-#include <nlohmann/json.hpp>
-#elif __has_include("../../deps/nlohmann/json.hpp")
-#include "../../deps/nlohmann/json.hpp"
-#else
-#error "Could not find nlohmann/json.hpp. Please run 'make deps' first."
-#endif
+#include "ArrayView.hpp"
+#include "BipartiteMatching.hpp"
+#include "DotWriter.hpp"
+#include "GraphLoader.hpp"
+#include "GraphSnapshot.hpp"
+#include "FlowNetwork.hpp"
+#include "ParallelBfs.hpp"
 
 template <typename T>
 class Graph;
@@ -30,27 +30,75 @@ template <typename T>
 class Graph {
  private:
   struct Edge {
+    int from;
     int to;
     T weight;
+    T cost;
   };
 
-  std::vector<std::vector<Edge>> adjList;
+  // Builder phase: edges collected by addEdge until finalize() is called
+  std::vector<Edge> pendingEdges;
+
+  // Frozen CSR layout: the out-edges of vertex v are the entries
+  // [offsets[v], offsets[v + 1]) of targets and weights. The views point
+  // either into the storage vectors below or into a mapped snapshot file.
+  // costs is empty unless some edge was given a non-zero cost.
+  ArrayView<std::size_t> offsets;
+  ArrayView<int> targets;
+  ArrayView<T> weights;
+  ArrayView<T> costs;
+  std::vector<std::size_t> offsetStorage;
+  std::vector<int> targetStorage;
+  std::vector<T> weightStorage;
+  std::vector<T> costStorage;
+  std::shared_ptr<const MappedFile> snapshot;
+
+  // Reverse adjacency for bottom-up BFS steps, built on first use and
+  // published with the std::atomic_* shared_ptr functions
+  mutable std::shared_ptr<const Adjacency> reverseEdges;
   int numVertices;
+  bool finalized;
+
+  Graph();
 
  public:
   explicit Graph(const std::string &filename);
-  void addEdge(int from, int to, T weight);
+  explicit Graph(int vertices);
+  Graph(const Graph &other);
+  Graph(Graph &&other) noexcept = default;
+  Graph &operator=(const Graph &other);
+  Graph &operator=(Graph &&other) noexcept = default;
+  void addEdge(int from, int to, T weight, T cost = T());
+  void finalize();
+  bool isFinalized() const { return finalized; }
   friend std::ostream &operator<<<>(std::ostream &os, const Graph &graph);
   void readGraphFromFile(const std::string &filename);
-  std::string toDot() const;
+  void save(const std::string &filename) const;
+  static Graph load(const std::string &filename, bool verifyChecksum = false);
+  void toDot(std::ostream &os, const DotOptions &options = DotOptions()) const;
+  void toDot(int fd, const DotOptions &options = DotOptions()) const;
+  int getNumVertices() const { return numVertices; }
+  std::size_t getNumEdges() const { return targets.size(); }
+  bool hasCosts() const { return !costs.empty(); }
+  std::vector<int> bfsLevels(int src) const;
   bool isBipartite() const;
-  T getMaxFlow(int source, int sink) const;
+  bool isBipartite(std::vector<int> &side) const;
+  bool maximumMatching(std::vector<int> &mate) const;
+  T getMaxFlow(int source, int sink,
+               MaxFlowMode mode = MaxFlowMode::Dinic) const;
+  T getMinCostFlow(int source, int sink, T &cost,
+                   MinCostFlowMode mode =
+                       MinCostFlowMode::SuccessiveShortestPaths) const;
 
  private:
   void readGraphFromJson(const std::string &filename);
-  bool isBipartiteUtil(int start, std::vector<int> &colors) const;
-  bool bfs(const std::vector<std::vector<T>> &residualGraph, int source,
-           int sink, std::vector<int> &parent) const;
+  void readGraphFromSnapshot(const std::string &filename, bool verifyChecksum);
+  void bindStorage();
+  void requireFinalized() const;
+  void writeDot(DotWriter &dot, const DotOptions &options) const;
+  std::shared_ptr<const Adjacency> reverseAdjacency() const;
+  bool twoColor(CsrView undirected, std::vector<int> &side,
+                ThreadPool &pool) const;
 };
 
 #endif /* GRAPH_HPP */
@@ -0,0 +1,73 @@
+#ifndef GRAPH_GENERATOR_HPP
+#define GRAPH_GENERATOR_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Seeded random graph families for building benchmark inputs. Every
+ * generator draws from std::mt19937_64, whose output the standard fixes,
+ * and maps it to ranges by hand rather than through the library's
+ * distributions, so a seed gives the same graph on every platform and
+ * compiler. Weights are integers in [1, maxWeight], which every weight
+ * type holds exactly.
+ */
+namespace GraphGenerator {
+
+struct Edge {
+  int from;
+  int to;
+  double weight;
+};
+
+struct EdgeList {
+  int vertices = 0;
+  std::vector<Edge> edges;
+};
+
+struct Options {
+  int vertices = 1 << 16;
+  double averageDegree = 8;  // out-edges per vertex, where a family has one
+  std::uint64_t seed = 1;
+  int maxWeight = 1000;
+};
+
+// m = averageDegree * vertices uniformly random edges without self loops.
+// Pairs are drawn independently, so this is the multigraph variant of
+// G(n, m): the same edge can appear more than once.
+EdgeList erdosRenyi(const Options &options);
+
+// Recursive matrix (R-MAT) graph with the Graph500 Kronecker parameters
+// (0.57, 0.19, 0.19, 0.05): skewed, power-law degrees. Vertex ids are
+// shuffled so that hubs are not all at the front.
+EdgeList rmat(const Options &options);
+
+// Square grid with every neighbouring pair joined both ways, close to
+// sqrt(vertices) on a side; averageDegree is ignored
+EdgeList grid(const Options &options);
+
+// Random DAG: random pairs directed along a hidden random order. That order
+// is one topological order of the result; there are usually many others.
+EdgeList randomDag(const Options &options);
+
+// Flow network from source 0 to sink vertices - 1. The vertices between
+// are split into about sqrt(vertices) layers, the source feeds the first
+// and the last feeds the sink, and every vertex has averageDegree edges
+// into the next layer. Weights are capacities.
+EdgeList layeredFlowNetwork(const Options &options);
+
+// Random bipartite graph, edges from the first half of the vertices to the
+// second half
+EdgeList bipartite(const Options &options);
+
+// Runs the family of the given name, one of names()
+EdgeList generate(const std::string &family, const Options &options);
+const std::vector<std::string> &names();
+
+// Writes the graph as the JSON the graph loaders read
+void writeJson(const EdgeList &graph, const std::string &filename);
+
+}  // namespace GraphGenerator
+
+#endif /* GRAPH_GENERATOR_HPP */
@@ -0,0 +1,123 @@
+#ifndef GRAPH_LOADER_HPP
+#define GRAPH_LOADER_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * Read-only memory mapping of a whole file. The pages are loaded lazily by
+ * the kernel as they are touched, so nothing is copied into the process
+ * heap. Sequential mappings ask the kernel for aggressive read-ahead, which
+ * suits a parser; random mappings suit snapshots queried in place.
+ */
+class MappedFile {
+ private:
+  const char *bytes;
+  std::size_t length;
+
+ public:
+  explicit MappedFile(const std::string &filename, bool sequential = true);
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *data() const { return bytes; }
+  std::size_t size() const { return length; }
+};
+
+/**
+ * Streaming (SAX-style) reader for the lab's graph JSON schema:
+ *
+ *   { "vertices": N, "edges": [ { "from": a, "to": b, "weight": w }, ... ] }
+ *
+ * Flow networks may spell the weight "capacity" and give each edge a
+ * "cost" per unit of flow; a missing weight or cost reads as 0.
+ *
+ * Tokens are consumed straight from the input bytes and handed to callbacks
+ * as they are recognised; no document tree is built. Keys may appear in any
+ * order and unknown keys are skipped.
+ */
+class GraphJsonReader {
+ public:
+  struct EdgeRecord {
+    int from;
+    int to;
+    double weight;
+    double cost;
+  };
+
+ private:
+  const char *begin;
+  const char *pos;
+  const char *end;
+
+  [[noreturn]] void fail(const std::string &message) const;
+  [[noreturn]] void failExpected(char c) const;
+
+  // The tokenizer primitives run several times per edge, so they are kept
+  // inline; everything else lives in GraphLoader.cpp.
+  void skipWhitespace() {
+    while (pos != end &&
+           (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) {
+      ++pos;
+    }
+  }
+  char peek() {
+    skipWhitespace();
+    if (pos == end) fail("unexpected end of input");
+    return *pos;
+  }
+  void expect(char c) {
+    if (peek() != c) failExpected(c);
+    ++pos;
+  }
+  bool consume(char c) {
+    if (peek() != c) return false;
+    ++pos;
+    return true;
+  }
+  std::string_view parseString();
+  double parseNumber();
+  int parseInt();
+  void skipValue();
+  void parseEdge(EdgeRecord &edge);
+
+ public:
+  GraphJsonReader(const char *data, std::size_t size);
+  std::size_t estimateEdges() const;
+
+  /**
+   * Parses the whole document.
+   *
+   * @param onVertices Called with the value of "vertices".
+   * @param onEdge Called with every element of "edges", in file order.
+   */
+  template <typename OnVertices, typename OnEdge>
+  void parse(OnVertices onVertices, OnEdge onEdge) {
+    expect('{');
+    if (consume('}')) return;
+    do {
+      std::string_view key = parseString();
+      expect(':');
+      if (key == "vertices") {
+        onVertices(parseInt());
+      } else if (key == "edges") {
+        expect('[');
+        if (!consume(']')) {
+          EdgeRecord edge;
+          do {
+            parseEdge(edge);
+            onEdge(edge);
+          } while (consume(','));
+          expect(']');
+        }
+      } else {
+        skipValue();
+      }
+    } while (consume(','));
+    expect('}');
+  }
+};
+
+#endif /* GRAPH_LOADER_HPP */
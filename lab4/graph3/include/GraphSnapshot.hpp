@@ -0,0 +1,85 @@
+#ifndef GRAPH_SNAPSHOT_HPP
+#define GRAPH_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "GraphLoader.hpp"
+
+/**
+ * Binary snapshot format for frozen CSR graphs. All fields use the native
+ * (little-endian) byte order and every array starts on an 8-byte boundary,
+ * so a mapped file can be used in place:
+ *
+ *   Header
+ *   offsets  uint64 x (numVertices + 1)
+ *   targets  int32  x numEdges
+ *   weights  T      x numEdges
+ *   costs    T      x numEdges, only if costsStart is not 0
+ *   checksum uint64 chained over the offsets, targets, weights and costs
+ *
+ * Version 1 files end the header at checksumStart and never carry costs;
+ * they are still accepted.
+ */
+namespace GraphSnapshot {
+
+constexpr char MAGIC[8] = {'L', 'A', 'B', '4', 'C', 'S', 'R', '\0'};
+constexpr std::uint32_t VERSION = 2;
+
+enum class WeightType : std::uint32_t { Int32 = 1, Float32 = 2, Float64 = 3 };
+
+template <typename T>
+WeightType weightTypeOf();
+template <>
+WeightType weightTypeOf<int>();
+template <>
+WeightType weightTypeOf<float>();
+template <>
+WeightType weightTypeOf<double>();
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t weightType;
+  std::uint64_t numVertices;
+  std::uint64_t numEdges;
+  std::uint64_t offsetsStart;  // byte position of each array in the file
+  std::uint64_t targetsStart;
+  std::uint64_t weightsStart;
+  std::uint64_t checksumStart;
+  std::uint64_t costsStart;  // since version 2; 0 for graphs without costs
+};
+
+/**
+ * Fixed-size description of the arrays to write, filled in by the graph.
+ */
+struct Payload {
+  WeightType weightType;
+  std::uint64_t numVertices;
+  std::uint64_t numEdges;
+  const void *offsets;
+  const void *targets;
+  const void *weights;
+  const void *costs;  // nullptr for graphs without costs
+  std::size_t weightSize;
+};
+
+bool isSnapshot(const std::string &filename);
+std::uint64_t checksum(const void *data, std::size_t size,
+                       std::uint64_t seed);
+// Whether bytes starting at start end by limit, checked without the sum
+// wrapping around
+inline bool endsBy(std::uint64_t start, std::uint64_t bytes,
+                   std::uint64_t limit) {
+  return start <= limit && bytes <= limit - start;
+}
+bool isValidCsr(const std::uint64_t *offsets, const std::int32_t *targets,
+                std::uint64_t numVertices, std::uint64_t numEdges);
+void write(const std::string &filename, const Payload &payload);
+Header validate(const MappedFile &file, WeightType expected,
+                bool verifyChecksum);
+
+}  // namespace GraphSnapshot
+
+#endif /* GRAPH_SNAPSHOT_HPP */
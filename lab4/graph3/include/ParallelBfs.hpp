@@ -0,0 +1,92 @@
+#ifndef PARALLEL_BFS_HPP
+#define PARALLEL_BFS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ArrayView.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Unweighted CSR adjacency: the neighbours of v are
+ * targets[offsets[v]] .. targets[offsets[v + 1] - 1].
+ */
+struct CsrView {
+  ArrayView<std::size_t> offsets;
+  ArrayView<int> targets;
+};
+
+/**
+ * CSR adjacency owned by the caller, produced by ParallelBfs::transpose and
+ * ParallelBfs::symmetrize.
+ */
+struct Adjacency {
+  std::vector<std::size_t> offsets;
+  std::vector<int> targets;
+
+  CsrView view() const {
+    return {ArrayView<std::size_t>(offsets.data(), offsets.size()),
+            ArrayView<int>(targets.data(), targets.size())};
+  }
+};
+
+/**
+ * Level-synchronous breadth-first search that switches between top-down
+ * steps (the frontier claims its unvisited out-neighbours) and bottom-up
+ * steps (every unvisited vertex looks for a parent in the frontier), as in
+ * Beamer et al., "Direction-Optimizing Breadth-First Search". Visited
+ * vertices are tracked in a bitmap and every step is spread over a thread
+ * pool.
+ *
+ * The search keeps its visited set between calls to run(), so one engine
+ * can label all components of a graph.
+ */
+class ParallelBfs {
+ private:
+  using Word = std::uint64_t;
+  using Bitmap = std::unique_ptr<std::atomic<Word>[]>;
+
+  int numVertices;
+  std::size_t numWords;
+  CsrView out;
+  CsrView in;
+  ThreadPool &pool;
+
+  Bitmap visited;
+  Bitmap frontierBits;
+  Bitmap nextBits;
+  std::vector<int> frontier;
+  std::vector<std::vector<int>> localFrontiers;  // one per worker
+
+  // Sum of in-degrees over unvisited vertices, i.e. the work a bottom-up
+  // step may still have to do
+  std::size_t unexploredEdges;
+
+  struct StepStats {
+    std::size_t vertices = 0;
+    std::size_t outEdges = 0;
+    std::size_t inEdges = 0;
+  };
+
+  StepStats topDownStep(int depth, std::vector<int> &level);
+  StepStats bottomUpStep(int depth, std::vector<int> &level);
+  void queueToBitmap();
+  void bitmapToQueue();
+  static Bitmap makeBitmap(std::size_t words);
+
+ public:
+  ParallelBfs(int vertices, CsrView outEdges, CsrView inEdges,
+              ThreadPool &threads);
+
+  void run(int source, std::vector<int> &level);
+  bool isVisited(int v) const;
+
+  static Adjacency transpose(int vertices, CsrView edges, ThreadPool &threads);
+  static Adjacency symmetrize(int vertices, CsrView edges,
+                              ThreadPool &threads);
+};
+
+#endif /* PARALLEL_BFS_HPP */
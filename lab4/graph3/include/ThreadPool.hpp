@@ -0,0 +1,72 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads that run data-parallel loops. The calling
+ * thread takes part in every loop as worker 0, so a pool of size 1 runs
+ * everything inline. Loops issued from inside a running loop are executed
+ * serially by the issuing worker instead of deadlocking.
+ */
+class ThreadPool {
+ private:
+  std::vector<std::thread> workers;
+  std::mutex loopMutex;  // one loop at a time when several threads share it
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  const std::function<void(unsigned)> *task;
+  unsigned long generation;
+  unsigned pending;
+  bool stopping;
+  std::exception_ptr failure;
+
+  void workerLoop(unsigned index);
+  void runOnAll(const std::function<void(unsigned)> &body);
+  static bool insideLoop();
+
+ public:
+  explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency());
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+  static ThreadPool &shared();
+
+  /**
+   * Splits [begin, end) into chunks of at most grain indices that the
+   * threads claim dynamically, which keeps skewed work balanced.
+   *
+   * @param body Called as body(lo, hi, worker) with worker < size().
+   */
+  template <typename Body>
+  void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                   Body body) {
+    if (begin >= end) return;
+    grain = std::max<std::size_t>(grain, 1);
+    if (end - begin <= grain || size() == 1 || insideLoop()) {
+      body(begin, end, 0u);
+      return;
+    }
+    std::atomic<std::size_t> next(begin);
+    std::function<void(unsigned)> chunkLoop = [&](unsigned worker) {
+      for (std::size_t lo = next.fetch_add(grain); lo < end;
+           lo = next.fetch_add(grain)) {
+        body(lo, std::min(lo + grain, end), worker);
+      }
+    };
+    runOnAll(chunkLoop);
+  }
+};
+
+#endif /* THREAD_POOL_HPP */
@@ -0,0 +1,148 @@
+#include "../include/BipartiteMatching.hpp"
+
+#include <limits>
+
+namespace {
+
+constexpr int UNREACHED = std::numeric_limits<int>::max();
+
+}  // namespace
+
+/**
+ * @param vertices Number of vertices on both sides together.
+ * @param undirected Adjacency listing every edge at both endpoints.
+ * @param side 0 for left and 1 for right vertices; must outlive the engine.
+ */
+BipartiteMatching::BipartiteMatching(int vertices, CsrView undirected,
+                                     const std::vector<int> &side)
+    : numVertices(vertices),
+      edges(undirected),
+      side(side),
+      mate(vertices, -1),
+      layer(vertices, UNREACHED),
+      nextEdge(vertices, 0),
+      freeLayer(UNREACHED) {}
+
+/**
+ * Computes a maximum matching.
+ *
+ * @param matching Output: the partner of every vertex, -1 if unmatched.
+ * @return int The number of matched pairs.
+ */
+int BipartiteMatching::run(std::vector<int> &matching) {
+  matchGreedily();
+  while (buildLayers()) {
+    for (int u = 0; u < numVertices; ++u) {
+      if (side[u] == 0) nextEdge[u] = edges.offsets[u];
+    }
+    for (int u = 0; u < numVertices; ++u) {
+      if (side[u] == 0 && mate[u] == -1) augment(u);
+    }
+  }
+
+  int pairs = 0;
+  for (int u = 0; u < numVertices; ++u) {
+    if (side[u] == 0 && mate[u] != -1) ++pairs;
+  }
+  matching = mate;
+  return pairs;
+}
+
+/**
+ * Matches every left vertex to its first free neighbour. This settles
+ * most of the matching in one linear pass and leaves the phases only the
+ * contested vertices.
+ */
+void BipartiteMatching::matchGreedily() {
+  for (int u = 0; u < numVertices; ++u) {
+    if (side[u] != 0) continue;
+    for (std::size_t e = edges.offsets[u]; e < edges.offsets[u + 1]; ++e) {
+      int v = edges.targets[e];
+      if (mate[v] == -1) {
+        mate[u] = v;
+        mate[v] = u;
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * Breadth-first search from all free left vertices at once, stepping from
+ * a left vertex over any edge and back along the matched edge of the right
+ * vertex it reaches. Left vertices get their distance in layer; the search
+ * stops expanding past the layer that first reaches a free right vertex.
+ *
+ * @return bool True if an augmenting path exists.
+ */
+bool BipartiteMatching::buildLayers() {
+  queue.clear();
+  for (int u = 0; u < numVertices; ++u) {
+    if (side[u] != 0) continue;
+    if (mate[u] == -1) {
+      layer[u] = 0;
+      queue.push_back(u);
+    } else {
+      layer[u] = UNREACHED;
+    }
+  }
+
+  freeLayer = UNREACHED;
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    int u = queue[i];
+    if (layer[u] >= freeLayer) break;
+    for (std::size_t e = edges.offsets[u]; e < edges.offsets[u + 1]; ++e) {
+      int w = mate[edges.targets[e]];
+      if (w == -1) {
+        freeLayer = layer[u];
+      } else if (layer[w] == UNREACHED) {
+        layer[w] = layer[u] + 1;
+        queue.push_back(w);
+      }
+    }
+  }
+  return freeLayer != UNREACHED;
+}
+
+/**
+ * Depth-first search with an explicit stack for a shortest augmenting path
+ * from a free left vertex, following the layers built by buildLayers. The
+ * per-vertex edge cursors persist through the phase, and dead ends leave
+ * the layering, so every edge is tried at most once per phase.
+ *
+ * @param root A free left vertex.
+ * @return bool True if the matching grew by one.
+ */
+bool BipartiteMatching::augment(int root) {
+  path.clear();
+  via.clear();
+  path.push_back(root);
+  while (!path.empty()) {
+    int u = path.back();
+    if (nextEdge[u] == edges.offsets[u + 1]) {
+      layer[u] = UNREACHED;
+      path.pop_back();
+      if (!via.empty()) via.pop_back();
+      continue;
+    }
+
+    int v = edges.targets[nextEdge[u]++];
+    int w = mate[v];
+    if (w == -1) {
+      if (layer[u] != freeLayer) continue;
+      // Flip the path: every left vertex on it takes the right vertex it
+      // left through
+      via.push_back(v);
+      for (std::size_t i = 0; i < path.size(); ++i) {
+        mate[path[i]] = via[i];
+        mate[via[i]] = path[i];
+      }
+      return true;
+    }
+    if (layer[w] == layer[u] + 1) {
+      via.push_back(v);
+      path.push_back(w);
+    }
+  }
+  return false;
+}
@@ -0,0 +1,733 @@
+#include "../include/FlowNetwork.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+template <typename T>
+FlowNetwork<T>::FlowNetwork(int vertices) : numVertices(vertices) {}
+
+/**
+ * Records an arc with the given capacity. Arcs without positive capacity
+ * can never carry flow and are dropped, and so are self-loops.
+ *
+ * @param from Tail of the arc.
+ * @param to Head of the arc.
+ * @param capacity Capacity of the arc.
+ * @param cost Cost per unit of flow, only used by the min-cost searches.
+ */
+template <typename T>
+void FlowNetwork<T>::addArc(int from, int to, T capacity, T cost) {
+  if (capacity > 0 && from != to) {
+    pendingArcs.push_back({from, to, capacity, cost});
+  }
+}
+
+/**
+ * Lays the forward and reverse arcs out in CSR order and links each arc to
+ * its partner. Must be called once after all arcs were added.
+ */
+template <typename T>
+void FlowNetwork<T>::build() {
+  offsets.assign(numVertices + 1, 0);
+  for (const auto &arc : pendingArcs) {
+    ++offsets[arc.from + 1];
+    ++offsets[arc.to + 1];
+  }
+  for (int v = 0; v < numVertices; ++v) {
+    offsets[v + 1] += offsets[v];
+  }
+
+  std::size_t arcs = offsets[numVertices];
+  head.resize(arcs);
+  reverse.resize(arcs);
+  residual.resize(arcs);
+  cost.resize(arcs);
+
+  std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+  for (const auto &arc : pendingArcs) {
+    std::size_t forward = next[arc.from]++;
+    std::size_t backward = next[arc.to]++;
+    head[forward] = arc.to;
+    head[backward] = arc.from;
+    residual[forward] = arc.capacity;
+    residual[backward] = 0;
+    cost[forward] = arc.cost;
+    cost[backward] = -arc.cost;
+    reverse[forward] = static_cast<int>(backward);
+    reverse[backward] = static_cast<int>(forward);
+  }
+  std::vector<PendingArc>().swap(pendingArcs);
+}
+
+/* -------------------------------- Dinic ------------------------------- */
+
+/**
+ * Breadth-first search from the source over usable arcs with residual
+ * capacity, labelling every reached vertex with its distance.
+ *
+ * @param level Output vector, -1 for unreached vertices.
+ * @param usable Predicate on (tail, arc) that an arc must pass as well.
+ * @return bool True if the sink is reachable.
+ */
+template <typename T>
+template <typename Usable>
+bool FlowNetwork<T>::buildLevels(int source, int sink, std::vector<int> &level,
+                                 Usable usable) const {
+  std::fill(level.begin(), level.end(), -1);
+  std::vector<int> queue;
+  queue.reserve(numVertices);
+  queue.push_back(source);
+  level[source] = 0;
+
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    int u = queue[i];
+    if (u == sink) break;
+    for (std::size_t a = offsets[u]; a < offsets[u + 1]; ++a) {
+      int v = head[a];
+      if (level[v] == -1 && residual[a] > 0 && usable(u, a)) {
+        level[v] = level[u] + 1;
+        queue.push_back(v);
+      }
+    }
+  }
+  return level[sink] != -1;
+}
+
+/**
+ * Saturates the level graph with an iterative depth-first search. Each
+ * vertex keeps a current-arc pointer that only moves forward, so every arc
+ * is skipped at most once per phase and the search never recurses.
+ *
+ * @param level Levels computed by buildLevels.
+ * @param usable The predicate buildLevels was given.
+ * @return T The flow added in this phase.
+ */
+template <typename T>
+template <typename Usable>
+T FlowNetwork<T>::blockingFlow(int source, int sink,
+                               const std::vector<int> &level, Usable usable) {
+  std::vector<std::size_t> current(offsets.begin(), offsets.end() - 1);
+  std::vector<std::size_t> path;
+  T total = 0;
+  int u = source;
+
+  while (true) {
+    if (u == sink) {
+      T pushed = std::numeric_limits<T>::max();
+      for (std::size_t a : path) pushed = std::min(pushed, residual[a]);
+
+      size_t firstSaturated = path.size();
+      for (size_t i = 0; i < path.size(); ++i) {
+        std::size_t a = path[i];
+        residual[a] -= pushed;
+        residual[reverse[a]] += pushed;
+        if (firstSaturated == path.size() && !(residual[a] > 0)) {
+          firstSaturated = i;
+        }
+      }
+      total += pushed;
+
+      // Resume from the tail of the first saturated arc
+      path.resize(firstSaturated);
+      u = path.empty() ? source : head[path.back()];
+      continue;
+    }
+
+    std::size_t &a = current[u];
+    std::size_t end = offsets[u + 1];
+    while (a < end && !(residual[a] > 0 && level[head[a]] == level[u] + 1 &&
+                        usable(u, a))) {
+      ++a;
+    }
+
+    if (a < end) {
+      path.push_back(a);
+      u = head[a];
+    } else {
+      // Dead end: retreat and skip the arc that led here
+      if (u == source) break;
+      std::size_t back = path.back();
+      path.pop_back();
+      u = head[reverse[back]];
+      ++current[u];
+    }
+  }
+  return total;
+}
+
+/**
+ * Computes the maximum flow with Dinic's algorithm.
+ *
+ * @return T The maximum flow value from source to sink.
+ */
+template <typename T>
+T FlowNetwork<T>::dinic(int source, int sink) {
+  auto anyArc = [](int, std::size_t) { return true; };
+  std::vector<int> level(numVertices);
+  T flow = 0;
+  while (buildLevels(source, sink, level, anyArc)) {
+    flow += blockingFlow(source, sink, level, anyArc);
+  }
+  return flow;
+}
+
+/* ---------------------------- Push-relabel ---------------------------- */
+
+/**
+ * Sets every height to the exact residual distance to the sink, or to
+ * numVertices for vertices that can no longer reach it. The source is pinned
+ * at numVertices and never used as a stepping stone.
+ *
+ * @param height Output vector of vertex heights.
+ */
+template <typename T>
+void FlowNetwork<T>::globalRelabel(int source, int sink,
+                                   std::vector<int> &height) const {
+  std::fill(height.begin(), height.end(), numVertices);
+  std::vector<int> queue;
+  queue.reserve(numVertices);
+  queue.push_back(sink);
+  height[sink] = 0;
+
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    int v = queue[i];
+    for (std::size_t a = offsets[v]; a < offsets[v + 1]; ++a) {
+      int w = head[a];
+      // w can push to v if the reverse of a (w -> v) has capacity
+      if (height[w] == numVertices && w != source &&
+          residual[reverse[a]] > 0) {
+        height[w] = height[v] + 1;
+        queue.push_back(w);
+      }
+    }
+  }
+}
+
+/**
+ * Computes the maximum flow value with highest-label push-relabel. Only the
+ * first phase is run (a maximum preflow), since the flow value is the excess
+ * that reached the sink. Active vertices are kept in buckets by height and
+ * the highest one is always discharged next. When relabeling empties a
+ * height, every vertex above that gap is lifted out of play at once, and the
+ * heights are recomputed from scratch after O(V + E) relabeling work.
+ *
+ * @return T The maximum flow value from source to sink.
+ */
+template <typename T>
+T FlowNetwork<T>::pushRelabel(int source, int sink) {
+  const int n = numVertices;
+  std::vector<int> height(n);
+  std::vector<T> excess(n, 0);
+  std::vector<std::size_t> current(offsets.begin(), offsets.end() - 1);
+  std::vector<std::vector<int>> active(n);
+  int highest = 0;
+
+  // Every vertex below height n sits in a doubly linked list for its
+  // height, so a gap lifts just the vertices above it instead of scanning
+  // all of them
+  std::vector<int> layerHead(n, -1), layerNext(n), layerPrev(n);
+  int topLayer = -1;  // no list above this height is non-empty
+
+  auto addToLayer = [&](int v) {
+    int h = height[v];
+    layerPrev[v] = -1;
+    layerNext[v] = layerHead[h];
+    if (layerHead[h] >= 0) layerPrev[layerHead[h]] = v;
+    layerHead[h] = v;
+    topLayer = std::max(topLayer, h);
+  };
+  auto removeFromLayer = [&](int v) {
+    if (layerPrev[v] >= 0) {
+      layerNext[layerPrev[v]] = layerNext[v];
+    } else {
+      layerHead[height[v]] = layerNext[v];
+    }
+    if (layerNext[v] >= 0) layerPrev[layerNext[v]] = layerPrev[v];
+  };
+
+  auto activate = [&](int v) {
+    if (v != source && v != sink && height[v] < n) {
+      active[height[v]].push_back(v);
+      highest = std::max(highest, height[v]);
+    }
+  };
+
+  auto relabelAll = [&]() {
+    globalRelabel(source, sink, height);
+    std::fill(layerHead.begin(), layerHead.end(), -1);
+    topLayer = -1;
+    for (int v = 0; v < n; ++v) {
+      if (height[v] < n) addToLayer(v);
+    }
+    for (auto &bucket : active) bucket.clear();
+    highest = 0;
+    for (int v = 0; v < n; ++v) {
+      if (excess[v] > 0) activate(v);
+      current[v] = offsets[v];
+    }
+  };
+
+  std::vector<int> level(n);
+  if (!buildLevels(source, sink, level,
+                   [](int, std::size_t) { return true; })) {
+    return 0;
+  }
+
+  for (std::size_t a = offsets[source]; a < offsets[source + 1]; ++a) {
+    T delta = residual[a];
+    if (!(delta > 0)) continue;
+    residual[a] -= delta;
+    residual[reverse[a]] += delta;
+    excess[head[a]] += delta;
+  }
+  relabelAll();
+
+  const std::size_t relabelPeriod = 6 * static_cast<std::size_t>(n) +
+                                    offsets[n] / 2;
+  std::size_t work = 0;
+
+  while (highest >= 0) {
+    if (active[highest].empty()) {
+      --highest;
+      continue;
+    }
+    int u = active[highest].back();
+    active[highest].pop_back();
+    if (height[u] != highest || !(excess[u] > 0)) continue;
+
+    // Discharge u
+    while (excess[u] > 0) {
+      std::size_t &a = current[u];
+      if (a == offsets[u + 1]) {
+        // Relabel to one above the lowest residual neighbour
+        int newHeight = n;
+        for (std::size_t b = offsets[u]; b < offsets[u + 1]; ++b) {
+          if (residual[b] > 0) {
+            newHeight = std::min(newHeight, height[head[b]] + 1);
+          }
+        }
+        work += offsets[u + 1] - offsets[u] + 12;
+        int oldHeight = height[u];
+        a = offsets[u];
+        removeFromLayer(u);
+
+        if (layerHead[oldHeight] < 0) {
+          // Gap: nothing above oldHeight can reach the sink any more
+          for (int h = oldHeight + 1; h <= topLayer; ++h) {
+            for (int v = layerHead[h]; v >= 0; v = layerNext[v]) height[v] = n;
+            layerHead[h] = -1;
+          }
+          topLayer = oldHeight - 1;
+          height[u] = n;
+          break;
+        }
+        height[u] = newHeight;
+        if (newHeight >= n) break;
+        addToLayer(u);
+        continue;
+      }
+
+      int v = head[a];
+      if (residual[a] > 0 && height[u] == height[v] + 1) {
+        T delta = std::min(excess[u], residual[a]);
+        bool wasIdle = !(excess[v] > 0);
+        residual[a] -= delta;
+        residual[reverse[a]] += delta;
+        excess[u] -= delta;
+        excess[v] += delta;
+        if (wasIdle) activate(v);
+        if (!(residual[a] > 0)) ++a;
+      } else {
+        ++a;
+      }
+    }
+
+    if (excess[u] > 0 && height[u] < n) activate(u);
+    if (work > relabelPeriod) {
+      work = 0;
+      relabelAll();
+    }
+  }
+  return excess[sink];
+}
+
+/* ---------------------------- Min-cost flow --------------------------- */
+
+/**
+ * Bellman-Ford from a virtual vertex joined to every vertex at cost 0, over
+ * the arcs with residual capacity. The distances make every reduced cost
+ * non-negative, which is what Dijkstra needs. Only called when some arc
+ * costs less than 0.
+ *
+ * @param potential Output vector of vertex potentials.
+ * @throws std::invalid_argument If the network has a negative-cost cycle.
+ */
+template <typename T>
+void FlowNetwork<T>::initialPotentials(std::vector<T> &potential) const {
+  const int n = numVertices;
+  std::fill(potential.begin(), potential.end(), T());
+  std::vector<int> length(n, 0);  // arcs on the path behind potential[v]
+  std::vector<char> queued(n, 1);
+  std::deque<int> queue;
+  for (int v = 0; v < n; ++v) queue.push_back(v);
+
+  while (!queue.empty()) {
+    int u = queue.front();
+    queue.pop_front();
+    queued[u] = 0;
+    for (std::size_t a = offsets[u]; a < offsets[u + 1]; ++a) {
+      int v = head[a];
+      if (residual[a] > 0 && potential[u] + cost[a] < potential[v]) {
+        potential[v] = potential[u] + cost[a];
+        length[v] = length[u] + 1;
+        if (length[v] >= n) {
+          throw std::invalid_argument(
+              "Min-cost flow needs a network without negative-cost cycles");
+        }
+        if (!queued[v]) {
+          queued[v] = 1;
+          queue.push_back(v);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Dijkstra from the source on reduced costs, stopping once the sink is
+ * settled, followed by the potential update: every vertex moves by its
+ * distance, capped at the distance of the sink. Reduced costs stay
+ * non-negative and the arcs of every shortest path drop to exactly 0.
+ *
+ * @param potential Vertex potentials, updated in place.
+ * @param parent Output: the tree arc into every settled vertex.
+ * @return bool True if the sink is reachable.
+ */
+template <typename T>
+bool FlowNetwork<T>::updatePotentials(int source, int sink,
+                                      std::vector<T> &potential,
+                                      std::vector<std::size_t> &parent) const {
+  const T INF = std::numeric_limits<T>::max();
+  std::vector<T> dist(numVertices, INF);
+  using Entry = std::pair<T, int>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+  dist[source] = 0;
+  heap.push({0, source});
+
+  while (!heap.empty()) {
+    auto [d, u] = heap.top();
+    heap.pop();
+    if (d > dist[u]) continue;
+    if (u == sink) break;
+    for (std::size_t a = offsets[u]; a < offsets[u + 1]; ++a) {
+      if (!(residual[a] > 0)) continue;
+      int v = head[a];
+      T next = d + cost[a] + potential[u] - potential[v];
+      if (next < dist[v]) {
+        dist[v] = next;
+        parent[v] = a;
+        heap.push({next, v});
+      }
+    }
+  }
+  if (dist[sink] == INF) return false;
+
+  for (int v = 0; v < numVertices; ++v) {
+    potential[v] += std::min(dist[v], dist[sink]);
+  }
+  return true;
+}
+
+/**
+ * Pushes the bottleneck capacity along the shortest path tree from the
+ * source to the sink.
+ *
+ * @param parent Tree arcs recorded by updatePotentials.
+ * @return T The flow pushed.
+ */
+template <typename T>
+T FlowNetwork<T>::augmentPath(int source, int sink,
+                              const std::vector<std::size_t> &parent) {
+  T pushed = std::numeric_limits<T>::max();
+  for (int v = sink; v != source; v = head[reverse[parent[v]]]) {
+    pushed = std::min(pushed, residual[parent[v]]);
+  }
+  for (int v = sink; v != source; v = head[reverse[parent[v]]]) {
+    residual[parent[v]] -= pushed;
+    residual[reverse[parent[v]]] += pushed;
+  }
+  return pushed;
+}
+
+/**
+ * Sums residual capacity times cost over all arcs. Moving one unit of flow
+ * along an arc of cost c changes the sum by -2c, since the arc loses the
+ * unit and its reverse of cost -c gains it, so half the drop of this sum
+ * is the cost of the flow pushed in between.
+ *
+ * @return CostSum The sum.
+ */
+template <typename T>
+typename FlowNetwork<T>::CostSum FlowNetwork<T>::residualCost() const {
+  CostSum sum = 0;
+  for (std::size_t a = 0; a < residual.size(); ++a) {
+    sum += static_cast<CostSum>(residual[a]) * static_cast<CostSum>(cost[a]);
+  }
+  return sum;
+}
+
+/**
+ * Computes a maximum flow of minimum cost with successive shortest paths
+ * (the primal-dual method). Johnson potentials keep every reduced cost
+ * non-negative, so each round is one Dijkstra search, and all shortest
+ * paths of a round are then saturated together with a Dinic blocking flow
+ * over the arcs whose reduced cost is 0. Each round costs O(E log V) plus
+ * the blocking flow, and there is one round per distinct path length.
+ *
+ * @param totalCost Output: the cost of the flow.
+ * @return T The maximum flow value from source to sink.
+ * @throws std::invalid_argument If the network has a negative-cost cycle.
+ */
+template <typename T>
+T FlowNetwork<T>::successiveShortestPaths(int source, int sink,
+                                          T &totalCost) {
+  const int n = numVertices;
+  std::vector<T> potential(n, T());
+  if (std::any_of(cost.begin(), cost.end(), [](T c) { return c < 0; })) {
+    initialPotentials(potential);
+  }
+
+  CostSum before = residualCost();
+  std::vector<std::size_t> parent(n);
+  std::vector<int> level(n);
+  auto tight = [&](int u, std::size_t a) {
+    return !(cost[a] + potential[u] - potential[head[a]] > 0);
+  };
+
+  T flow = 0;
+  while (updatePotentials(source, sink, potential, parent)) {
+    T pushed = 0;
+    if (buildLevels(source, sink, level, tight)) {
+      pushed = blockingFlow(source, sink, level, tight);
+    }
+    // Floating-point rounding can leave a tree arc a hair above 0
+    if (!(pushed > 0)) pushed = augmentPath(source, sink, parent);
+    flow += pushed;
+  }
+  totalCost = static_cast<T>((before - residualCost()) / 2);
+  return flow;
+}
+
+/**
+ * Global price update for cost scaling. Lowering the price of v by epsilon
+ * times k makes a residual arc v -> w admissible once k exceeds its
+ * reduced cost divided by epsilon, so a Dijkstra search backwards from the
+ * deficit vertices with those arc lengths finds, for every vertex, the
+ * smallest drop that opens an admissible path to a deficit. The lengths
+ * are small integers, so the search runs over an array of buckets.
+ *
+ * The search may stop at any level: vertices it has not settled drop as
+ * far as that level, which keeps every reduced cost above -epsilon. It
+ * stops once every vertex with excess is settled, or after numVertices
+ * levels. One pass replaces the many relabels that would otherwise lower
+ * the same prices one epsilon at a time.
+ *
+ * @param epsilon Current optimality, in scaled cost units.
+ * @param scaled Arc costs multiplied by numVertices + 1.
+ * @param excess Excess of every vertex, negative for deficits.
+ * @param price Vertex prices, updated in place.
+ */
+template <typename T>
+void FlowNetwork<T>::updatePrices(long long epsilon,
+                                  const std::vector<long long> &scaled,
+                                  const std::vector<T> &excess,
+                                  std::vector<long long> &price) const {
+  const int n = numVertices;
+  const long long UNREACHED = std::numeric_limits<long long>::max();
+  std::vector<long long> dist(n, UNREACHED);
+  std::vector<char> settled(n, 0);
+
+  // Bucket d is a linked list of (vertex, next entry) pairs; entries made
+  // stale by a shorter distance are skipped when popped
+  std::vector<int> bucket(n + 1, -1);
+  std::vector<std::pair<int, int>> entries;
+  auto enqueue = [&](int v, long long d) {
+    entries.push_back({v, bucket[d]});
+    bucket[d] = static_cast<int>(entries.size()) - 1;
+  };
+
+  int waiting = 0;
+  for (int v = 0; v < n; ++v) {
+    if (excess[v] < 0) {
+      dist[v] = 0;
+      enqueue(v, 0);
+    } else if (excess[v] > 0) {
+      ++waiting;
+    }
+  }
+
+  long long level = 0;
+  for (; level <= n && waiting > 0; ++level) {
+    while (bucket[level] != -1 && waiting > 0) {
+      auto [w, next] = entries[bucket[level]];
+      bucket[level] = next;
+      if (settled[w] || dist[w] != level) continue;
+      settled[w] = 1;
+      if (excess[w] > 0) --waiting;
+      for (std::size_t b = offsets[w]; b < offsets[w + 1]; ++b) {
+        int v = head[b];
+        std::size_t a = reverse[b];  // v -> w
+        if (settled[v] || !(residual[a] > 0)) continue;
+        long long reduced = scaled[a] + price[v] - price[w];
+        long long d = level + (reduced < 0 ? 0 : reduced / epsilon + 1);
+        if (d < dist[v] && d <= n) {
+          dist[v] = d;
+          enqueue(v, d);
+        }
+      }
+    }
+    if (waiting == 0) break;
+  }
+  level = std::min<long long>(level, n);
+  for (int v = 0; v < n; ++v) {
+    price[v] -= epsilon * (settled[v] ? dist[v] : level);
+  }
+}
+
+/**
+ * One refinement of cost scaling: turns a flow that is optimal to within
+ * 8 epsilon into one that is optimal to within epsilon. Every arc with
+ * negative reduced cost is saturated, and the excess this creates is
+ * pushed along arcs with negative reduced cost in FIFO order, lowering the
+ * price of a vertex by at least epsilon whenever it has none left. Prices
+ * are updated globally before the first push and after every numVertices
+ * relabels.
+ *
+ * @param epsilon Target optimality, in scaled cost units.
+ * @param scaled Arc costs multiplied by numVertices + 1.
+ * @param price Vertex prices, updated in place.
+ */
+template <typename T>
+void FlowNetwork<T>::refine(long long epsilon,
+                            const std::vector<long long> &scaled,
+                            std::vector<long long> &price) {
+  const int n = numVertices;
+  std::vector<T> excess(n, T());
+  for (int u = 0; u < n; ++u) {
+    for (std::size_t a = offsets[u]; a < offsets[u + 1]; ++a) {
+      if (residual[a] > 0 && scaled[a] + price[u] - price[head[a]] < 0) {
+        T delta = residual[a];
+        residual[a] = 0;
+        residual[reverse[a]] += delta;
+        excess[u] -= delta;
+        excess[head[a]] += delta;
+      }
+    }
+  }
+
+  std::vector<std::size_t> current(n);
+  std::deque<int> active;
+  for (int u = 0; u < n; ++u) {
+    if (excess[u] > 0) active.push_back(u);
+  }
+  int relabels = n;
+
+  while (!active.empty()) {
+    if (relabels >= n) {
+      // Lower prices can make skipped arcs admissible again
+      updatePrices(epsilon, scaled, excess, price);
+      std::copy(offsets.begin(), offsets.end() - 1, current.begin());
+      relabels = 0;
+    }
+    int u = active.front();
+    active.pop_front();
+    while (excess[u] > 0) {
+      std::size_t &a = current[u];
+      if (a == offsets[u + 1]) {
+        // Relabel: the best residual arc becomes admissible at -epsilon
+        long long best = std::numeric_limits<long long>::min();
+        for (std::size_t b = offsets[u]; b < offsets[u + 1]; ++b) {
+          if (residual[b] > 0) {
+            best = std::max(best, price[head[b]] - scaled[b]);
+          }
+        }
+        price[u] = best - epsilon;
+        a = offsets[u];
+        ++relabels;
+        continue;
+      }
+
+      int v = head[a];
+      if (residual[a] > 0 && scaled[a] + price[u] - price[v] < 0) {
+        T delta = std::min(excess[u], residual[a]);
+        bool wasIdle = !(excess[v] > 0);
+        residual[a] -= delta;
+        residual[reverse[a]] += delta;
+        excess[u] -= delta;
+        excess[v] += delta;
+        if (wasIdle && excess[v] > 0) active.push_back(v);
+      } else {
+        ++a;
+      }
+    }
+  }
+}
+
+/**
+ * Computes a maximum flow of minimum cost with Goldberg-Tarjan cost
+ * scaling. A maximum flow is found first with Dinic, and the min-cost
+ * circulation in its residual network is then found by successive
+ * epsilon refinements; a circulation never changes the flow value. Costs
+ * are scaled by numVertices + 1 so that epsilon = 1 proves optimality,
+ * and epsilon shrinks 8-fold per refinement, giving O(log(VC)) of them.
+ * Unlike successive shortest paths the running time does not grow with
+ * the number of distinct path lengths, which suits large instances.
+ *
+ * The scaling argument needs integral costs, so floating-point networks
+ * are solved with successiveShortestPaths instead.
+ *
+ * @param totalCost Output: the cost of the flow.
+ * @return T The maximum flow value from source to sink.
+ * @throws std::invalid_argument If the network has a negative-cost cycle.
+ */
+template <typename T>
+T FlowNetwork<T>::costScaling(int source, int sink, T &totalCost) {
+  if constexpr (!std::is_integral_v<T>) {
+    return successiveShortestPaths(source, sink, totalCost);
+  } else {
+    const int n = numVertices;
+    if (std::any_of(cost.begin(), cost.end(), [](T c) { return c < 0; })) {
+      // Cost scaling would cancel such cycles instead of reporting them
+      std::vector<T> potential(n);
+      initialPotentials(potential);
+    }
+
+    CostSum before = residualCost();
+    T flow = dinic(source, sink);
+
+    std::vector<long long> scaled(cost.size());
+    long long epsilon = 0;
+    for (std::size_t a = 0; a < cost.size(); ++a) {
+      scaled[a] = static_cast<long long>(cost[a]) * (n + 1);
+      epsilon = std::max(epsilon, scaled[a]);
+    }
+    std::vector<long long> price(n, 0);
+    while (epsilon > 1) {
+      epsilon = std::max(1LL, epsilon / 8);
+      refine(epsilon, scaled, price);
+    }
+
+    totalCost = static_cast<T>((before - residualCost()) / 2);
+    return flow;
+  }
+}
+
+// Explicit template instantiation
+template class FlowNetwork<int>;
+template class FlowNetwork<float>;
+template class FlowNetwork<double>;
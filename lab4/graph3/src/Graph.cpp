@@ -1,22 +1,58 @@
 #include "Graph.hpp"
 
-// Try multiple possible paths for json.hpp
-#if __has_include(<nlohmann/json.hpp>)
-#include <nlohmann/json.hpp>
-#elif __has_include("../../deps/nlohmann/json.hpp")
-#include "../../deps/nlohmann/json.hpp"
-#endif
-
 /**
- * The Graph constructor reads a graph from a file.
+ * The Graph constructor reads a graph from a file, either JSON or a binary
+ * snapshot written by save().
  *
  * @param filename The filename parameter is a string that
  * represents the name of the file from which the graph
  * data will be read.
  */
 template <typename T>
-Graph<T>::Graph(const std::string &filename) {
-  readGraphFromJson(filename);
+Graph<T>::Graph(const std::string &filename)
+    : numVertices(0), finalized(false) {
+  readGraphFromFile(filename);
+}
+
+/**
+ * The Graph constructor creates an empty graph with a fixed number of
+ * vertices, to be filled with addEdge and then finalized.
+ *
+ * @param vertices The number of vertices in the graph.
+ */
+template <typename T>
+Graph<T>::Graph(int vertices) : numVertices(vertices), finalized(false) {}
+
+template <typename T>
+Graph<T>::Graph() : numVertices(0), finalized(false) {}
+
+template <typename T>
+Graph<T>::Graph(const Graph &other) : numVertices(0), finalized(false) {
+  *this = other;
+}
+
+/**
+ * Copies the graph. A graph built in memory gets its own arrays and rebinds
+ * its views to them; a snapshot-backed graph shares the read-only mapping.
+ */
+template <typename T>
+Graph<T> &Graph<T>::operator=(const Graph &other) {
+  if (this == &other) return *this;
+  pendingEdges = other.pendingEdges;
+  offsetStorage = other.offsetStorage;
+  targetStorage = other.targetStorage;
+  weightStorage = other.weightStorage;
+  costStorage = other.costStorage;
+  snapshot = other.snapshot;
+  reverseEdges = std::atomic_load(&other.reverseEdges);
+  numVertices = other.numVertices;
+  finalized = other.finalized;
+  offsets = other.offsets;
+  targets = other.targets;
+  weights = other.weights;
+  costs = other.costs;
+  if (!snapshot) bindStorage();
+  return *this;
 }
 
 /**
@@ -30,10 +66,165 @@ Graph<T>::Graph(const std::string &filename) {
  * with the edge between the "from" vertex and the "to" vertex. It can be any
  * value that represents the cost or weight of the edge, such as a numerical
  * value or an object that encapsulates the weight information.
+ * @param cost Cost per unit of flow, used by getMinCostFlow. Graphs whose
+ * edges all cost 0 store no cost array.
+ */
+template <typename T>
+void Graph<T>::addEdge(int from, int to, T weight, T cost) {
+  if (finalized) {
+    throw std::logic_error("Cannot add edges to a finalized graph");
+  }
+  if (from < 0 || from >= numVertices || to < 0 || to >= numVertices) {
+    throw std::out_of_range("Edge endpoint out of range");
+  }
+  pendingEdges.push_back({from, to, weight, cost});
+}
+
+/**
+ * The function freezes the graph into compressed sparse row form. Edges are
+ * bucketed by source with a counting sort, so every vertex keeps its edges
+ * in insertion order, and the builder buffer is released afterwards.
+ * Calling it again is a no-op.
+ */
+template <typename T>
+void Graph<T>::finalize() {
+  if (finalized) return;
+
+  offsetStorage.assign(numVertices + 1, 0);
+  for (const auto &edge : pendingEdges) {
+    ++offsetStorage[edge.from + 1];
+  }
+  for (int v = 0; v < numVertices; ++v) {
+    offsetStorage[v + 1] += offsetStorage[v];
+  }
+
+  bool costed = std::any_of(pendingEdges.begin(), pendingEdges.end(),
+                            [](const Edge &edge) { return edge.cost != T(); });
+  targetStorage.resize(pendingEdges.size());
+  weightStorage.resize(pendingEdges.size());
+  costStorage.resize(costed ? pendingEdges.size() : 0);
+  std::vector<std::size_t> next(offsetStorage.begin(), offsetStorage.end() - 1);
+  for (const auto &edge : pendingEdges) {
+    std::size_t slot = next[edge.from]++;
+    targetStorage[slot] = edge.to;
+    weightStorage[slot] = edge.weight;
+    if (costed) costStorage[slot] = edge.cost;
+  }
+
+  std::vector<Edge>().swap(pendingEdges);
+  bindStorage();
+  finalized = true;
+}
+
+/**
+ * Points the CSR views at the storage vectors owned by this graph.
+ */
+template <typename T>
+void Graph<T>::bindStorage() {
+  offsets = ArrayView<std::size_t>(offsetStorage.data(), offsetStorage.size());
+  targets = ArrayView<int>(targetStorage.data(), targetStorage.size());
+  weights = ArrayView<T>(weightStorage.data(), weightStorage.size());
+  costs = ArrayView<T>(costStorage.data(), costStorage.size());
+}
+
+/**
+ * Writes the finalized graph as a binary snapshot (see GraphSnapshot.hpp),
+ * which load() and the filename constructor can map back without parsing.
+ *
+ * @param filename Path of the snapshot file to create or overwrite.
+ */
+template <typename T>
+void Graph<T>::save(const std::string &filename) const {
+  static_assert(sizeof(std::size_t) == sizeof(std::uint64_t),
+                "Snapshot offsets are stored as 64-bit integers");
+  requireFinalized();
+  GraphSnapshot::write(
+      filename, {GraphSnapshot::weightTypeOf<T>(),
+                 static_cast<std::uint64_t>(numVertices), targets.size(),
+                 offsets.data(), targets.data(), weights.data(),
+                 hasCosts() ? costs.data() : nullptr, sizeof(T)});
+}
+
+/**
+ * Opens a binary snapshot written by save(). The file is memory-mapped and
+ * the graph answers queries straight from the mapped pages, without copying
+ * them; loading only reads the offsets and targets once to check them.
+ *
+ * @param filename Path of the snapshot file.
+ * @param verifyChecksum Whether to hash the whole file before using it.
+ * @return Graph The finalized, read-only graph.
  */
 template <typename T>
-void Graph<T>::addEdge(int from, int to, T weight) {
-  adjList[from].push_back({to, weight});
+Graph<T> Graph<T>::load(const std::string &filename, bool verifyChecksum) {
+  Graph graph;
+  graph.readGraphFromSnapshot(filename, verifyChecksum);
+  return graph;
+}
+
+/**
+ * The function reads a graph from a file, picking the format from its first
+ * bytes: binary snapshots are mapped, anything else is parsed as JSON.
+ *
+ * @param filename The filename parameter is a string that represents the name
+ * of the file from which the graph data will be read.
+ */
+template <typename T>
+void Graph<T>::readGraphFromFile(const std::string &filename) {
+  if (GraphSnapshot::isSnapshot(filename)) {
+    readGraphFromSnapshot(filename, false);
+  } else {
+    readGraphFromJson(filename);
+  }
+}
+
+/**
+ * Maps a snapshot and binds the CSR views to the arrays inside it.
+ *
+ * @param filename Path of the snapshot file.
+ * @param verifyChecksum Whether to hash the whole file before using it.
+ */
+template <typename T>
+void Graph<T>::readGraphFromSnapshot(const std::string &filename,
+                                     bool verifyChecksum) {
+  auto file = std::make_shared<const MappedFile>(filename, false);
+  GraphSnapshot::Header header = GraphSnapshot::validate(
+      *file, GraphSnapshot::weightTypeOf<T>(), verifyChecksum);
+  const char *base = file->data();
+
+  numVertices = static_cast<int>(header.numVertices);
+  offsets = ArrayView<std::size_t>(
+      reinterpret_cast<const std::size_t *>(base + header.offsetsStart),
+      header.numVertices + 1);
+  targets = ArrayView<int>(
+      reinterpret_cast<const int *>(base + header.targetsStart),
+      header.numEdges);
+  weights = ArrayView<T>(reinterpret_cast<const T *>(base + header.weightsStart),
+                         header.numEdges);
+  costs = header.costsStart == 0
+              ? ArrayView<T>()
+              : ArrayView<T>(
+                    reinterpret_cast<const T *>(base + header.costsStart),
+                    header.numEdges);
+
+  std::vector<Edge>().swap(pendingEdges);
+  offsetStorage.clear();
+  targetStorage.clear();
+  weightStorage.clear();
+  costStorage.clear();
+  snapshot = std::move(file);
+  reverseEdges.reset();
+  finalized = true;
+}
+
+/**
+ * Throws if the graph is still in its builder phase; every query runs on
+ * the CSR arrays.
+ */
+template <typename T>
+void Graph<T>::requireFinalized() const {
+  if (!finalized) {
+    throw std::logic_error("Graph must be finalized before it is queried");
+  }
 }
 
 /**
@@ -44,13 +235,15 @@ void Graph<T>::addEdge(int from, int to, T weight) {
  */
 template <typename T>
 std::ostream &operator<<(std::ostream &os, const Graph<T> &graph) {
+  graph.requireFinalized();
   os << "Graph Representation (Adjacency List):\n";
   for (int i = 0; i < graph.numVertices; ++i) {
     os << "Vertex " << i << " connects to: ";
-    for (const auto &edge : graph.adjList[i]) {
-      os << "[Vertex " << edge.to << " with weight " << edge.weight << "] ";
+    for (std::size_t e = graph.offsets[i]; e < graph.offsets[i + 1]; ++e) {
+      os << "[Vertex " << graph.targets[e] << " with weight "
+         << graph.weights[e] << "] ";
     }
-    if (graph.adjList[i].empty()) {
+    if (graph.offsets[i] == graph.offsets[i + 1]) {
       os << "No connections";
     }
     os << "\n";
@@ -60,192 +253,329 @@ std::ostream &operator<<(std::ostream &os, const Graph<T> &graph) {
 
 /**
  * The function reads a graph from a file and populates the adjacency list with
- * the graph data.
+ * the graph data. The file is memory-mapped and parsed in a single streaming
+ * pass; edges are written straight into the pre-reserved builder buffer, so
+ * no JSON document tree is ever materialised.
  *
  * @param filename The filename parameter is a string that represents the name
  * of the file from which the graph data will be read.
  */
 template <typename T>
 void Graph<T>::readGraphFromJson(const std::string &filename) {
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    throw std::runtime_error("Could not open file: " + filename);
-  }
+  MappedFile file(filename);
+  GraphJsonReader reader(file.data(), file.size());
+  pendingEdges.reserve(reader.estimateEdges());
 
-  nlohmann::json json;
-  file >> json;
+  // "vertices" may come after "edges", so endpoints are checked at the end
+  reader.parse([&](int vertices) { numVertices = vertices; },
+               [&](const GraphJsonReader::EdgeRecord &edge) {
+                 pendingEdges.push_back({edge.from, edge.to,
+                                         static_cast<T>(edge.weight),
+                                         static_cast<T>(edge.cost)});
+               });
 
-  numVertices = json["vertices"];
-  adjList.resize(numVertices);
-
-  for (const auto &edge : json["edges"]) {
-    int from = edge["from"];
-    int to = edge["to"];
-    T weight = edge["weight"];
-    addEdge(from, to, weight);
+  for (const auto &edge : pendingEdges) {
+    if (edge.from < 0 || edge.from >= numVertices || edge.to < 0 ||
+        edge.to >= numVertices) {
+      throw std::out_of_range("Edge endpoint out of range in " + filename);
+    }
   }
+  finalize();
+}
+
+/**
+ * Writes the graph in Graphviz DOT format to a stream. The text goes out
+ * through a fixed-size buffer, so memory use does not grow with the graph.
+ *
+ * @param os Stream that receives the DOT text.
+ * @param options Edge sampling, edge cap and clusters.
+ */
+template <typename T>
+void Graph<T>::toDot(std::ostream &os, const DotOptions &options) const {
+  DotWriter dot(os);
+  writeDot(dot, options);
 }
 
+/**
+ * Writes the graph in Graphviz DOT format to a file descriptor, bypassing
+ * iostreams entirely.
+ *
+ * @param fd Descriptor opened for writing; it is not closed.
+ * @param options Edge sampling, edge cap and clusters.
+ */
 template <typename T>
-std::string Graph<T>::toDot() const {
-  std::ostringstream dot;
+void Graph<T>::toDot(int fd, const DotOptions &options) const {
+  DotWriter dot(fd);
+  writeDot(dot, options);
+}
+
+/**
+ * Emits the cluster blocks, if any, followed by the sampled and capped
+ * edges in CSR order.
+ */
+template <typename T>
+void Graph<T>::writeDot(DotWriter &dot, const DotOptions &options) const {
+  requireFinalized();
+  const std::vector<int> *clusters = options.clusters;
+  if (clusters != nullptr &&
+      clusters->size() != static_cast<std::size_t>(numVertices)) {
+    throw std::invalid_argument("DOT clusters need one entry per vertex");
+  }
+
   dot << "digraph G {\n";  // Use "digraph" for directed graphs
-  for (int i = 0; i < numVertices; ++i) {
-    for (const auto &edge : adjList[i]) {
-      dot << "  " << i << " -> " << edge.to << " [label=" << edge.weight
+
+  if (clusters != nullptr) {
+    // Group the clustered vertices; this index is the only per-vertex
+    // memory the export needs
+    std::vector<int> members;
+    for (int v = 0; v < numVertices; ++v) {
+      if ((*clusters)[v] >= 0) members.push_back(v);
+    }
+    std::stable_sort(members.begin(), members.end(), [&](int a, int b) {
+      return (*clusters)[a] < (*clusters)[b];
+    });
+    for (std::size_t i = 0; i < members.size(); ++i) {
+      int id = (*clusters)[members[i]];
+      if (i == 0 || (*clusters)[members[i - 1]] != id) {
+        dot << "  subgraph cluster_" << id << " {\n    label=\"" << id
+            << "\";\n";
+      }
+      dot << "    " << members[i] << ";\n";
+      if (i + 1 == members.size() || (*clusters)[members[i + 1]] != id) {
+        dot << "  }\n";
+      }
+    }
+  }
+
+  std::size_t limit = options.maxEdges == 0
+                          ? std::numeric_limits<std::size_t>::max()
+                          : options.maxEdges;
+  std::size_t written = 0;
+  for (int i = 0; i < numVertices && written < limit; ++i) {
+    for (std::size_t e = offsets[i]; e < offsets[i + 1] && written < limit;
+         ++e) {
+      if (!DotWriter::keepEdge(options, e)) continue;
+      dot << "  " << i << " -> " << targets[e] << " [label=" << weights[e]
           << "];\n";
+      ++written;
     }
   }
   dot << "}\n";
-  return dot.str();
+  dot.flush();
 }
 
 /**
- * Helper function for isBipartite that implements the coloring logic using BFS
+ * Computes the hop distance from src to every vertex along out-edges with
+ * the parallel direction-optimizing BFS. Bottom-up steps scan in-edges, so
+ * the first call also builds the reverse adjacency, which later calls reuse.
  *
  * @tparam T The type of the graph's weights
- * @param start Starting vertex for the BFS
- * @param colors Vector storing the colors of vertices
- * @return bool True if the component is bipartite, false otherwise
+ * @param src The source vertex
+ * @return std::vector<int> Level of each vertex, -1 if unreachable
  */
 template <typename T>
-bool Graph<T>::isBipartiteUtil(int start, std::vector<int> &colors) const {
-  std::queue<int> q;
-  q.push(start);
-  colors[start] = 0;  // Assign first color to start vertex
-
-  while (!q.empty()) {
-    int curr = q.front();
-    q.pop();
+std::vector<int> Graph<T>::bfsLevels(int src) const {
+  requireFinalized();
+  if (src < 0 || src >= numVertices) {
+    throw std::out_of_range("Source vertex out of range");
+  }
 
-    // Check all adjacent vertices
-    for (const auto &edge : adjList[curr]) {
-      int neighbor = edge.to;
+  std::shared_ptr<const Adjacency> reverse = reverseAdjacency();
+  std::vector<int> level(numVertices, -1);
+  ParallelBfs bfs(numVertices, {offsets, targets}, reverse->view(),
+                  ThreadPool::shared());
+  bfs.run(src, level);
+  return level;
+}
 
-      // If neighbor is not colored, color it with opposite color
-      if (colors[neighbor] == -1) {
-        colors[neighbor] = 1 - colors[curr];
-        q.push(neighbor);
-      }
-      // If neighbor is colored and has same color as current vertex
-      else if (colors[neighbor] == colors[curr]) {
-        return false;
-      }
-    }
+/**
+ * Returns the in-edges of every vertex, transposing the graph on the first
+ * call. Concurrent first calls may each build a copy; one of them is kept.
+ *
+ * @return std::shared_ptr<const Adjacency> The reverse adjacency.
+ */
+template <typename T>
+std::shared_ptr<const Adjacency> Graph<T>::reverseAdjacency() const {
+  std::shared_ptr<const Adjacency> reverse = std::atomic_load(&reverseEdges);
+  if (!reverse) {
+    reverse = std::make_shared<const Adjacency>(ParallelBfs::transpose(
+        numVertices, {offsets, targets}, ThreadPool::shared()));
+    std::atomic_store(&reverseEdges, reverse);
   }
-  return true;
+  return reverse;
 }
 
 /**
- * Finds the maximum flow in a flow network from source to sink using
- * Edmonds-Karp algorithm (Ford-Fulkerson with BFS)
+ * Finds the maximum flow in a flow network from source to sink. Edge weights
+ * are the capacities; the residual network is sparse, with each arc paired
+ * with its reverse arc, so memory stays O(V + E).
  *
  * @tparam T The type of the graph's weights
  * @param source The source vertex
  * @param sink The sink vertex
+ * @param mode Dinic's algorithm (level graph and blocking flow) or
+ * highest-label push-relabel with the gap heuristic
  * @return T The maximum flow from source to sink
  */
 template <typename T>
-T Graph<T>::getMaxFlow(int source, int sink) const {
+T Graph<T>::getMaxFlow(int source, int sink, MaxFlowMode mode) const {
+  requireFinalized();
   if (source == sink) return 0;
   if (source < 0 || sink < 0 || source >= numVertices || sink >= numVertices)
     return 0;
 
-  // Create residual graph
-  std::vector<std::vector<T>> residualGraph(numVertices,
-                                            std::vector<T>(numVertices, 0));
-
-  // Initialize residual graph with capacities
+  FlowNetwork<T> network(numVertices);
+  network.reserveArcs(targets.size());
   for (int i = 0; i < numVertices; i++) {
-    for (const auto &edge : adjList[i]) {
-      residualGraph[i][edge.to] = edge.weight;
+    for (std::size_t e = offsets[i]; e < offsets[i + 1]; ++e) {
+      network.addArc(i, targets[e], weights[e]);
     }
   }
+  network.build();
 
-  std::vector<int> parent(numVertices);
-  T maxFlow = 0;
-
-  // Augment the flow while there is a path from source to sink
-  while (bfs(residualGraph, source, sink, parent)) {
-    // Find minimum residual capacity along the path
-    T pathFlow = std::numeric_limits<T>::max();
-    for (int v = sink; v != source; v = parent[v]) {
-      int u = parent[v];
-      pathFlow = std::min(pathFlow, residualGraph[u][v]);
-    }
-
-    // Update residual capacities and reverse edges
-    for (int v = sink; v != source; v = parent[v]) {
-      int u = parent[v];
-      residualGraph[u][v] -= pathFlow;
-      residualGraph[v][u] += pathFlow;  // Add reverse edge for residual graph
-    }
-
-    maxFlow += pathFlow;
+  if (mode == MaxFlowMode::PushRelabel) {
+    return network.pushRelabel(source, sink);
   }
-
-  return maxFlow;
+  return network.dinic(source, sink);
 }
 
 /**
- * Helper function that uses BFS to find a path from source to sink in the
- * residual graph
+ * Finds a maximum flow of minimum total cost from source to sink. Edge
+ * weights are the capacities and edge costs the price of one unit of flow
+ * along the edge; costs may be negative as long as no cycle has negative
+ * total cost.
  *
  * @tparam T The type of the graph's weights
- * @param residualGraph The residual graph
  * @param source The source vertex
  * @param sink The sink vertex
- * @param parent Vector to store the path
- * @return bool True if a path exists, false otherwise
+ * @param cost Output: the total cost of the flow, 0 if no flow is possible
+ * @param mode Successive shortest paths with Dijkstra on Johnson
+ * potentials, or cost scaling, which does better on large instances with
+ * many distinct path costs (integral weights only; float and double graphs
+ * fall back to successive shortest paths)
+ * @return T The maximum flow from source to sink
+ * @throws std::invalid_argument If the graph has a negative-cost cycle
  */
 template <typename T>
-bool Graph<T>::bfs(const std::vector<std::vector<T>> &residualGraph, int source,
-                   int sink, std::vector<int> &parent) const {
-  std::vector<bool> visited(numVertices, false);
-  std::queue<int> q;
-
-  q.push(source);
-  visited[source] = true;
-  parent[source] = -1;
-
-  while (!q.empty()) {
-    int u = q.front();
-    q.pop();
+T Graph<T>::getMinCostFlow(int source, int sink, T &cost,
+                           MinCostFlowMode mode) const {
+  requireFinalized();
+  cost = 0;
+  if (source == sink) return 0;
+  if (source < 0 || sink < 0 || source >= numVertices || sink >= numVertices)
+    return 0;
 
-    for (int v = 0; v < numVertices; v++) {
-      if (!visited[v] && residualGraph[u][v] > 0) {
-        q.push(v);
-        parent[v] = u;
-        visited[v] = true;
-      }
+  FlowNetwork<T> network(numVertices);
+  network.reserveArcs(targets.size());
+  for (int i = 0; i < numVertices; i++) {
+    for (std::size_t e = offsets[i]; e < offsets[i + 1]; ++e) {
+      network.addArc(i, targets[e], weights[e], hasCosts() ? costs[e] : T());
     }
   }
+  network.build();
 
-  return visited[sink];
+  if (mode == MinCostFlowMode::CostScaling) {
+    return network.costScaling(source, sink, cost);
+  }
+  return network.successiveShortestPaths(source, sink, cost);
 }
 
 /**
  * Checks if the graph is bipartite (can be colored with two colors such that
- * no adjacent vertices have the same color)
+ * no adjacent vertices have the same color). Edge directions are ignored.
  *
  * @tparam T The type of the graph's weights
  * @return bool True if the graph is bipartite, false otherwise
  */
 template <typename T>
 bool Graph<T>::isBipartite() const {
-  if (numVertices == 0) return true;
+  std::vector<int> side;
+  return isBipartite(side);
+}
 
-  // Colors: -1 = not colored, 0 = first color, 1 = second color
-  std::vector<int> colors(numVertices, -1);
+/**
+ * Same as isBipartite(), but also returns the two sides.
+ *
+ * @tparam T The type of the graph's weights
+ * @param side Output: 0 or 1 for every vertex, such that every edge joins
+ * the two sides; empty if the graph is not bipartite
+ * @return bool True if the graph is bipartite, false otherwise
+ */
+template <typename T>
+bool Graph<T>::isBipartite(std::vector<int> &side) const {
+  requireFinalized();
+  ThreadPool &pool = ThreadPool::shared();
+  Adjacency undirected =
+      ParallelBfs::symmetrize(numVertices, {offsets, targets}, pool);
+  return twoColor(undirected.view(), side, pool);
+}
 
-  // Check each uncolored vertex as a potential starting point
+/**
+ * Computes a maximum matching of a bipartite graph with Hopcroft-Karp in
+ * O(E sqrt(V)) time and O(V + E) memory. Edge directions and weights are
+ * ignored.
+ *
+ * @tparam T The type of the graph's weights
+ * @param mate Output: the vertex each vertex is matched to, -1 if it is
+ * unmatched; empty if the graph is not bipartite
+ * @return bool False if the graph is not bipartite
+ */
+template <typename T>
+bool Graph<T>::maximumMatching(std::vector<int> &mate) const {
+  requireFinalized();
+  ThreadPool &pool = ThreadPool::shared();
+  Adjacency undirected =
+      ParallelBfs::symmetrize(numVertices, {offsets, targets}, pool);
+  std::vector<int> side;
+  if (!twoColor(undirected.view(), side, pool)) {
+    mate.clear();
+    return false;
+  }
+
+  BipartiteMatching matcher(numVertices, undirected.view(), side);
+  matcher.run(mate);
+  return true;
+}
+
+/**
+ * Two-colors the graph by BFS level parity. Every component is labelled
+ * with the parallel BFS over the symmetric adjacency; since the levels of
+ * adjacent vertices differ by at most one, coloring by level parity works
+ * unless some edge joins two vertices on the same level, which closes an
+ * odd cycle.
+ *
+ * @param undirected The symmetric adjacency of the graph
+ * @param side Output: the color of every vertex; empty on failure
+ * @param pool Threads to run the search and the check on
+ * @return bool True if the graph is bipartite
+ */
+template <typename T>
+bool Graph<T>::twoColor(CsrView undirected, std::vector<int> &side,
+                        ThreadPool &pool) const {
+  side.assign(numVertices, -1);
+  ParallelBfs bfs(numVertices, undirected, undirected, pool);
   for (int i = 0; i < numVertices; i++) {
-    if (colors[i] == -1) {
-      if (!isBipartiteUtil(i, colors)) {
-        return false;
-      }
-    }
+    if (side[i] == -1) bfs.run(i, side);
+  }
+
+  std::atomic<bool> conflict(false);
+  pool.parallelFor(0, numVertices, 4096,
+                   [&](std::size_t lo, std::size_t hi, unsigned) {
+                     for (std::size_t u = lo; u < hi && !conflict; ++u) {
+                       for (std::size_t e = offsets[u]; e < offsets[u + 1];
+                            ++e) {
+                         if (side[u] == side[targets[e]]) conflict = true;
+                       }
+                     }
+                   });
+  if (conflict) {
+    side.clear();
+    return false;
   }
+  pool.parallelFor(0, numVertices, 4096,
+                   [&](std::size_t lo, std::size_t hi, unsigned) {
+                     for (std::size_t v = lo; v < hi; ++v) side[v] &= 1;
+                   });
   return true;
 }
 
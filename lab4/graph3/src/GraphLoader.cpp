@@ -0,0 +1,198 @@
+#include "../include/GraphLoader.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * Maps the file into memory for reading.
+ *
+ * @param filename Path of the file to map.
+ * @param sequential Whether the file will be read front to back.
+ */
+MappedFile::MappedFile(const std::string &filename, bool sequential)
+    : bytes(nullptr), length(0) {
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::runtime_error("Could not open file: " + filename);
+  }
+
+  struct stat info;
+  if (::fstat(fd, &info) == -1) {
+    ::close(fd);
+    throw std::runtime_error("Could not stat file: " + filename);
+  }
+  length = static_cast<std::size_t>(info.st_size);
+
+  if (length > 0) {
+    void *mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("Could not map file: " + filename);
+    }
+    if (sequential) ::madvise(mapping, length, MADV_SEQUENTIAL);
+    bytes = static_cast<const char *>(mapping);
+  }
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (bytes != nullptr) {
+    ::munmap(const_cast<char *>(bytes), length);
+  }
+}
+
+GraphJsonReader::GraphJsonReader(const char *data, std::size_t size)
+    : begin(data), pos(data), end(data + size) {}
+
+/**
+ * Upper bound on the number of edges: every edge is an object, so it is
+ * never more than the number of '{' in the input minus the outer one.
+ *
+ * @return std::size_t The number of edges to reserve room for.
+ */
+std::size_t GraphJsonReader::estimateEdges() const {
+  std::size_t objects = 0;
+  for (const char *p = begin; p != end;) {
+    p = static_cast<const char *>(std::memchr(p, '{', end - p));
+    if (p == nullptr) break;
+    ++objects;
+    ++p;
+  }
+  return objects > 0 ? objects - 1 : 0;
+}
+
+void GraphJsonReader::fail(const std::string &message) const {
+  throw std::runtime_error("JSON parse error at offset " +
+                           std::to_string(pos - begin) + ": " + message);
+}
+
+void GraphJsonReader::failExpected(char c) const {
+  fail(std::string("expected '") + c + "'");
+}
+
+/**
+ * Reads a string token. Escapes are skipped over but not decoded, which is
+ * enough for matching the schema's plain ASCII keys.
+ *
+ * @return std::string_view The raw characters between the quotes.
+ */
+std::string_view GraphJsonReader::parseString() {
+  expect('"');
+  const char *start = pos;
+  while (pos < end && *pos != '"') {
+    if (*pos == '\\' && ++pos == end) break;
+    ++pos;
+  }
+  if (pos >= end) fail("unterminated string");
+  std::string_view text(start, pos - start);
+  ++pos;
+  return text;
+}
+
+/**
+ * Reads a number. Integral tokens, the common case for weights, take the
+ * cheaper integer conversion.
+ */
+double GraphJsonReader::parseNumber() {
+  skipWhitespace();
+  long long integral = 0;
+  auto [intEnd, intError] = std::from_chars(pos, end, integral);
+  if (intError == std::errc() &&
+      (intEnd == end || (*intEnd != '.' && *intEnd != 'e' && *intEnd != 'E'))) {
+    pos = intEnd;
+    return static_cast<double>(integral);
+  }
+
+  double value = 0;
+  auto [next, error] = std::from_chars(pos, end, value);
+  if (error != std::errc()) fail("expected a number");
+  pos = next;
+  return value;
+}
+
+/**
+ * Reads an integer field. Integral tokens take the fast integer path;
+ * anything else is parsed as a floating point number and truncated, the
+ * same conversion a JSON library performs for integer targets.
+ */
+int GraphJsonReader::parseInt() {
+  skipWhitespace();
+  int value = 0;
+  auto [next, error] = std::from_chars(pos, end, value);
+  if (error == std::errc() &&
+      (next == end || (*next != '.' && *next != 'e' && *next != 'E'))) {
+    pos = next;
+    return value;
+  }
+  return static_cast<int>(parseNumber());
+}
+
+/**
+ * Skips over any JSON value, including nested objects and arrays.
+ */
+void GraphJsonReader::skipValue() {
+  char c = peek();
+  if (c == '"') {
+    parseString();
+  } else if (c == '{' || c == '[') {
+    int depth = 0;
+    do {
+      c = peek();
+      if (c == '"') {
+        parseString();
+        continue;
+      }
+      if (c == '{' || c == '[') ++depth;
+      if (c == '}' || c == ']') --depth;
+      ++pos;
+    } while (depth > 0);
+  } else if (c == '-' || (c >= '0' && c <= '9')) {
+    parseNumber();
+  } else {
+    const char *start = pos;
+    while (pos != end && *pos >= 'a' && *pos <= 'z') ++pos;
+    std::string_view word(start, pos - start);
+    if (word != "true" && word != "false" && word != "null") {
+      fail("unexpected token");
+    }
+  }
+}
+
+/**
+ * Reads one edge object into the given record.
+ *
+ * @param edge Record receiving from, to, weight and cost (both default to 0).
+ */
+void GraphJsonReader::parseEdge(EdgeRecord &edge) {
+  edge = {-1, -1, 0, 0};
+  bool hasFrom = false, hasTo = false;
+  expect('{');
+  if (!consume('}')) {
+    do {
+      std::string_view key = parseString();
+      expect(':');
+      if (key == "from") {
+        edge.from = parseInt();
+        hasFrom = true;
+      } else if (key == "to") {
+        edge.to = parseInt();
+        hasTo = true;
+      } else if (key == "weight" || key == "capacity") {
+        edge.weight = parseNumber();
+      } else if (key == "cost") {
+        edge.cost = parseNumber();
+      } else {
+        skipValue();
+      }
+    } while (consume(','));
+    expect('}');
+  }
+  if (!hasFrom || !hasTo) fail("edge without \"from\" or \"to\"");
+}
@@ -0,0 +1,348 @@
+#include "../include/ParallelBfs.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+constexpr std::size_t WORD_BITS = 64;
+
+// Switching thresholds from Beamer et al.: go bottom-up once the frontier
+// has more than 1/ALPHA of the unexplored edges, and back to top-down once
+// it holds fewer than 1/BETA of the vertices and is shrinking.
+constexpr std::size_t ALPHA = 14;
+constexpr std::size_t BETA = 24;
+
+constexpr std::size_t VERTEX_GRAIN = 256;  // frontier entries per chunk
+constexpr std::size_t WORD_GRAIN = 64;     // bitmap words per chunk
+constexpr std::size_t BUILD_GRAIN = 4096;  // vertices per chunk for builds
+constexpr std::size_t FILL_BATCH = 1024;   // edges per slot reservation
+
+/**
+ * Counting-sort construction shared by transpose and symmetrize. Degrees
+ * and fill cursors are atomic so that every thread can scatter edges
+ * without locks; the order inside each adjacency list is unspecified.
+ */
+Adjacency buildAdjacency(int vertices, CsrView edges, bool keepForward,
+                         ThreadPool &pool) {
+  std::size_t n = static_cast<std::size_t>(vertices);
+  std::unique_ptr<std::atomic<std::size_t>[]> cursor(
+      new std::atomic<std::size_t>[n + 1]);
+  pool.parallelFor(0, n + 1, BUILD_GRAIN,
+                   [&](std::size_t lo, std::size_t hi, unsigned) {
+                     for (std::size_t v = lo; v < hi; ++v) cursor[v] = 0;
+                   });
+
+  pool.parallelFor(0, n, BUILD_GRAIN,
+                   [&](std::size_t lo, std::size_t hi, unsigned) {
+                     for (std::size_t u = lo; u < hi; ++u) {
+                       std::size_t first = edges.offsets[u];
+                       std::size_t last = edges.offsets[u + 1];
+                       for (std::size_t e = first; e < last; ++e) {
+                         cursor[edges.targets[e] + 1].fetch_add(
+                             1, std::memory_order_relaxed);
+                       }
+                       if (keepForward && last > first) {
+                         cursor[u + 1].fetch_add(last - first,
+                                                 std::memory_order_relaxed);
+                       }
+                     }
+                   });
+
+  Adjacency result;
+  result.offsets.resize(n + 1);
+  result.offsets[0] = 0;
+  for (std::size_t v = 0; v < n; ++v) {
+    result.offsets[v + 1] = result.offsets[v] + cursor[v + 1].load();
+    // Symmetric lists keep the vertex's own out-edges first
+    cursor[v] = result.offsets[v] +
+                (keepForward ? edges.offsets[v + 1] - edges.offsets[v] : 0);
+  }
+  result.targets.resize(result.offsets[n]);
+
+  // Slots are reserved in batches before any edge is written: a locked
+  // fetch_add waits for earlier stores to drain, so interleaving the two
+  // would serialise one cache miss per edge.
+  pool.parallelFor(
+      0, n, BUILD_GRAIN, [&](std::size_t lo, std::size_t hi, unsigned) {
+        std::vector<std::size_t> slots;
+        std::size_t first = edges.offsets[lo];
+        std::size_t last = edges.offsets[hi];
+        for (std::size_t batch = first; batch < last; batch += FILL_BATCH) {
+          std::size_t batchEnd = std::min(batch + FILL_BATCH, last);
+          slots.clear();
+          for (std::size_t e = batch; e < batchEnd; ++e) {
+            slots.push_back(cursor[edges.targets[e]].fetch_add(
+                1, std::memory_order_relaxed));
+          }
+          std::size_t u = std::upper_bound(edges.offsets.begin() + lo,
+                                           edges.offsets.begin() + hi + 1,
+                                           batch) -
+                          edges.offsets.begin() - 1;
+          for (std::size_t e = batch; e < batchEnd; ++e) {
+            while (e >= edges.offsets[u + 1]) ++u;
+            result.targets[slots[e - batch]] = static_cast<int>(u);
+          }
+        }
+        if (keepForward) {
+          for (std::size_t u = lo; u < hi; ++u) {
+            std::copy(edges.targets.begin() + edges.offsets[u],
+                      edges.targets.begin() + edges.offsets[u + 1],
+                      result.targets.begin() + result.offsets[u]);
+          }
+        }
+      });
+  return result;
+}
+
+}  // namespace
+
+/**
+ * Prepares a search over a graph with the given out- and in-adjacency. For
+ * undirected searches both views are the same symmetric adjacency.
+ *
+ * @param vertices Number of vertices.
+ * @param outEdges Edges followed by top-down steps.
+ * @param inEdges Reverse edges scanned by bottom-up steps.
+ * @param threads Pool that runs every step.
+ */
+ParallelBfs::ParallelBfs(int vertices, CsrView outEdges, CsrView inEdges,
+                         ThreadPool &threads)
+    : numVertices(vertices),
+      numWords((static_cast<std::size_t>(vertices) + WORD_BITS - 1) /
+               WORD_BITS),
+      out(outEdges),
+      in(inEdges),
+      pool(threads),
+      visited(makeBitmap(numWords)),
+      frontierBits(makeBitmap(numWords)),
+      nextBits(makeBitmap(numWords)),
+      localFrontiers(threads.size()),
+      unexploredEdges(inEdges.targets.size()) {
+  // Padding bits past the last vertex count as visited so that bottom-up
+  // steps never look at them
+  std::size_t tail = static_cast<std::size_t>(vertices) % WORD_BITS;
+  if (tail != 0) visited[numWords - 1] = ~Word(0) << tail;
+}
+
+ParallelBfs::Bitmap ParallelBfs::makeBitmap(std::size_t words) {
+  Bitmap bitmap(new std::atomic<Word>[words]);
+  for (std::size_t w = 0; w < words; ++w) bitmap[w] = 0;
+  return bitmap;
+}
+
+bool ParallelBfs::isVisited(int v) const {
+  return (visited[v / WORD_BITS].load(std::memory_order_relaxed) >>
+          (v % WORD_BITS)) &
+         1;
+}
+
+/**
+ * Labels every vertex reachable from source that no earlier run reached
+ * with its hop distance from source. Other entries of level are untouched.
+ *
+ * @param source Start vertex.
+ * @param level Output vector of size numVertices.
+ */
+void ParallelBfs::run(int source, std::vector<int> &level) {
+  if (isVisited(source)) return;
+  visited[source / WORD_BITS] |= Word(1) << (source % WORD_BITS);
+  level[source] = 0;
+  unexploredEdges -= in.offsets[source + 1] - in.offsets[source];
+  frontier.assign(1, source);
+
+  StepStats current;
+  current.vertices = 1;
+  current.outEdges = out.offsets[source + 1] - out.offsets[source];
+  std::size_t previousVertices = 0;
+  bool bottomUp = false;
+
+  for (int depth = 0; current.vertices > 0; ++depth) {
+    if (!bottomUp && current.outEdges > unexploredEdges / ALPHA &&
+        current.outEdges > numWords) {
+      queueToBitmap();
+      bottomUp = true;
+    } else if (bottomUp &&
+               current.vertices < static_cast<std::size_t>(numVertices) / BETA &&
+               current.vertices < previousVertices) {
+      bitmapToQueue();
+      bottomUp = false;
+    }
+    previousVertices = current.vertices;
+    current = bottomUp ? bottomUpStep(depth, level) : topDownStep(depth, level);
+    unexploredEdges -= current.inEdges;
+  }
+}
+
+/**
+ * Expands the frontier queue along out-edges. A vertex belongs to the
+ * thread whose atomic fetch_or sets its visited bit first.
+ */
+ParallelBfs::StepStats ParallelBfs::topDownStep(int depth,
+                                                std::vector<int> &level) {
+  std::vector<StepStats> stats(pool.size());
+  for (auto &local : localFrontiers) local.clear();
+
+  pool.parallelFor(
+      0, frontier.size(), VERTEX_GRAIN,
+      [&](std::size_t lo, std::size_t hi, unsigned worker) {
+        StepStats local;
+        std::vector<int> &next = localFrontiers[worker];
+        for (std::size_t i = lo; i < hi; ++i) {
+          int u = frontier[i];
+          for (std::size_t e = out.offsets[u]; e < out.offsets[u + 1]; ++e) {
+            int v = out.targets[e];
+            Word bit = Word(1) << (v % WORD_BITS);
+            std::atomic<Word> &word = visited[v / WORD_BITS];
+            if (word.load(std::memory_order_relaxed) & bit) continue;
+            if (word.fetch_or(bit, std::memory_order_relaxed) & bit) continue;
+            level[v] = depth + 1;
+            next.push_back(v);
+            ++local.vertices;
+            local.outEdges += out.offsets[v + 1] - out.offsets[v];
+            local.inEdges += in.offsets[v + 1] - in.offsets[v];
+          }
+        }
+        stats[worker].vertices += local.vertices;
+        stats[worker].outEdges += local.outEdges;
+        stats[worker].inEdges += local.inEdges;
+      });
+
+  StepStats total;
+  frontier.clear();
+  for (unsigned w = 0; w < pool.size(); ++w) {
+    frontier.insert(frontier.end(), localFrontiers[w].begin(),
+                    localFrontiers[w].end());
+    total.vertices += stats[w].vertices;
+    total.outEdges += stats[w].outEdges;
+    total.inEdges += stats[w].inEdges;
+  }
+  return total;
+}
+
+/**
+ * Lets every unvisited vertex scan its in-edges for a parent in the
+ * frontier bitmap, stopping at the first hit. Each chunk owns whole bitmap
+ * words, so the visited and next-frontier words are written without
+ * read-modify-write atomics.
+ */
+ParallelBfs::StepStats ParallelBfs::bottomUpStep(int depth,
+                                                 std::vector<int> &level) {
+  std::vector<StepStats> stats(pool.size());
+
+  pool.parallelFor(
+      0, numWords, WORD_GRAIN,
+      [&](std::size_t lo, std::size_t hi, unsigned worker) {
+        StepStats local;
+        for (std::size_t w = lo; w < hi; ++w) {
+          Word seen = visited[w].load(std::memory_order_relaxed);
+          Word candidates = ~seen;
+          Word found = 0;
+          while (candidates != 0) {
+            int bit = __builtin_ctzll(candidates);
+            candidates &= candidates - 1;
+            int v = static_cast<int>(w * WORD_BITS) + bit;
+            for (std::size_t e = in.offsets[v]; e < in.offsets[v + 1]; ++e) {
+              int u = in.targets[e];
+              if ((frontierBits[u / WORD_BITS].load(std::memory_order_relaxed) >>
+                   (u % WORD_BITS)) &
+                  1) {
+                level[v] = depth + 1;
+                found |= Word(1) << bit;
+                ++local.vertices;
+                local.outEdges += out.offsets[v + 1] - out.offsets[v];
+                local.inEdges += in.offsets[v + 1] - in.offsets[v];
+                break;
+              }
+            }
+          }
+          nextBits[w].store(found, std::memory_order_relaxed);
+          if (found != 0) {
+            visited[w].store(seen | found, std::memory_order_relaxed);
+          }
+        }
+        stats[worker].vertices += local.vertices;
+        stats[worker].outEdges += local.outEdges;
+        stats[worker].inEdges += local.inEdges;
+      });
+
+  std::swap(frontierBits, nextBits);
+  StepStats total;
+  for (const auto &s : stats) {
+    total.vertices += s.vertices;
+    total.outEdges += s.outEdges;
+    total.inEdges += s.inEdges;
+  }
+  return total;
+}
+
+/**
+ * Rewrites the frontier queue as a bitmap for bottom-up steps.
+ */
+void ParallelBfs::queueToBitmap() {
+  pool.parallelFor(0, numWords, BUILD_GRAIN,
+                   [&](std::size_t lo, std::size_t hi, unsigned) {
+                     for (std::size_t w = lo; w < hi; ++w) {
+                       frontierBits[w].store(0, std::memory_order_relaxed);
+                     }
+                   });
+  pool.parallelFor(0, frontier.size(), BUILD_GRAIN,
+                   [&](std::size_t lo, std::size_t hi, unsigned) {
+                     for (std::size_t i = lo; i < hi; ++i) {
+                       int v = frontier[i];
+                       frontierBits[v / WORD_BITS].fetch_or(
+                           Word(1) << (v % WORD_BITS),
+                           std::memory_order_relaxed);
+                     }
+                   });
+}
+
+/**
+ * Collects the vertices of the frontier bitmap back into the queue for
+ * top-down steps.
+ */
+void ParallelBfs::bitmapToQueue() {
+  for (auto &local : localFrontiers) local.clear();
+  pool.parallelFor(0, numWords, WORD_GRAIN,
+                   [&](std::size_t lo, std::size_t hi, unsigned worker) {
+                     std::vector<int> &next = localFrontiers[worker];
+                     for (std::size_t w = lo; w < hi; ++w) {
+                       Word bits = frontierBits[w].load(
+                           std::memory_order_relaxed);
+                       while (bits != 0) {
+                         next.push_back(static_cast<int>(w * WORD_BITS) +
+                                        __builtin_ctzll(bits));
+                         bits &= bits - 1;
+                       }
+                     }
+                   });
+  frontier.clear();
+  for (const auto &local : localFrontiers) {
+    frontier.insert(frontier.end(), local.begin(), local.end());
+  }
+}
+
+/**
+ * Reverses every edge of a directed graph.
+ *
+ * @param vertices Number of vertices.
+ * @param edges Out-adjacency of the graph.
+ * @return Adjacency The in-adjacency of the graph.
+ */
+Adjacency ParallelBfs::transpose(int vertices, CsrView edges,
+                                 ThreadPool &threads) {
+  return buildAdjacency(vertices, edges, false, threads);
+}
+
+/**
+ * Builds the underlying undirected graph: every edge u -> v appears in the
+ * lists of both u and v.
+ *
+ * @param vertices Number of vertices.
+ * @param edges Out-adjacency of the graph.
+ * @return Adjacency The symmetric adjacency.
+ */
+Adjacency ParallelBfs::symmetrize(int vertices, CsrView edges,
+                                  ThreadPool &threads) {
+  return buildAdjacency(vertices, edges, true, threads);
+}
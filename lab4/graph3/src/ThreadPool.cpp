@@ -0,0 +1,95 @@
+#include "../include/ThreadPool.hpp"
+
+namespace {
+
+// Set while the current thread is executing a parallel loop
+thread_local bool runningLoop = false;
+
+}  // namespace
+
+/**
+ * Starts threads - 1 workers; the thread that issues a loop is the last one.
+ *
+ * @param threads Total number of threads to use, at least 1.
+ */
+ThreadPool::ThreadPool(unsigned threads)
+    : task(nullptr), generation(0), pending(0), stopping(false) {
+  for (unsigned i = 1; i < std::max(threads, 1u); ++i) {
+    workers.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &worker : workers) worker.join();
+}
+
+/**
+ * Process-wide pool with one thread per hardware thread.
+ */
+ThreadPool &ThreadPool::shared() {
+  static ThreadPool pool;
+  return pool;
+}
+
+bool ThreadPool::insideLoop() { return runningLoop; }
+
+void ThreadPool::workerLoop(unsigned index) {
+  unsigned long seen = 0;
+  while (true) {
+    const std::function<void(unsigned)> *body;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping) return;
+      seen = generation;
+      body = task;
+    }
+
+    runningLoop = true;
+    try {
+      (*body)(index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!failure) failure = std::current_exception();
+    }
+    runningLoop = false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--pending == 0) done.notify_one();
+  }
+}
+
+/**
+ * Runs body on every thread of the pool and waits for all of them. The
+ * first exception thrown by any thread is rethrown here.
+ */
+void ThreadPool::runOnAll(const std::function<void(unsigned)> &body) {
+  std::lock_guard<std::mutex> loopLock(loopMutex);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    task = &body;
+    pending = static_cast<unsigned>(workers.size());
+    failure = nullptr;
+    ++generation;
+  }
+  wake.notify_all();
+
+  runningLoop = true;
+  try {
+    body(0);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!failure) failure = std::current_exception();
+  }
+  runningLoop = false;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [&] { return pending == 0; });
+  task = nullptr;
+  if (failure) std::rethrow_exception(failure);
+}
@@ -1,3 +1,9 @@
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
@@ -7,6 +13,33 @@
 #include "Color.hpp"
 #include "Graph.cpp"
 
+extern char** environ;
+
+/**
+ * Renders a DOT file as PNG with Graphviz. The program is started directly
+ * rather than through a shell, so the paths need no quoting.
+ *
+ * @param dotPath Path of the DOT file to render
+ * @param imgPath Path of the PNG file to create
+ * @return bool True if Graphviz ran and succeeded
+ */
+bool renderPng(const std::string& dotPath, const std::string& imgPath) {
+  std::string program = "dot", format = "-Tpng", output = "-o";
+  std::string input = dotPath, image = imgPath;
+  char* argv[] = {program.data(), format.data(), input.data(),
+                  output.data(),  image.data(),  nullptr};
+
+  pid_t pid;
+  if (posix_spawnp(&pid, "dot", nullptr, nullptr, argv, environ) != 0) {
+    return false;
+  }
+  int status = 0;
+  while (waitpid(pid, &status, 0) == -1) {
+    if (errno != EINTR) return false;
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
 /**
  * Generates DOT file and converts it to PNG format
  *
@@ -25,26 +58,26 @@ bool generateGraphVisualization(const Graph<int>& graph,
     std::filesystem::create_directories("outputs/dots");
     std::filesystem::create_directories("outputs/img");
 
-    // Generate DOT file
-    std::string dotRepresentation = graph.toDot();
+    // Stream the DOT file straight to disk
     std::string dotPath = "outputs/dots/" + graphName + ".dot";
     std::string imgPath = "outputs/img/" + graphName + ".png";
 
-    std::ofstream dotFile(dotPath);
-    if (!dotFile.is_open()) {
+    int dotFile = ::open(dotPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (dotFile == -1) {
       std::cerr << Color::RED << "Error: Could not create DOT file: " << dotPath
                 << Color::RESET << std::endl;
       return false;
     }
-
-    dotFile << dotRepresentation;
-    dotFile.close();
+    try {
+      graph.toDot(dotFile);
+    } catch (...) {
+      ::close(dotFile);
+      throw;
+    }
+    ::close(dotFile);
 
     // Convert DOT to PNG
-    std::string command = "dot -Tpng " + dotPath + " -o " + imgPath;
-    int result = system(command.c_str());
-
-    if (result != 0) {
+    if (!renderPng(dotPath, imgPath)) {
       std::cerr << Color::YELLOW
                 << "Warning: Could not generate PNG visualization. "
                 << "Is Graphviz installed?" << Color::RESET << std::endl;
@@ -62,6 +95,23 @@ bool generateGraphVisualization(const Graph<int>& graph,
   }
 }
 
+/**
+ * Prints the pairs of a matching, each pair once
+ *
+ * @param mate Partner of every vertex, -1 if unmatched
+ */
+void printMatching(const std::vector<int>& mate) {
+  std::cout << "Maximum matching: " << Color::GREEN;
+  int pairs = 0;
+  for (size_t u = 0; u < mate.size(); ++u) {
+    if (mate[u] > static_cast<int>(u)) {
+      std::cout << u << "-" << mate[u] << " ";
+      ++pairs;
+    }
+  }
+  std::cout << Color::RESET << "(" << pairs << " pairs)" << std::endl;
+}
+
 /**
  * Prints the maximum flow result in a formatted way
  *
@@ -76,6 +126,22 @@ void printMaxFlow(int source, int sink, int maxFlow) {
             << std::endl;
 }
 
+/**
+ * Prints a minimum-cost maximum flow result in a formatted way
+ *
+ * @param source Source vertex
+ * @param sink Sink vertex
+ * @param flow Maximum flow value
+ * @param cost Total cost of the flow
+ */
+void printMinCostFlow(int source, int sink, int flow, int cost) {
+  std::cout << "Min-cost flow from vertex " << Color::CYAN << source
+            << Color::RESET << " to vertex " << Color::CYAN << sink
+            << Color::RESET << ": " << Color::GREEN << flow << Color::RESET
+            << " units at cost " << Color::GREEN << cost << Color::RESET
+            << std::endl;
+}
+
 int main() {
   try {
     // Flag to control visualization generation
@@ -96,6 +162,25 @@ int main() {
     std::cout << "Is Bipartite: " << Color::GREEN << std::boolalpha
               << bipartiteGraph.isBipartite() << Color::RESET << std::endl;
 
+    std::cout << "BFS levels from vertex 0: " << Color::GREEN;
+    for (int level : bipartiteGraph.bfsLevels(0)) {
+      std::cout << level << " ";
+    }
+    std::cout << Color::RESET << std::endl;
+
+    std::vector<int> side;
+    bipartiteGraph.isBipartite(side);
+    std::cout << "Sides: " << Color::GREEN;
+    for (int s : side) {
+      std::cout << s << " ";
+    }
+    std::cout << Color::RESET << std::endl;
+
+    std::vector<int> mate;
+    if (bipartiteGraph.maximumMatching(mate)) {
+      printMatching(mate);
+    }
+
     // Test Non-Bipartite Graph
     std::cout << Color::CYAN << "\n[Testing Non-Bipartite Graph]"
               << Color::RESET << std::endl;
@@ -124,6 +209,22 @@ int main() {
     printMaxFlow(0, 0, maxFlowGraph.getMaxFlow(0, 0));  // Same vertex
     printMaxFlow(7, 5, maxFlowGraph.getMaxFlow(7, 5));  // Invalid vertex
 
+    // Test Min-Cost Flow Graph
+    std::cout << Color::CYAN << "\n[Testing Min-Cost Flow Graph]"
+              << Color::RESET << std::endl;
+    Graph<int> minCostFlowGraph("inputs/minCostFlowGraph.json");
+    generateGraphVisualization(minCostFlowGraph, "minCostFlowGraph",
+                               GENERATE_VISUALS);
+
+    int cost = 0;
+    int flow = minCostFlowGraph.getMinCostFlow(0, 5, cost);
+    printMinCostFlow(0, 5, flow, cost);
+    flow = minCostFlowGraph.getMinCostFlow(0, 5, cost,
+                                           MinCostFlowMode::CostScaling);
+    printMinCostFlow(0, 5, flow, cost);
+    flow = minCostFlowGraph.getMinCostFlow(2, 5, cost);
+    printMinCostFlow(2, 5, flow, cost);
+
   } catch (const std::exception& e) {
     std::cerr << Color::RED << "Error: " << e.what() << Color::RESET
               << std::endl;
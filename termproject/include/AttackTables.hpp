@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "Bitboard.hpp"
+#include "PieceRules.hpp"
+#include "Zobrist.hpp"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Sliding attacks for one set of rays from every square of a board
+ * of up to 64 squares
+ *
+ * Attacks stop at the first occupied square, which is included. Lookups
+ * are a single table read: the occupied squares that can block a ray are
+ * gathered into an index with PEXT when the compiler targets BMI2, and
+ * with a magic multiplication otherwise.
+ */
+template <int Side>
+class MagicSliderTable {
+ public:
+  explicit MagicSliderTable(const std::vector<RayRule>& rays);
+
+  const std::vector<RayRule>& rays() const { return rays_; }
+
+  Bitboard attacks(int square, Bitboard occupied) const {
+    const Entry& entry = entries_[square];
+    return table_[entry.offset + index(entry, occupied)];
+  }
+
+ private:
+  struct Entry {
+    Bitboard mask;   // squares whose occupancy changes the attacks
+    Bitboard magic;
+    int shift;
+    std::size_t offset;
+  };
+
+  std::vector<RayRule> rays_;
+  std::array<Entry, Side * Side> entries_;
+  std::vector<Bitboard> table_;
+
+  static std::size_t index(const Entry& entry, Bitboard occupied) {
+#if defined(__BMI2__)
+    return _pext_u64(occupied, entry.mask);
+#else
+    return ((occupied & entry.mask) * entry.magic) >> entry.shift;
+#endif
+  }
+
+  void findMagic(int square, const std::vector<Bitboard>& occupancies,
+                 const std::vector<Bitboard>& attacks);
+};
+
+/**
+ * @brief Sliding attacks for boards wider than 64 squares, one ray at a
+ * time: the ray is cut after its first occupied square, which is the
+ * lowest or highest one depending on the ray's direction
+ */
+template <int Side>
+class RaySliderTable {
+ public:
+  using Bits = BitboardFor<Side>;
+
+  explicit RaySliderTable(const std::vector<RayRule>& rays);
+
+  const std::vector<RayRule>& rays() const { return rays_; }
+
+  Bits attacks(int square, const Bits& occupied) const {
+    Bits result;
+    for (std::size_t i = 0; i < rays_.size(); ++i) {
+      Bits ray = reach_[i][square];
+      Bits blockers = ray & occupied;
+      if (blockers) {
+        int first = increasing_[i] ? lowestSquare(blockers)
+                                   : highestSquare(blockers);
+        ray &= ~beyond_[i][first];
+      }
+      result |= ray;
+    }
+    return result;
+  }
+
+ private:
+  std::vector<RayRule> rays_;
+  std::vector<bool> increasing_;  // whether the ray goes to higher squares
+  std::vector<std::array<Bits, Side * Side>> reach_;   // within range
+  std::vector<std::array<Bits, Side * Side>> beyond_;  // to the edge
+};
+
+template <int Side>
+using SliderTable =
+    std::conditional_t<Side * Side <= 64, MagicSliderTable<Side>,
+                       RaySliderTable<Side>>;
+
+/**
+ * @brief Attack tables for every piece type of a configuration on a
+ * Side x Side board
+ *
+ * Steps (king moves, knight jumps, pawn captures) are stored per square;
+ * sliders index into slider tables, which are shared between piece types
+ * with the same rays, so a queen uses the rook's and the bishop's tables.
+ * The Zobrist keys for positions under the rules are kept alongside.
+ */
+template <int Side>
+class AttackTables {
+ public:
+  using Bits = BitboardFor<Side>;
+  static constexpr int kSquares = Side * Side;
+
+  explicit AttackTables(const RuleSet& rules);
+
+  const RuleSet& rules() const { return rules_; }
+  const ZobristKeys& keys() const { return keys_; }
+
+  /**
+   * @brief Squares a piece attacks, i.e. could capture on
+   * @param type Index of the piece type in the configuration
+   * @param color Color of the piece, which matters for pawns
+   * @param square Square the piece stands on
+   * @param occupied All occupied squares, which block sliders
+   */
+  Bits attacks(int type, Color color, int square, const Bits& occupied) const {
+    const PieceTables& tables = pieces_[type];
+    Bits result = tables.steps[color][square];
+    for (int slider : tables.sliders[color]) {
+      if (slider >= 0) result |= sliders_[slider].attacks(square, occupied);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Squares a piece attacks on an empty board, a cheap superset of
+   * attacks() for ruling out attackers
+   */
+  const Bits& reach(int type, Color color, int square) const {
+    return pieces_[type].reach[color][square];
+  }
+
+ private:
+  struct PieceTables {
+    std::array<std::array<Bits, kSquares>, 2> steps{};  // per color
+    std::array<std::array<Bits, kSquares>, 2> reach{};
+    std::array<std::array<int, 2>, 2> sliders{{{-1, -1}, {-1, -1}}};
+  };
+
+  RuleSet rules_;
+  ZobristKeys keys_;
+  std::vector<PieceTables> pieces_;
+  std::vector<SliderTable<Side>> sliders_;
+
+  int sliderFor(const std::vector<RayRule>& rays);
+};
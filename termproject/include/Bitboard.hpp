@@ -0,0 +1,219 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Set of squares of a board of up to 64 squares, one bit per square
+ */
+using Bitboard = std::uint64_t;
+
+/**
+ * @brief Set of squares wider than 64 bits, as an array of 64-bit words
+ *
+ * Two words cover boards up to 11x11 and four up to 16x16. Every operation
+ * is a fixed loop over the words, which the compiler unrolls and turns
+ * into 128- or 256-bit vector instructions where the target has them.
+ */
+template <int Words>
+class WideBitboard {
+ public:
+  constexpr WideBitboard() = default;
+
+  static constexpr WideBitboard bit(int square) {
+    WideBitboard result;
+    result.words_[square >> 6] = std::uint64_t{1} << (square & 63);
+    return result;
+  }
+
+  constexpr WideBitboard operator&(const WideBitboard& other) const {
+    WideBitboard result;
+    for (int i = 0; i < Words; ++i) {
+      result.words_[i] = words_[i] & other.words_[i];
+    }
+    return result;
+  }
+  constexpr WideBitboard operator|(const WideBitboard& other) const {
+    WideBitboard result;
+    for (int i = 0; i < Words; ++i) {
+      result.words_[i] = words_[i] | other.words_[i];
+    }
+    return result;
+  }
+  constexpr WideBitboard operator^(const WideBitboard& other) const {
+    WideBitboard result;
+    for (int i = 0; i < Words; ++i) {
+      result.words_[i] = words_[i] ^ other.words_[i];
+    }
+    return result;
+  }
+  constexpr WideBitboard operator~() const {
+    WideBitboard result;
+    for (int i = 0; i < Words; ++i) result.words_[i] = ~words_[i];
+    return result;
+  }
+  WideBitboard& operator&=(const WideBitboard& other) {
+    return *this = *this & other;
+  }
+  WideBitboard& operator|=(const WideBitboard& other) {
+    return *this = *this | other;
+  }
+  WideBitboard& operator^=(const WideBitboard& other) {
+    return *this = *this ^ other;
+  }
+
+  // Shifts by fewer than 64 bits, which is all a board side needs
+  constexpr WideBitboard operator<<(int shift) const {
+    WideBitboard result;
+    for (int i = Words - 1; i >= 0; --i) {
+      result.words_[i] = words_[i] << shift;
+      if (i > 0 && shift > 0) {
+        result.words_[i] |= words_[i - 1] >> (64 - shift);
+      }
+    }
+    return result;
+  }
+  constexpr WideBitboard operator>>(int shift) const {
+    WideBitboard result;
+    for (int i = 0; i < Words; ++i) {
+      result.words_[i] = words_[i] >> shift;
+      if (i + 1 < Words && shift > 0) {
+        result.words_[i] |= words_[i + 1] << (64 - shift);
+      }
+    }
+    return result;
+  }
+
+  constexpr bool operator==(const WideBitboard& other) const = default;
+  constexpr explicit operator bool() const {
+    std::uint64_t any = 0;
+    for (int i = 0; i < Words; ++i) any |= words_[i];
+    return any != 0;
+  }
+
+  int popCount() const {
+    int count = 0;
+    for (int i = 0; i < Words; ++i) count += std::popcount(words_[i]);
+    return count;
+  }
+  int lowest() const {
+    for (int i = 0; i < Words; ++i) {
+      if (words_[i]) return i * 64 + std::countr_zero(words_[i]);
+    }
+    return -1;
+  }
+  int highest() const {
+    for (int i = Words - 1; i >= 0; --i) {
+      if (words_[i]) return i * 64 + 63 - std::countl_zero(words_[i]);
+    }
+    return -1;
+  }
+  void clearLowest() {
+    for (int i = 0; i < Words; ++i) {
+      if (words_[i]) {
+        words_[i] &= words_[i] - 1;
+        return;
+      }
+    }
+  }
+
+ private:
+  std::array<std::uint64_t, Words> words_{};
+};
+
+/**
+ * @brief The narrowest bitboard that holds Side x Side squares
+ */
+template <int Side>
+using BitboardFor = std::conditional_t<
+    Side * Side <= 64, Bitboard,
+    std::conditional_t<Side * Side <= 128, WideBitboard<2>, WideBitboard<4>>>;
+
+// Board sides with a bitboard implementation; others use the mailbox board
+constexpr int kMinBitboardSide = 3;
+constexpr int kMaxBitboardSide = 16;
+
+/**
+ * @brief Square numbering of a Side x Side board
+ *
+ * Square (x, y) is y * Side + x, so x = 0 is the a-file and y = 0 is
+ * white's back rank, matching the coordinates of the configuration file.
+ */
+template <int Side>
+struct Geometry {
+  using Bits = BitboardFor<Side>;
+  static constexpr int kSide = Side;
+  static constexpr int kSquares = Side * Side;
+
+  static constexpr int squareOf(int x, int y) { return y * Side + x; }
+  static constexpr int fileOf(int square) { return square % Side; }
+  static constexpr int rankOf(int square) { return square / Side; }
+};
+
+template <typename Bits>
+constexpr Bits bitOf(int square) {
+  if constexpr (std::is_same_v<Bits, Bitboard>) {
+    return Bitboard{1} << square;
+  } else {
+    return Bits::bit(square);
+  }
+}
+
+/**
+ * @brief Every square of a Side x Side board
+ */
+template <int Side>
+constexpr BitboardFor<Side> allSquares() {
+  using Bits = BitboardFor<Side>;
+  if constexpr (std::is_same_v<Bits, Bitboard>) {
+    return Side * Side == 64 ? ~Bitboard{0}
+                             : (Bitboard{1} << (Side * Side)) - 1;
+  } else {
+    Bits all;
+    for (int square = 0; square < Side * Side; ++square) {
+      all |= bitOf<Bits>(square);
+    }
+    return all;
+  }
+}
+
+inline int popCount(Bitboard bits) { return std::popcount(bits); }
+template <int Words>
+int popCount(const WideBitboard<Words>& bits) {
+  return bits.popCount();
+}
+
+/**
+ * @brief Index of the lowest set square; bits must not be empty
+ */
+inline int lowestSquare(Bitboard bits) { return std::countr_zero(bits); }
+template <int Words>
+int lowestSquare(const WideBitboard<Words>& bits) {
+  return bits.lowest();
+}
+
+/**
+ * @brief Index of the highest set square; bits must not be empty
+ */
+inline int highestSquare(Bitboard bits) { return 63 - std::countl_zero(bits); }
+template <int Words>
+int highestSquare(const WideBitboard<Words>& bits) {
+  return bits.highest();
+}
+
+/**
+ * @brief Removes the lowest set square and returns its index
+ */
+inline int popLowestSquare(Bitboard& bits) {
+  int square = std::countr_zero(bits);
+  bits &= bits - 1;
+  return square;
+}
+template <int Words>
+int popLowestSquare(WideBitboard<Words>& bits) {
+  int square = bits.lowest();
+  bits.clearLowest();
+  return square;
+}
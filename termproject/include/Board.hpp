@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AttackTables.hpp"
+#include "ConfigReader.hpp"
+#include "Move.hpp"
+#include "Portals.hpp"
+#include "Setup.hpp"
+#include "Zobrist.hpp"
+
+/**
+ * @brief Text diagram of a board with white's back rank at the bottom
+ * @param side Number of squares along a side of the board
+ * @param symbols Symbol of every square by index, '.' for an empty one
+ */
+std::string boardDiagram(int side, const std::vector<char>& symbols);
+
+/**
+ * @brief Chess position on a Side x Side board, one bitboard per piece type
+ * and color plus a square-to-piece array for finding captured pieces
+ *
+ * The board side is a template parameter so that the bitboard width, the
+ * shifts and the masks are all compile-time constants: an 8x8 board works
+ * on plain 64-bit words, and boards up to 16x16 on fixed arrays of them.
+ * Larger boards use MailboxBoard, which has the same interface.
+ *
+ * The board follows the rules in its AttackTables, which must outlive it.
+ * Besides the configured movements it plays the standard special moves: a
+ * pawn's longer first move can be taken en passant, a pawn reaching the
+ * last rank promotes to any piece other than a pawn or king, and an
+ * unmoved King castles with an unmoved Rook on its rank. Pieces other than
+ * pawns also move through the configured portals (see PortalRule).
+ */
+template <int Side>
+class Board {
+ public:
+  using Bits = BitboardFor<Side>;
+  using Geo = Geometry<Side>;
+  static constexpr int kSquares = Side * Side;
+
+  /**
+   * @brief What makeMove overwrites, kept by the caller to undo it
+   */
+  struct UndoInfo {
+    int moved;              // piece type that moved, before any promotion
+    int captured;           // piece type taken, -1 if none
+    int castle_rook;        // square the castling rook came from
+    Bits unmoved;
+    Bits en_passant;
+    int en_passant_victim;
+    int portal_ready;       // cooldown of the portal used, if any
+    std::uint64_t key;
+  };
+
+  /**
+   * @brief Sets up a position
+   * @param tables Attack tables built for this board side
+   * @param setup Position on a board of this side, with piece types in the
+   * order the tables use
+   */
+  Board(const AttackTables<Side>& tables, const Setup& setup);
+
+  int side() const { return Side; }
+  const RuleSet& rules() const { return tables_->rules(); }
+  Color sideToMove() const { return side_; }
+  Bits pieces(Color color, int type) const { return pieces_[color][type]; }
+  Bits occupied() const { return colors_[WHITE] | colors_[BLACK]; }
+
+  /**
+   * @brief Piece type on a square, -1 if it is empty
+   */
+  int pieceAt(int square) const { return mailbox_[square]; }
+
+  /**
+   * @brief Color of the piece on an occupied square
+   */
+  Color colorAt(int square) const {
+    return colors_[BLACK] & bitOf<Bits>(square) ? BLACK : WHITE;
+  }
+
+  /**
+   * @brief Whether the color's cooldown on the portal is over
+   */
+  bool portalActive(Color color, int portal) const {
+    return portal_ready_[color][portal] <= ply_;
+  }
+
+  /**
+   * @brief Plies until the color may use the portal again
+   */
+  int portalWait(Color color, int portal) const {
+    return portal_ready_[color][portal] - ply_;
+  }
+
+  /**
+   * @brief Zobrist key of the position (see ZobristKeys)
+   */
+  std::uint64_t key() const {
+    return tables_->rules().portals().empty()
+               ? key_
+               : key_ ^ cooldownKey(*this, tables_->keys());
+  }
+
+  /**
+   * @brief Adds every pseudo-legal move: moves that follow the piece rules
+   * but may leave the mover's king attacked
+   */
+  void generateMoves(MoveList& moves) const;
+
+  /**
+   * @brief Adds every legal move
+   */
+  void generateLegalMoves(MoveList& moves);
+
+  UndoInfo makeMove(Move move);
+  void unmakeMove(Move move, const UndoInfo& undo);
+
+  /**
+   * @brief Whether a piece of the given color attacks the square
+   */
+  bool isAttacked(int square, Color by) const;
+
+  /**
+   * @brief Whether a royal piece of the given color is attacked
+   */
+  bool royalAttacked(Color color) const;
+
+  std::string toString() const;
+
+ private:
+  const AttackTables<Side>* tables_;
+  std::array<std::array<Bits, kMaxPieceTypes>, 2> pieces_{};
+  std::array<Bits, 2> colors_{};
+  std::array<std::int8_t, kSquares> mailbox_;
+  Color side_{WHITE};
+  Bits unmoved_{};      // pieces still on their starting squares
+  Bits en_passant_{};   // squares a pawn just passed over
+  int en_passant_victim_{-1};
+  int royal_type_{-1};
+  int ply_{0};  // moves made since the setup
+  // Per color and portal, the ply from which the color may use it again;
+  // a move through a portal changes one entry, so undoing it is O(1)
+  std::array<std::array<int, kMaxPortals>, 2> portal_ready_{};
+  std::uint64_t key_{0};  // all but the portal cooldowns
+
+  void put(Color color, int type, int square) {
+    pieces_[color][type] |= bitOf<Bits>(square);
+    colors_[color] |= bitOf<Bits>(square);
+    mailbox_[square] = static_cast<std::int8_t>(type);
+    key_ ^= tables_->keys().piece(color, type, square);
+  }
+  void remove(Color color, int type, int square) {
+    pieces_[color][type] &= ~bitOf<Bits>(square);
+    colors_[color] &= ~bitOf<Bits>(square);
+    mailbox_[square] = -1;
+    key_ ^= tables_->keys().piece(color, type, square);
+  }
+
+  Bits openEntries(Color color) const;
+  void generatePawnMoves(int type, MoveList& moves) const;
+  void addPawnMove(int from, int to, Move::Kind kind, MoveList& moves) const;
+  void generateCastles(MoveList& moves) const;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "AttackTables.hpp"
+#include "Board.hpp"
+#include "MailboxBoard.hpp"
+#include "PieceRules.hpp"
+#include "Setup.hpp"
+
+/**
+ * @brief Sets up a position on the fastest board for its size and passes
+ * it to a visitor
+ *
+ * Board sizes from kMinBitboardSide to kMaxBitboardSide get a Board<Side>,
+ * and every other size a MailboxBoard. The visitor is called with a
+ * reference to the board, so generic lambdas are compiled once per board
+ * type, and everything they do is specialised for that size; the board and
+ * its tables live until the visitor returns.
+ *
+ * @param rules Movement rules for the configured board size
+ * @param setup Position to set up, with piece types in the order the
+ * rules use
+ * @param visitor Callable taking any board type by reference; it must
+ * return the same type for every board
+ */
+template <int Side = kMinBitboardSide, typename Visitor>
+decltype(auto) visitBoard(const RuleSet& rules, const Setup& setup,
+                          Visitor&& visitor) {
+  if constexpr (Side <= kMaxBitboardSide) {
+    if (rules.boardSize() == Side) {
+      AttackTables<Side> tables(rules);
+      Board<Side> board(tables, setup);
+      return visitor(board);
+    }
+    return visitBoard<Side + 1>(rules, setup, visitor);
+  } else {
+    MailboxBoard board(rules, setup);
+    return visitor(board);
+  }
+}
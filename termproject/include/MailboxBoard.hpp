@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ConfigReader.hpp"
+#include "Move.hpp"
+#include "PieceRules.hpp"
+#include "Portals.hpp"
+#include "Setup.hpp"
+#include "Zobrist.hpp"
+
+// Files are lettered, so a board can be at most 26 squares wide
+constexpr int kMaxMailboxSide = 26;
+
+/**
+ * @brief Chess position on a board of any size from 1x1 to 26x26, as an
+ * array of cells with a border of off-board cells around it
+ *
+ * This is the fallback for board sizes without a Board<Side>
+ * specialisation. The border is two cells wide, so a knight jump from any
+ * square lands either on the board or on the border, and walking a ray
+ * needs no coordinate checks. Moves use the same square numbering, move
+ * encoding and rules as Board, and so give the same perft counts.
+ */
+class MailboxBoard {
+ public:
+  /**
+   * @brief What makeMove overwrites, kept by the caller to undo it
+   */
+  struct UndoInfo {
+    int moved;              // piece type that moved, before any promotion
+    int captured;           // piece type taken, -1 if none
+    int castle_rook;        // cell the castling rook came from
+    bool from_unmoved;
+    bool to_unmoved;
+    int en_passant_victim;
+    int en_passant_origin;
+    int portal_ready;       // cooldown of the portal used, if any
+    std::uint64_t key;
+  };
+
+  /**
+   * @brief Sets up a position
+   * @param rules Movement rules built for this board size
+   * @param setup Position on a board of that size, with piece types in the
+   * order the rules use
+   */
+  MailboxBoard(const RuleSet& rules, const Setup& setup);
+
+  int side() const { return board_side_; }
+  const RuleSet& rules() const { return rules_; }
+  Color sideToMove() const { return side_; }
+
+  /**
+   * @brief Piece type on a square, -1 if it is empty
+   */
+  int pieceAt(int square) const {
+    int cell = cells_[cellOf(square)];
+    return cell < 0 ? -1 : cell % kMaxPieceTypes;
+  }
+
+  /**
+   * @brief Color of the piece on an occupied square
+   */
+  Color colorAt(int square) const {
+    return static_cast<Color>(cells_[cellOf(square)] / kMaxPieceTypes);
+  }
+
+  /**
+   * @brief Whether the color's cooldown on the portal is over
+   */
+  bool portalActive(Color color, int portal) const {
+    return portal_ready_[color][portal] <= ply_;
+  }
+
+  /**
+   * @brief Plies until the color may use the portal again
+   */
+  int portalWait(Color color, int portal) const {
+    return portal_ready_[color][portal] - ply_;
+  }
+
+  /**
+   * @brief Zobrist key of the position (see ZobristKeys)
+   */
+  std::uint64_t key() const {
+    return rules_.portals().empty() ? key_ : key_ ^ cooldownKey(*this, keys_);
+  }
+
+  /**
+   * @brief Adds every pseudo-legal move: moves that follow the piece rules
+   * but may leave the mover's king attacked
+   */
+  void generateMoves(MoveList& moves) const;
+
+  /**
+   * @brief Adds every legal move
+   */
+  void generateLegalMoves(MoveList& moves);
+
+  UndoInfo makeMove(Move move);
+  void unmakeMove(Move move, const UndoInfo& undo);
+
+  /**
+   * @brief Whether a piece of the given color attacks the square
+   */
+  bool isAttacked(int square, Color by) const {
+    return attacked(cellOf(square), by);
+  }
+
+  /**
+   * @brief Whether a royal piece of the given color is attacked
+   */
+  bool royalAttacked(Color color) const;
+
+  std::string toString() const;
+
+ private:
+  static constexpr int kPadding = 2;
+  static constexpr std::int8_t kEmpty = -1;
+  static constexpr std::int8_t kOffBoard = -2;
+
+  struct Ray {
+    int delta;  // cell offset of one step
+    int range;
+  };
+
+  RuleSet rules_;
+  ZobristKeys keys_;
+  int board_side_;
+  int width_;                        // cells per row, border included
+  std::vector<std::int8_t> cells_;   // color * kMaxPieceTypes + type
+  std::vector<std::uint8_t> unmoved_;
+  std::array<std::vector<std::vector<Ray>>, 2> rays_;  // per color, type
+  std::array<std::array<int, kMaxPieceTypes>, 2> counts_{};
+  Color side_{WHITE};
+  int en_passant_victim_{-1};   // cell of a pawn that just made a long move
+  int en_passant_origin_{-1};   // ... and the cell it came from
+  int royal_type_{-1};
+  std::array<std::vector<std::int8_t>, 2> entries_;  // cell -> portal
+  int ply_{0};
+  std::array<std::array<int, kMaxPortals>, 2> portal_ready_{};
+  std::uint64_t key_{0};  // all but the portal cooldowns
+
+  int cellOf(int square) const {
+    return (square / board_side_ + kPadding) * width_ +
+           square % board_side_ + kPadding;
+  }
+  int squareOf(int cell) const {
+    return (cell / width_ - kPadding) * board_side_ + cell % width_ - kPadding;
+  }
+
+  void put(Color color, int type, int cell) {
+    cells_[cell] = static_cast<std::int8_t>(color * kMaxPieceTypes + type);
+    ++counts_[color][type];
+    key_ ^= keys_.piece(color, type, squareOf(cell));
+  }
+  void remove(int cell) {
+    int piece = cells_[cell];
+    Color color = static_cast<Color>(piece / kMaxPieceTypes);
+    --counts_[color][piece % kMaxPieceTypes];
+    cells_[cell] = kEmpty;
+    key_ ^= keys_.piece(color, piece % kMaxPieceTypes, squareOf(cell));
+  }
+
+  // Whether the cell is an empty portal entry the color may use now
+  bool isOpenEntryCell(int cell, Color color) const {
+    int portal = entries_[color][cell];
+    return portal >= 0 && cells_[cell] == kEmpty && portalActive(color, portal);
+  }
+
+  bool isEnPassantTarget(int cell) const;
+  void toggleEnPassantKeys();
+  bool attacked(int cell, Color by) const;
+  void generatePawnMoves(int type, int cell, MoveList& moves) const;
+  void addPawnMove(int from, int to, Move::Kind kind, MoveList& moves) const;
+  void generateCastles(int king, MoveList& moves) const;
+};
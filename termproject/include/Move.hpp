@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief A move packed into 32 bits
+ *
+ * Bits 0-9 hold the origin square, 10-19 the target square, 20-22 the kind
+ * of move and 23-27 the piece type a pawn promotes to, plus one (0 for no
+ * promotion), so squares of boards up to 32x32 fit. A move through a
+ * portal keeps the portal's index in bits 28-31 instead. Captures are not
+ * marked: the board sees what stands on the target square.
+ */
+class Move {
+ public:
+  enum Kind : std::uint32_t {
+    NORMAL = 0,
+    FIRST_PUSH = 1,  // pawn first move of two or more squares
+    EN_PASSANT = 2,
+    CASTLE = 3,      // king move; the rook moves along
+    PORTAL = 4,      // enters a portal and leaves by its exit
+  };
+
+  Move() = default;  // uninitialized, so move lists are cheap to create
+  constexpr Move(int from, int to, Kind kind = NORMAL, int promotion = -1)
+      : bits_(static_cast<std::uint32_t>(from) |
+              static_cast<std::uint32_t>(to) << 10 | kind << 20 |
+              static_cast<std::uint32_t>(promotion + 1) << 23) {}
+
+  static constexpr Move throughPortal(int from, int to, int portal) {
+    Move move(from, to, PORTAL);
+    move.bits_ |= static_cast<std::uint32_t>(portal) << 28;
+    return move;
+  }
+
+  constexpr int from() const { return bits_ & 1023; }
+  constexpr int to() const { return (bits_ >> 10) & 1023; }
+  constexpr Kind kind() const { return static_cast<Kind>((bits_ >> 20) & 7); }
+  constexpr int promotion() const {
+    return static_cast<int>((bits_ >> 23) & 31) - 1;
+  }
+  constexpr int portal() const { return static_cast<int>(bits_ >> 28); }
+  constexpr bool operator==(const Move& other) const = default;
+
+  /**
+   * @brief Coordinate notation such as "e2e4" or "j9j10", with the
+   * promotion piece's symbol appended when there is one
+   * @param side Number of squares along a side of the board
+   */
+  std::string toString(int side, char promotionSymbol = '\0') const;
+
+ private:
+  std::uint32_t bits_;
+};
+
+/**
+ * @brief List of moves, filled by the move generator
+ *
+ * The first kCapacity moves are stored in the list itself, so generating
+ * moves does not allocate. Crowded positions on large boards can have more
+ * moves; the list then moves them to the heap and keeps growing there.
+ */
+class MoveList {
+ public:
+  // Enough for the piece counts a 16x16 board can hold
+  static constexpr int kCapacity = 4096;
+
+  MoveList() = default;
+  MoveList(const MoveList&) = delete;  // would leave data_ pointing back
+  MoveList& operator=(const MoveList&) = delete;
+
+  void push(Move move) {
+    if (size_ == capacity_) grow();
+    data_[size_++] = move;
+  }
+  void clear() { size_ = 0; }
+  int size() const { return size_; }
+  Move operator[](int index) const { return data_[index]; }
+  const Move* begin() const { return data_; }
+  const Move* end() const { return data_ + size_; }
+
+ private:
+  std::array<Move, kCapacity> moves_;
+  std::vector<Move> overflow_;
+  Move* data_{moves_.data()};  // moves_ or overflow_
+  int size_{0};
+  int capacity_{kCapacity};
+
+  void grow();
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Move.hpp"
+#include "TranspositionTable.hpp"
+
+/**
+ * @brief Number of leaf nodes of the legal move tree to a depth
+ *
+ * The last ply is counted without being played: its nodes are the legal
+ * moves of the position above it.
+ */
+template <typename BoardType>
+std::uint64_t perft(BoardType& board, int depth) {
+  if (depth == 0) return 1;
+  MoveList moves;
+  board.generateLegalMoves(moves);
+  if (depth == 1) return static_cast<std::uint64_t>(moves.size());
+
+  std::uint64_t nodes = 0;
+  for (Move move : moves) {
+    auto undo = board.makeMove(move);
+    nodes += perft(board, depth - 1);
+    board.unmakeMove(move, undo);
+  }
+  return nodes;
+}
+
+/**
+ * @brief perft() that looks up the counts of positions two or more plies
+ * from the leaves in a table, and stores the ones it has to count
+ *
+ * The table may be shared with other threads, but not with positions
+ * under other rules, whose keys can be the same.
+ */
+template <typename BoardType>
+std::uint64_t perft(BoardType& board, int depth, TranspositionTable& table) {
+  if (depth < 2) return perft(board, depth);
+  std::uint64_t key = board.key();
+  TranspositionTable::Entry entry;
+  if (table.probe(key, entry) && entry.depth == depth) return entry.value;
+
+  MoveList moves;
+  board.generateLegalMoves(moves);
+  std::uint64_t nodes = 0;
+  for (Move move : moves) {
+    auto undo = board.makeMove(move);
+    nodes += perft(board, depth - 1, table);
+    board.unmakeMove(move, undo);
+  }
+  if (nodes <= TranspositionTable::kMaxValue) table.store(key, {depth, nodes});
+  return nodes;
+}
+
+/**
+ * @brief Leaf nodes below one root move
+ */
+struct DivideEntry {
+  Move move;
+  std::uint64_t nodes;
+};
+
+/**
+ * @brief Perft to a depth of at least 1, split by root move
+ *
+ * The root moves are handed out one at a time to the threads, each of which
+ * searches on its own copy of the board, so a thread that draws small
+ * subtrees simply takes more of them. With a table, the threads share it
+ * and reuse each other's counts.
+ *
+ * @param threads Number of threads, at least 1
+ * @param table Table for perft() to use, or nullptr to count every node
+ * @return Nodes below every legal root move, in generation order
+ */
+template <typename BoardType>
+std::vector<DivideEntry> perftDivide(const BoardType& board, int depth,
+                                     int threads,
+                                     TranspositionTable* table = nullptr) {
+  BoardType root = board;
+  MoveList moves;
+  root.generateLegalMoves(moves);
+  std::vector<DivideEntry> entries(moves.size());
+
+  std::atomic<int> next{0};
+  auto work = [&] {
+    BoardType local = board;
+    for (int i = next++; i < moves.size(); i = next++) {
+      auto undo = local.makeMove(moves[i]);
+      entries[i] = {moves[i], table ? perft(local, depth - 1, *table)
+                                    : perft(local, depth - 1)};
+      local.unmakeMove(moves[i], undo);
+    }
+  };
+  std::vector<std::thread> workers;
+  for (int i = 1; i < std::min(threads, moves.size()); ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) worker.join();
+  return entries;
+}
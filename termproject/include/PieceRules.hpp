@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ConfigReader.hpp"
+
+constexpr int kMaxPieceTypes = 16;
+constexpr int kMaxPortals = 16;  // a move has four bits for the portal
+
+enum Color : int { WHITE = 0, BLACK = 1 };
+
+constexpr Color opposite(Color color) { return color == WHITE ? BLACK : WHITE; }
+
+/**
+ * @brief One step of a ray and how far the ray may go
+ */
+struct RayRule {
+  int dx;
+  int dy;
+  int range;
+
+  bool operator==(const RayRule& other) const = default;
+};
+
+/**
+ * @brief How one piece type moves, derived from its MovementRules
+ *
+ * Pieces other than pawns move the same way in every direction along a
+ * line: "forward" covers both vertical directions, "sideways" both
+ * horizontal ones and "diagonal" all four diagonals. A piece with
+ * "first_move_forward" or "diagonal_capture" is a pawn: it moves only
+ * towards the opponent, without capturing, and captures only diagonally
+ * forward.
+ *
+ * The attacks are kept as groups of rays per color: the orthogonal ones,
+ * the diagonal ones and the knight jumps. Board implementations store a
+ * group whose rays all have length 1 as steps, and slide along the others.
+ */
+struct PieceRules {
+  std::string type;
+  char symbol{'?'};
+  bool royal{false};          // the king: must not be left attacked
+  bool castles{false};        // the rook: can castle with an unmoved king
+  bool pawn{false};
+  int push_range{0};          // pawn moves forward up to this far
+  int first_push_range{0};    // ... or this far on its first move
+  std::array<std::vector<std::vector<RayRule>>, 2> ray_groups;
+};
+
+/**
+ * @brief A portal with its squares resolved and its colors parsed
+ *
+ * A piece other than a pawn whose move reaches the empty entry square of a
+ * portal its color may use does not stop there but comes out on the exit.
+ * If the portal preserves direction, the piece may go on from the exit in
+ * the same direction for the rest of its range, otherwise the move ends on
+ * the exit. After using a portal, a color has to wait the given number of
+ * its own turns before using it again.
+ */
+struct PortalRule {
+  std::string id;
+  int entry;
+  int exit;
+  bool preserve_direction;
+  int cooldown;
+  std::array<bool, 2> allowed;  // per color
+};
+
+/**
+ * @brief Movement rules of every piece type in a configuration, with ray
+ * lengths capped at what the board size allows, and its portals
+ */
+class RuleSet {
+ public:
+  /**
+   * @throws std::invalid_argument if there are too many piece types or
+   * portals, or a portal is off the board, has an unknown color, or shares
+   * its entry with another portal of the same color
+   */
+  RuleSet(const std::vector<PieceConfig>& pieces, int board_size,
+          const std::vector<PortalConfig>& portals = {});
+
+  int boardSize() const { return board_size_; }
+  int pieceTypes() const { return static_cast<int>(pieces_.size()); }
+  const PieceRules& piece(int type) const { return pieces_[type]; }
+  const std::vector<int>& promotions() const { return promotions_; }
+
+  /**
+   * @brief Index of the first royal piece type, -1 if there is none
+   */
+  int royalType() const { return royal_type_; }
+
+  const std::vector<PortalRule>& portals() const { return portals_; }
+
+  /**
+   * @brief Index of the portal the color may enter on the square, -1 if
+   * there is none
+   */
+  int portalAt(Color color, int square) const {
+    return portals_.empty() ? -1 : portal_at_[color][square];
+  }
+
+  /**
+   * @brief Range of a piece's ray with the given step, 0 if it has none
+   */
+  int rayRange(int type, Color color, int dx, int dy) const;
+
+  /**
+   * @brief Every ray step of the color's pieces other than pawns
+   */
+  const std::vector<std::pair<int, int>>& steps(Color color) const {
+    return steps_[color];
+  }
+
+ private:
+  int board_size_;
+  std::vector<PieceRules> pieces_;
+  std::vector<int> promotions_;  // piece types a pawn may promote to
+  int royal_type_{-1};
+  std::vector<PortalRule> portals_;
+  std::array<std::vector<int>, 2> portal_at_;  // entry square -> portal
+  std::array<std::vector<std::pair<int, int>>, 2> steps_;
+
+  void addPortals(const std::vector<PortalConfig>& portals);
+};
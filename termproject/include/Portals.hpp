@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdlib>
+
+#include "Move.hpp"
+#include "PieceRules.hpp"
+
+/**
+ * Portal moves and attacks, shared by every board type. Portals are few and
+ * rarely in reach, so these walk the board square by square; the boards
+ * only call them when a piece actually reaches a usable entry, and
+ * otherwise treat usable empty entries as squares that stop a ray.
+ *
+ * A board type provides side(), rules(), sideToMove(), pieceAt(square),
+ * colorAt(square) and portalActive(color, portal).
+ */
+
+/**
+ * @brief Whether the square is the empty entry of a portal the color may
+ * use now
+ */
+template <typename BoardType>
+bool isOpenEntry(const BoardType& board, int square, Color color) {
+  int portal = board.rules().portalAt(color, square);
+  return portal >= 0 && board.pieceAt(square) < 0 &&
+         board.portalActive(color, portal);
+}
+
+/**
+ * @brief Adds the moves of a piece of the side to move that go through a
+ * portal: along each ray up to the first open entry, out of its exit, and
+ * on in the same direction if the portal preserves it
+ */
+template <typename BoardType>
+void addPortalMoves(const BoardType& board, int from, int type,
+                    MoveList& moves) {
+  const RuleSet& rules = board.rules();
+  int side = board.side();
+  Color us = board.sideToMove();
+  for (const auto& group : rules.piece(type).ray_groups[us]) {
+    for (const RayRule& ray : group) {
+      int x = from % side, y = from / side;
+      for (int step = 1; step <= ray.range; ++step) {
+        x += ray.dx;
+        y += ray.dy;
+        if (x < 0 || x >= side || y < 0 || y >= side) break;
+        int square = y * side + x;
+        if (board.pieceAt(square) >= 0) break;
+        if (!isOpenEntry(board, square, us)) continue;
+
+        int portal = rules.portalAt(us, square);
+        const PortalRule& rule = rules.portals()[portal];
+        int left = rule.preserve_direction ? ray.range - step : 0;
+        int tx = rule.exit % side, ty = rule.exit / side;
+        for (;;) {
+          int target = ty * side + tx;
+          bool occupied = board.pieceAt(target) >= 0;
+          if (occupied && board.colorAt(target) == us) break;
+          moves.push(Move::throughPortal(from, target, portal));
+          if (occupied || left-- == 0) break;
+          tx += ray.dx;
+          ty += ray.dy;
+          if (tx < 0 || tx >= side || ty < 0 || ty >= side) break;
+        }
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Whether a piece of the given color could capture on the square by
+ * going through a portal
+ *
+ * The square must be a portal's exit, or lie in line beyond the exit of a
+ * direction-preserving portal with nothing in between. Then the entry is
+ * searched backwards for a piece whose ray in that direction is long enough
+ * to cover both legs.
+ */
+template <typename BoardType>
+bool attackedThroughPortal(const BoardType& board, int square, Color by) {
+  const RuleSet& rules = board.rules();
+  const auto& portals = rules.portals();
+  int side = board.side();
+  int sx = square % side, sy = square / side;
+  for (int portal = 0; portal < static_cast<int>(portals.size()); ++portal) {
+    const PortalRule& rule = portals[portal];
+    if (!rule.allowed[by] || !isOpenEntry(board, rule.entry, by)) continue;
+
+    // Steps from the exit to the square, and their direction
+    int ex = rule.exit % side, ey = rule.exit / side;
+    int dx = sx - ex, dy = sy - ey, beyond = 0;
+    if (square != rule.exit) {
+      if (!rule.preserve_direction || board.pieceAt(rule.exit) >= 0) continue;
+      if (dx != 0 && dy != 0 && std::abs(dx) != std::abs(dy)) continue;
+      beyond = std::max(std::abs(dx), std::abs(dy));
+      dx /= beyond;
+      dy /= beyond;
+      bool clear = true;
+      for (int k = 1; k < beyond && clear; ++k) {
+        clear = board.pieceAt((ey + k * dy) * side + ex + k * dx) < 0;
+      }
+      if (!clear) continue;
+    }
+
+    int nx = rule.entry % side, ny = rule.entry / side;
+    for (const auto& [stepX, stepY] : rules.steps(by)) {
+      if (beyond > 0 && (stepX != dx || stepY != dy)) continue;
+      int x = nx, y = ny;
+      for (int steps = 1;; ++steps) {
+        x -= stepX;
+        y -= stepY;
+        if (x < 0 || x >= side || y < 0 || y >= side) break;
+        int from = y * side + x, type = board.pieceAt(from);
+        if (type < 0) {
+          // A ray from further back would go through this entry instead
+          if (isOpenEntry(board, from, by)) break;
+          continue;
+        }
+        if (board.colorAt(from) == by && !rules.piece(type).pawn &&
+            rules.rayRange(type, by, stepX, stepY) >= steps + beyond) {
+          return true;
+        }
+        break;
+      }
+    }
+  }
+  return false;
+}
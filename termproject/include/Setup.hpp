@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ConfigReader.hpp"
+#include "PieceRules.hpp"
+
+/**
+ * @brief One piece standing on the board
+ */
+struct Placement {
+  Color color;
+  int type;          // index of the piece type in the configuration
+  int square;        // y * board_size + x
+  bool unmoved{true};
+};
+
+/**
+ * @brief Everything a board needs to start from a position: where the
+ * pieces stand, who moves, and the state that past moves leave behind
+ *
+ * A pawn may make its longer first move and a king or rook may castle only
+ * while it is unmoved.
+ */
+struct Setup {
+  int board_size{0};
+  std::vector<Placement> pieces;
+  Color side_to_move{WHITE};
+  int en_passant{-1};  // square a pawn just passed over, -1 if none
+};
+
+/**
+ * @brief The starting position of a configuration, white to move
+ * @throws std::out_of_range if a piece is placed off the board
+ */
+Setup startingSetup(const std::vector<PieceConfig>& pieces, int board_size);
+
+/**
+ * @brief Reads a position in Forsyth-Edwards Notation
+ *
+ * Pieces are matched to the configuration by symbol, upper case for white
+ * and lower case for black, so standard FENs work with a configuration that
+ * names the standard pieces. Ranks may be longer or shorter than eight
+ * squares, and empty runs may have several digits. The castling field
+ * marks the king and the outermost rook on the named side as unmoved, and
+ * pawns count as unmoved on their color's second rank. Move counters are
+ * ignored.
+ *
+ * @throws std::invalid_argument if the FEN does not fit the configuration
+ */
+Setup parseFen(const std::string& fen, const RuleSet& rules);
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Results stored by position key, shared by any number of threads
+ * without locks
+ *
+ * The table is an array of 64-byte buckets, one cache line each, of four
+ * entries. A key picks a bucket, and within it any entry may hold the
+ * position: a store overwrites the entry that already holds the key, or
+ * else the one with the shallowest depth.
+ *
+ * Each entry is two 64-bit words, the data and the key XOR the data,
+ * written and read separately with relaxed atomics. Threads storing to the
+ * same entry at once can leave words from different stores; the key then
+ * no longer matches, so the entry reads as a miss instead of a wrong
+ * result.
+ */
+class TranspositionTable {
+ public:
+  /**
+   * @brief What a search stores about a position: a value of up to 56
+   * bits, such as a node count or a packed move, score and bound, and the
+   * depth it was searched to
+   */
+  struct Entry {
+    int depth;
+    std::uint64_t value;
+  };
+
+  static constexpr std::uint64_t kMaxValue = (std::uint64_t{1} << 56) - 1;
+
+  /**
+   * @brief Allocates an empty table
+   * @param megabytes Size of the table, rounded down to a power of two
+   * buckets, of which there is at least one
+   */
+  explicit TranspositionTable(std::size_t megabytes);
+
+  /**
+   * @brief Reallocates the table, dropping every entry; no other thread
+   * may use the table meanwhile
+   */
+  void resize(std::size_t megabytes);
+
+  /**
+   * @brief Drops every entry; no other thread may use the table meanwhile
+   */
+  void clear();
+
+  std::size_t entries() const { return (mask_ + 1) * kBucketEntries; }
+
+  /**
+   * @brief Looks up a position
+   * @param key Zobrist key of the position
+   * @param entry Set to what was stored for the position, if anything
+   * @return bool True if the position was found
+   */
+  bool probe(std::uint64_t key, Entry& entry) const {
+    const Bucket& bucket = buckets_[key & mask_];
+    for (const Slot& slot : bucket.slots) {
+      std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+      if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+        entry = {static_cast<int>(data & 0xFF), data >> 8};
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Stores what is known about a position
+   * @param key Zobrist key of the position
+   * @param entry Depth from 0 to 255 and value up to kMaxValue
+   */
+  void store(std::uint64_t key, const Entry& entry) {
+    Bucket& bucket = buckets_[key & mask_];
+    Slot* target = &bucket.slots[0];
+    int shallowest = 256;
+    for (Slot& slot : bucket.slots) {
+      std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+      if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+        target = &slot;
+        break;
+      }
+      if (static_cast<int>(data & 0xFF) < shallowest) {
+        shallowest = static_cast<int>(data & 0xFF);
+        target = &slot;
+      }
+    }
+    std::uint64_t data = entry.value << 8 | (entry.depth & 0xFF);
+    target->check.store(key ^ data, std::memory_order_relaxed);
+    target->data.store(data, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr int kBucketEntries = 4;
+
+  struct Slot {
+    std::atomic<std::uint64_t> check{0};  // key ^ data
+    std::atomic<std::uint64_t> data{0};   // value << 8 | depth
+  };
+
+  struct alignas(64) Bucket {
+    std::array<Slot, kBucketEntries> slots;
+  };
+
+  std::unique_ptr<Bucket[]> buckets_;
+  std::size_t mask_{0};  // buckets - 1
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "PieceRules.hpp"
+
+/**
+ * @brief Random 64-bit keys whose XOR identifies a position
+ *
+ * A position's key combines a key for every piece on its square, every
+ * square whose piece has not moved yet (which decides pawn first moves and
+ * castling), every square a pawn just passed over, black to move, and every
+ * portal a color is still waiting to use again with the number of plies
+ * left. Boards keep the key up to date as pieces move, so it costs a few
+ * XORs per move; the portal part changes with every ply and is added when
+ * the key is read instead.
+ *
+ * The keys are generated from a fixed seed, so a position has the same key
+ * on every board type and in every run.
+ */
+class ZobristKeys {
+ public:
+  explicit ZobristKeys(const RuleSet& rules);
+
+  std::uint64_t piece(Color color, int type, int square) const {
+    return pieces_[(color * piece_types_ + type) * squares_ + square];
+  }
+  std::uint64_t unmoved(int square) const { return unmoved_[square]; }
+  std::uint64_t enPassant(int square) const { return en_passant_[square]; }
+  std::uint64_t blackToMove() const { return black_to_move_; }
+
+  /**
+   * @brief Key of a color waiting for a portal
+   * @param plies Plies until the color may use the portal again, from 1 up
+   * to twice the portal's cooldown plus 2
+   */
+  std::uint64_t cooldown(Color color, int portal, int plies) const {
+    return cooldowns_[cooldown_offsets_[color][portal] + plies - 1];
+  }
+
+ private:
+  int squares_;
+  int piece_types_;
+  std::vector<std::uint64_t> pieces_;
+  std::vector<std::uint64_t> unmoved_;
+  std::vector<std::uint64_t> en_passant_;
+  std::uint64_t black_to_move_;
+  std::vector<std::uint64_t> cooldowns_;
+  std::array<std::vector<int>, 2> cooldown_offsets_;  // per portal
+};
+
+/**
+ * @brief Key of the portals the board's colors are waiting for
+ *
+ * A board type provides rules(), portalActive(color, portal) and
+ * portalWait(color, portal).
+ */
+template <typename BoardType>
+std::uint64_t cooldownKey(const BoardType& board, const ZobristKeys& keys) {
+  std::uint64_t key = 0;
+  int portals = static_cast<int>(board.rules().portals().size());
+  for (Color color : {WHITE, BLACK}) {
+    for (int portal = 0; portal < portals; ++portal) {
+      if (board.portalActive(color, portal)) continue;
+      key ^= keys.cooldown(color, portal, board.portalWait(color, portal));
+    }
+  }
+  return key;
+}
@@ -0,0 +1,240 @@
+#include "AttackTables.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+template <int Side>
+bool onBoard(int x, int y) {
+  return x >= 0 && x < Side && y >= 0 && y < Side;
+}
+
+/**
+ * @brief Squares reached along the rays from a square, stopping at and
+ * including the first occupied one
+ */
+template <int Side>
+BitboardFor<Side> walkRays(const std::vector<RayRule>& rays, int square,
+                           const BitboardFor<Side>& occupied) {
+  using Bits = BitboardFor<Side>;
+  using Geo = Geometry<Side>;
+  Bits result{};
+  for (const RayRule& ray : rays) {
+    int x = Geo::fileOf(square), y = Geo::rankOf(square);
+    for (int step = 0; step < ray.range; ++step) {
+      x += ray.dx;
+      y += ray.dy;
+      if (!onBoard<Side>(x, y)) break;
+      Bits bit = bitOf<Bits>(Geo::squareOf(x, y));
+      result |= bit;
+      if (occupied & bit) break;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Squares whose occupancy can shorten a ray: every square the ray
+ * passes except the last one it can reach
+ */
+template <int Side>
+Bitboard blockerMask(const std::vector<RayRule>& rays, int square) {
+  using Geo = Geometry<Side>;
+  Bitboard mask = 0;
+  for (const RayRule& ray : rays) {
+    int x = Geo::fileOf(square), y = Geo::rankOf(square);
+    Bitboard passed = 0, last = 0;
+    for (int step = 0; step < ray.range; ++step) {
+      x += ray.dx;
+      y += ray.dy;
+      if (!onBoard<Side>(x, y)) break;
+      passed |= last;
+      last = bitOf<Bitboard>(Geo::squareOf(x, y));
+    }
+    mask |= passed;
+  }
+  return mask;
+}
+
+/**
+ * @brief xorshift64* generator; fixed seeds make the magics, and so the
+ * table layout, the same on every run
+ */
+class MagicRandom {
+ public:
+  explicit MagicRandom(std::uint64_t seed) : state_(seed) {}
+
+  std::uint64_t next() {
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return state_ * 2685821657736338717ULL;
+  }
+
+  // Candidates with few set bits make good magics
+  std::uint64_t sparse() { return next() & next() & next(); }
+
+ private:
+  std::uint64_t state_;
+};
+
+}  // namespace
+
+template <int Side>
+MagicSliderTable<Side>::MagicSliderTable(const std::vector<RayRule>& rays)
+    : rays_(rays) {
+  std::vector<Bitboard> occupancies, attacks;
+  for (int square = 0; square < Side * Side; ++square) {
+    Entry& entry = entries_[square];
+    entry.mask = blockerMask<Side>(rays_, square);
+    entry.offset = table_.size();
+
+    // Every subset of the mask, by the carry-rippler trick
+    occupancies.clear();
+    attacks.clear();
+    Bitboard subset = 0;
+    do {
+      occupancies.push_back(subset);
+      attacks.push_back(walkRays<Side>(rays_, square, subset));
+      subset = (subset - entry.mask) & entry.mask;
+    } while (subset != 0);
+
+    table_.resize(entry.offset + occupancies.size());
+#if defined(__BMI2__)
+    entry.magic = 0;
+    entry.shift = 0;
+    for (std::size_t i = 0; i < occupancies.size(); ++i) {
+      table_[entry.offset + index(entry, occupancies[i])] = attacks[i];
+    }
+#else
+    findMagic(square, occupancies, attacks);
+#endif
+  }
+}
+
+/**
+ * @brief Searches for a multiplier that maps every blocker subset of the
+ * square to a slot of its own, or to a slot shared only with subsets that
+ * give the same attacks, and fills the square's slots.
+ */
+template <int Side>
+void MagicSliderTable<Side>::findMagic(
+    int square, const std::vector<Bitboard>& occupancies,
+    const std::vector<Bitboard>& attacks) {
+  Entry& entry = entries_[square];
+  int bits = popCount(entry.mask);
+  if (bits == 0) {
+    // Nothing can block: one slot, and a magic of 0 always indexes it
+    entry.magic = 0;
+    entry.shift = 63;
+    table_[entry.offset] = attacks[0];
+    return;
+  }
+  entry.shift = 64 - bits;
+
+  MagicRandom random(0x9E3779B97F4A7C15ULL ^ square);
+  std::vector<int> used(occupancies.size(), 0);  // attempt that filled it
+  for (int attempt = 1;; ++attempt) {
+    entry.magic = random.sparse();
+    if (bits >= 6 && popCount((entry.mask * entry.magic) >> 56) < 6) {
+      continue;
+    }
+    bool collision = false;
+    for (std::size_t i = 0; i < occupancies.size() && !collision; ++i) {
+      std::size_t slot = index(entry, occupancies[i]);
+      Bitboard& cell = table_[entry.offset + slot];
+      if (used[slot] != attempt) {
+        used[slot] = attempt;
+        cell = attacks[i];
+      } else if (cell != attacks[i]) {
+        collision = true;
+      }
+    }
+    if (!collision) return;
+  }
+}
+
+template <int Side>
+RaySliderTable<Side>::RaySliderTable(const std::vector<RayRule>& rays)
+    : rays_(rays), reach_(rays.size()), beyond_(rays.size()) {
+  for (std::size_t i = 0; i < rays_.size(); ++i) {
+    const RayRule& ray = rays_[i];
+    RayRule unlimited{ray.dx, ray.dy, Side};
+    increasing_.push_back(ray.dy > 0 || (ray.dy == 0 && ray.dx > 0));
+    for (int square = 0; square < Side * Side; ++square) {
+      reach_[i][square] = walkRays<Side>({ray}, square, Bits{});
+      beyond_[i][square] = walkRays<Side>({unlimited}, square, Bits{});
+    }
+  }
+}
+
+template <int Side>
+AttackTables<Side>::AttackTables(const RuleSet& rules)
+    : rules_(rules), keys_(rules) {
+  if (rules.boardSize() != Side) {
+    throw std::invalid_argument("Rules are for another board size");
+  }
+  pieces_.resize(rules.pieceTypes());
+  for (int type = 0; type < rules.pieceTypes(); ++type) {
+    const PieceRules& piece = rules.piece(type);
+    PieceTables& tables = pieces_[type];
+    for (Color color : {WHITE, BLACK}) {
+      // A group of rays is stored as steps if none goes further than one
+      // square, otherwise as one slider over the whole group
+      auto& slots = tables.sliders[color];
+      for (const std::vector<RayRule>& group : piece.ray_groups[color]) {
+        int longest = 0;
+        for (const RayRule& ray : group) longest = std::max(longest, ray.range);
+        if (longest == 1) {
+          for (int square = 0; square < kSquares; ++square) {
+            tables.steps[color][square] |=
+                walkRays<Side>(group, square, Bits{});
+          }
+          continue;
+        }
+        auto free = std::find(slots.begin(), slots.end(), -1);
+        if (free == slots.end()) {
+          throw std::logic_error("Piece " + piece.type +
+                                 " has too many sliders");
+        }
+        *free = sliderFor(group);
+      }
+      for (int square = 0; square < kSquares; ++square) {
+        tables.reach[color][square] = attacks(type, color, square, Bits{});
+      }
+    }
+  }
+}
+
+/**
+ * @brief Index of the slider table for the rays, built on first use
+ */
+template <int Side>
+int AttackTables<Side>::sliderFor(const std::vector<RayRule>& rays) {
+  auto found = std::find_if(
+      sliders_.begin(), sliders_.end(),
+      [&](const SliderTable<Side>& table) { return table.rays() == rays; });
+  if (found != sliders_.end()) {
+    return static_cast<int>(found - sliders_.begin());
+  }
+  sliders_.emplace_back(rays);
+  return static_cast<int>(sliders_.size()) - 1;
+}
+
+// Every board side with a bitboard implementation, kMinBitboardSide to
+// kMaxBitboardSide
+template class AttackTables<3>;
+template class AttackTables<4>;
+template class AttackTables<5>;
+template class AttackTables<6>;
+template class AttackTables<7>;
+template class AttackTables<8>;
+template class AttackTables<9>;
+template class AttackTables<10>;
+template class AttackTables<11>;
+template class AttackTables<12>;
+template class AttackTables<13>;
+template class AttackTables<14>;
+template class AttackTables<15>;
+template class AttackTables<16>;
@@ -0,0 +1,367 @@
+#include "Board.hpp"
+
+#include <stdexcept>
+
+namespace {
+
+template <int Side>
+BitboardFor<Side> rankMask(int rank) {
+  using Bits = BitboardFor<Side>;
+  Bits mask{};
+  for (int file = 0; file < Side; ++file) {
+    mask |= bitOf<Bits>(Geometry<Side>::squareOf(file, rank));
+  }
+  return mask;
+}
+
+// Moves a set of squares one rank towards the opponent of the color
+template <int Side>
+BitboardFor<Side> forward(const BitboardFor<Side>& bits, Color color) {
+  return color == WHITE ? (bits << Side) & allSquares<Side>()
+                        : bits >> Side;
+}
+
+}  // namespace
+
+std::string boardDiagram(int side, const std::vector<char>& symbols) {
+  int width = side > 9 ? 2 : 1;  // widest rank number
+  std::string text;
+  for (int rank = side - 1; rank >= 0; --rank) {
+    std::string label = std::to_string(rank + 1);
+    text += std::string(width - label.size(), ' ') + label;
+    for (int file = 0; file < side; ++file) {
+      text += ' ';
+      text += symbols[rank * side + file];
+    }
+    text += '\n';
+  }
+  text += std::string(width, ' ');
+  for (int file = 0; file < side; ++file) {
+    text += ' ';
+    text += static_cast<char>('a' + file);
+  }
+  return text + "\n";
+}
+
+template <int Side>
+Board<Side>::Board(const AttackTables<Side>& tables, const Setup& setup)
+    : tables_(&tables), side_(setup.side_to_move) {
+  if (setup.board_size != Side) {
+    throw std::invalid_argument("Position is for another board size");
+  }
+  mailbox_.fill(-1);
+  royal_type_ = tables.rules().royalType();
+  for (const Placement& piece : setup.pieces) {
+    if (piece.square < 0 || piece.square >= kSquares) {
+      throw std::out_of_range("Piece placed off the board");
+    }
+    if (mailbox_[piece.square] >= 0) {
+      throw std::invalid_argument("Two pieces placed on one square");
+    }
+    put(piece.color, piece.type, piece.square);
+    if (piece.unmoved) {
+      unmoved_ |= bitOf<Bits>(piece.square);
+      key_ ^= tables.keys().unmoved(piece.square);
+    }
+  }
+  if (setup.en_passant >= 0) {
+    int victim = setup.en_passant + (side_ == WHITE ? -Side : Side);
+    if (victim < 0 || victim >= kSquares || mailbox_[victim] < 0 ||
+        !tables.rules().piece(mailbox_[victim]).pawn ||
+        !(colors_[opposite(side_)] & bitOf<Bits>(victim))) {
+      throw std::invalid_argument("No pawn passed the en passant square");
+    }
+    en_passant_ = bitOf<Bits>(setup.en_passant);
+    en_passant_victim_ = victim;
+    key_ ^= tables.keys().enPassant(setup.en_passant);
+  }
+  if (side_ == BLACK) key_ ^= tables.keys().blackToMove();
+}
+
+template <int Side>
+void Board<Side>::generateMoves(MoveList& moves) const {
+  Color us = side_;
+  const RuleSet& rules = tables_->rules();
+  // Open portal entries stop rays like pieces do, but cannot be moved to
+  Bits entries = rules.portals().empty() ? Bits{} : openEntries(us);
+  Bits blockers = occupied() | entries, open = ~(colors_[us] | entries);
+  for (int type = 0; type < rules.pieceTypes(); ++type) {
+    Bits bits = pieces_[us][type];
+    if (!bits) continue;
+    if (rules.piece(type).pawn) {
+      generatePawnMoves(type, moves);
+      continue;
+    }
+    while (bits) {
+      int from = popLowestSquare(bits);
+      Bits reached = tables_->attacks(type, us, from, blockers);
+      Bits targets = reached & open;
+      while (targets) moves.push(Move(from, popLowestSquare(targets)));
+      if (reached & entries) addPortalMoves(*this, from, type, moves);
+    }
+  }
+  generateCastles(moves);
+}
+
+/**
+ * @brief Empty entries of the portals the color may use now
+ */
+template <int Side>
+typename Board<Side>::Bits Board<Side>::openEntries(Color color) const {
+  const std::vector<PortalRule>& portals = tables_->rules().portals();
+  Bits entries{};
+  for (int portal = 0; portal < static_cast<int>(portals.size()); ++portal) {
+    if (portals[portal].allowed[color] && portalActive(color, portal)) {
+      entries |= bitOf<Bits>(portals[portal].entry);
+    }
+  }
+  return entries & ~occupied();
+}
+
+/**
+ * @brief Pushes all pawns of a type at once, one rank per round: every
+ * pawn may go up to push_range squares, unmoved ones up to
+ * first_push_range. Captures are looked up per pawn.
+ */
+template <int Side>
+void Board<Side>::generatePawnMoves(int type, MoveList& moves) const {
+  const PieceRules& rules = tables_->rules().piece(type);
+  Color us = side_;
+  int step = us == WHITE ? Side : -Side;
+  Bits pawns = pieces_[us][type], empty = ~occupied();
+
+  Bits any = pawns, first = pawns & unmoved_;
+  for (int distance = 1; distance <= rules.first_push_range; ++distance) {
+    any = forward<Side>(any, us) & empty;
+    first = forward<Side>(first, us) & empty;
+    bool regular = distance <= rules.push_range;
+    Bits targets = regular ? any : first;
+    Move::Kind kind =
+        regular || distance < 2 ? Move::NORMAL : Move::FIRST_PUSH;
+    while (targets) {
+      int to = popLowestSquare(targets);
+      addPawnMove(to - distance * step, to, kind, moves);
+    }
+    if (!(any | first)) break;
+  }
+
+  Bits enemy = colors_[opposite(us)], all = occupied();
+  while (pawns) {
+    int from = popLowestSquare(pawns);
+    Bits attacks = tables_->attacks(type, us, from, all);
+    Bits targets = attacks & enemy;
+    while (targets) {
+      addPawnMove(from, popLowestSquare(targets), Move::NORMAL, moves);
+    }
+    if (attacks & en_passant_) {
+      moves.push(Move(from, lowestSquare(attacks & en_passant_),
+                      Move::EN_PASSANT));
+    }
+  }
+}
+
+template <int Side>
+void Board<Side>::addPawnMove(int from, int to, Move::Kind kind,
+                              MoveList& moves) const {
+  const std::vector<int>& promotions = tables_->rules().promotions();
+  int last = side_ == WHITE ? Side - 1 : 0;
+  if (Geo::rankOf(to) != last || promotions.empty()) {
+    moves.push(Move(from, to, kind));
+    return;
+  }
+  for (int promotion : promotions) {
+    moves.push(Move(from, to, kind, promotion));
+  }
+}
+
+/**
+ * @brief Castling: the unmoved king goes two squares towards an unmoved
+ * rook on its rank and the rook jumps to the square the king crossed. The
+ * squares between them must be empty, and the king may not be in check or
+ * cross an attacked square.
+ */
+template <int Side>
+void Board<Side>::generateCastles(MoveList& moves) const {
+  if (royal_type_ < 0) return;
+  Color us = side_, them = opposite(us);
+  Bits kings = pieces_[us][royal_type_] & unmoved_;
+  if (!kings) return;
+  int king = lowestSquare(kings);
+  const RuleSet& rules = tables_->rules();
+  Bits rooks{};
+  for (int type = 0; type < rules.pieceTypes(); ++type) {
+    if (rules.piece(type).castles) rooks |= pieces_[us][type];
+  }
+  rooks &= unmoved_ & rankMask<Side>(Geo::rankOf(king));
+  if (!rooks || isAttacked(king, them)) return;
+
+  Bits all = occupied();
+  while (rooks) {
+    int rook = popLowestSquare(rooks);
+    int direction = rook > king ? 1 : -1;
+    if ((rook - king) * direction < 3) continue;
+    Bits between{};
+    for (int square = king + direction; square != rook; square += direction) {
+      between |= bitOf<Bits>(square);
+    }
+    if ((between & all) || isAttacked(king + direction, them) ||
+        isAttacked(king + 2 * direction, them)) {
+      continue;
+    }
+    moves.push(Move(king, king + 2 * direction, Move::CASTLE));
+  }
+}
+
+template <int Side>
+void Board<Side>::generateLegalMoves(MoveList& moves) {
+  MoveList pseudo;
+  generateMoves(pseudo);
+  Color us = side_;
+  for (Move move : pseudo) {
+    UndoInfo undo = makeMove(move);
+    if (!royalAttacked(us)) moves.push(move);
+    unmakeMove(move, undo);
+  }
+}
+
+template <int Side>
+typename Board<Side>::UndoInfo Board<Side>::makeMove(Move move) {
+  Color us = side_, them = opposite(us);
+  int from = move.from(), to = move.to(), piece = mailbox_[from];
+  UndoInfo undo{piece, mailbox_[to], -1, unmoved_, en_passant_,
+                en_passant_victim_, 0, key_};
+
+  if (move.kind() == Move::EN_PASSANT) {
+    undo.captured = mailbox_[en_passant_victim_];
+    remove(them, undo.captured, en_passant_victim_);
+  } else if (undo.captured >= 0) {
+    remove(them, undo.captured, to);
+  }
+  if (move.kind() == Move::CASTLE) {
+    int direction = to > from ? 1 : -1;
+    int rook = from + direction;
+    while (mailbox_[rook] < 0) rook += direction;
+    undo.castle_rook = rook;
+    int rookType = mailbox_[rook];
+    remove(us, rookType, rook);
+    put(us, rookType, from + direction);
+  }
+  remove(us, piece, from);
+  put(us, move.promotion() >= 0 ? move.promotion() : piece, to);
+
+  const ZobristKeys& keys = tables_->keys();
+  // Squares whose pieces moved or were taken, the castling rook's included
+  Bits touched = bitOf<Bits>(from) | bitOf<Bits>(to);
+  if (move.kind() == Move::CASTLE) touched |= bitOf<Bits>(undo.castle_rook);
+  Bits moved = unmoved_ & touched;
+  unmoved_ ^= moved;
+  while (moved) key_ ^= keys.unmoved(popLowestSquare(moved));
+  while (en_passant_) key_ ^= keys.enPassant(popLowestSquare(en_passant_));
+  en_passant_victim_ = -1;
+  if (move.kind() == Move::FIRST_PUSH) {
+    int step = to > from ? Side : -Side;
+    for (int square = from + step; square != to; square += step) {
+      en_passant_ |= bitOf<Bits>(square);
+      key_ ^= keys.enPassant(square);
+    }
+    en_passant_victim_ = to;
+  }
+  if (move.kind() == Move::PORTAL) {
+    int& ready = portal_ready_[us][move.portal()];
+    undo.portal_ready = ready;
+    ready = ply_ + 2 * (tables_->rules().portals()[move.portal()].cooldown + 1);
+  }
+  ++ply_;
+  side_ = them;
+  key_ ^= keys.blackToMove();
+  return undo;
+}
+
+template <int Side>
+void Board<Side>::unmakeMove(Move move, const UndoInfo& undo) {
+  Color them = side_, us = opposite(them);
+  int from = move.from(), to = move.to();
+  remove(us, mailbox_[to], to);
+  put(us, undo.moved, from);
+
+  if (move.kind() == Move::CASTLE) {
+    int direction = to > from ? 1 : -1;
+    int rookType = mailbox_[from + direction];
+    remove(us, rookType, from + direction);
+    put(us, rookType, undo.castle_rook);
+  }
+  if (move.kind() == Move::EN_PASSANT) {
+    put(them, undo.captured, undo.en_passant_victim);
+  } else if (undo.captured >= 0) {
+    put(them, undo.captured, to);
+  }
+  unmoved_ = undo.unmoved;
+  en_passant_ = undo.en_passant;
+  en_passant_victim_ = undo.en_passant_victim;
+  if (move.kind() == Move::PORTAL) {
+    portal_ready_[us][move.portal()] = undo.portal_ready;
+  }
+  --ply_;
+  side_ = us;
+  key_ = undo.key;
+}
+
+template <int Side>
+bool Board<Side>::isAttacked(int square, Color by) const {
+  // Attacks are symmetric except for a pawn's direction, so the squares
+  // that attack this one are what a piece of the other color here attacks
+  Color them = opposite(by);
+  const RuleSet& rules = tables_->rules();
+  bool portals = !rules.portals().empty();
+  Bits all = occupied();
+  // Rays of pieces other than pawns end at open entries of their color
+  Bits blockers = portals ? all | openEntries(by) : all;
+  for (int type = 0; type < rules.pieceTypes(); ++type) {
+    Bits attackers = pieces_[by][type] & tables_->reach(type, them, square);
+    if (!attackers) continue;
+    const Bits& stops = portals && !rules.piece(type).pawn ? blockers : all;
+    if (tables_->attacks(type, them, square, stops) & attackers) return true;
+  }
+  return portals && attackedThroughPortal(*this, square, by);
+}
+
+template <int Side>
+bool Board<Side>::royalAttacked(Color color) const {
+  if (royal_type_ < 0) return false;
+  Bits royals = pieces_[color][royal_type_];
+  while (royals) {
+    if (isAttacked(popLowestSquare(royals), opposite(color))) return true;
+  }
+  return false;
+}
+
+template <int Side>
+std::string Board<Side>::toString() const {
+  std::vector<char> symbols(kSquares, '.');
+  for (int square = 0; square < kSquares; ++square) {
+    int type = mailbox_[square];
+    if (type < 0) continue;
+    symbols[square] = tables_->rules().piece(type).symbol;
+    if (colors_[BLACK] & bitOf<Bits>(square)) {
+      symbols[square] |= 0x20;  // lowercase
+    }
+  }
+  return boardDiagram(Side, symbols);
+}
+
+// Every board side with a bitboard implementation, kMinBitboardSide to
+// kMaxBitboardSide
+template class Board<3>;
+template class Board<4>;
+template class Board<5>;
+template class Board<6>;
+template class Board<7>;
+template class Board<8>;
+template class Board<9>;
+template class Board<10>;
+template class Board<11>;
+template class Board<12>;
+template class Board<13>;
+template class Board<14>;
+template class Board<15>;
+template class Board<16>;
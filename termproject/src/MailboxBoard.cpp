@@ -0,0 +1,366 @@
+#include "MailboxBoard.hpp"
+
+#include <stdexcept>
+
+#include "Board.hpp"
+
+MailboxBoard::MailboxBoard(const RuleSet& rules, const Setup& setup)
+    : rules_(rules),
+      keys_(rules),
+      board_side_(rules.boardSize()),
+      width_(rules.boardSize() + 2 * kPadding),
+      side_(setup.side_to_move) {
+  if (board_side_ < 1 || board_side_ > kMaxMailboxSide) {
+    throw std::invalid_argument("Board size must be between 1 and " +
+                                std::to_string(kMaxMailboxSide));
+  }
+  if (setup.board_size != board_side_) {
+    throw std::invalid_argument("Position is for another board size");
+  }
+  cells_.assign(width_ * width_, kOffBoard);
+  unmoved_.assign(width_ * width_, 0);
+  for (int square = 0; square < board_side_ * board_side_; ++square) {
+    cells_[cellOf(square)] = kEmpty;
+  }
+  royal_type_ = rules_.royalType();
+
+  for (Color color : {WHITE, BLACK}) {
+    for (int type = 0; type < rules_.pieceTypes(); ++type) {
+      std::vector<Ray> rays;
+      for (const auto& group : rules_.piece(type).ray_groups[color]) {
+        for (const RayRule& ray : group) {
+          rays.push_back({ray.dy * width_ + ray.dx, ray.range});
+        }
+      }
+      rays_[color].push_back(std::move(rays));
+    }
+    entries_[color].assign(width_ * width_, -1);
+    for (int square = 0; square < board_side_ * board_side_; ++square) {
+      entries_[color][cellOf(square)] =
+          static_cast<std::int8_t>(rules_.portalAt(color, square));
+    }
+  }
+
+  int squares = board_side_ * board_side_;
+  for (const Placement& piece : setup.pieces) {
+    if (piece.square < 0 || piece.square >= squares) {
+      throw std::out_of_range("Piece placed off the board");
+    }
+    int cell = cellOf(piece.square);
+    if (cells_[cell] != kEmpty) {
+      throw std::invalid_argument("Two pieces placed on one square");
+    }
+    put(piece.color, piece.type, cell);
+    unmoved_[cell] = piece.unmoved;
+    if (piece.unmoved) key_ ^= keys_.unmoved(piece.square);
+  }
+  if (setup.en_passant >= 0) {
+    int step = side_ == WHITE ? -board_side_ : board_side_;
+    int victim = setup.en_passant + step;
+    int piece = victim >= 0 && victim < squares ? cells_[cellOf(victim)] : -1;
+    if (piece < 0 || piece / kMaxPieceTypes == side_ ||
+        !rules_.piece(piece % kMaxPieceTypes).pawn) {
+      throw std::invalid_argument("No pawn passed the en passant square");
+    }
+    en_passant_victim_ = cellOf(victim);
+    en_passant_origin_ = cellOf(setup.en_passant - step);
+    toggleEnPassantKeys();
+  }
+  if (side_ == BLACK) key_ ^= keys_.blackToMove();
+}
+
+void MailboxBoard::generateMoves(MoveList& moves) const {
+  Color us = side_;
+  int king = -1;  // first unmoved royal piece, which may castle
+  for (int y = 0; y < board_side_; ++y) {
+    int cell = (y + kPadding) * width_ + kPadding;
+    for (int x = 0; x < board_side_; ++x, ++cell) {
+      int piece = cells_[cell];
+      if (piece < 0 || piece / kMaxPieceTypes != us) continue;
+      int type = piece % kMaxPieceTypes;
+      if (rules_.piece(type).pawn) {
+        generatePawnMoves(type, cell, moves);
+        continue;
+      }
+      if (type == royal_type_ && unmoved_[cell] && king < 0) king = cell;
+
+      int from = y * board_side_ + x;
+      bool portal = false;  // whether a ray reached an open portal entry
+      for (const Ray& ray : rays_[us][type]) {
+        int to = cell;
+        for (int step = 0; step < ray.range; ++step) {
+          to += ray.delta;
+          int target = cells_[to];
+          if (target == kOffBoard) break;
+          if (target == kEmpty && isOpenEntryCell(to, us)) {
+            portal = true;
+            break;
+          }
+          if (target == kEmpty || target / kMaxPieceTypes != us) {
+            moves.push(Move(from, squareOf(to)));
+          }
+          if (target != kEmpty) break;
+        }
+      }
+      if (portal) addPortalMoves(*this, from, type, moves);
+    }
+  }
+  if (king >= 0) generateCastles(king, moves);
+}
+
+/**
+ * @brief Pushes a pawn up to push_range squares, or first_push_range if it
+ * has not moved, and captures along its capture rays, en passant included
+ */
+void MailboxBoard::generatePawnMoves(int type, int cell,
+                                     MoveList& moves) const {
+  const PieceRules& rules = rules_.piece(type);
+  Color us = side_;
+  int step = us == WHITE ? width_ : -width_;
+  int range = unmoved_[cell] ? rules.first_push_range : rules.push_range;
+  for (int distance = 1; distance <= range; ++distance) {
+    int to = cell + distance * step;
+    if (cells_[to] != kEmpty) break;
+    bool regular = distance <= rules.push_range;
+    addPawnMove(cell, to,
+                regular || distance < 2 ? Move::NORMAL : Move::FIRST_PUSH,
+                moves);
+  }
+
+  int passed = -1;  // lowest en passant square in reach, like Board
+  for (const Ray& ray : rays_[us][type]) {
+    int to = cell;
+    for (int i = 0; i < ray.range; ++i) {
+      to += ray.delta;
+      int target = cells_[to];
+      if (target == kOffBoard) break;
+      if (target == kEmpty) {
+        if (isEnPassantTarget(to) && (passed < 0 || to < passed)) passed = to;
+        continue;
+      }
+      if (target / kMaxPieceTypes != us) {
+        addPawnMove(cell, to, Move::NORMAL, moves);
+      }
+      break;
+    }
+  }
+  if (passed >= 0) {
+    moves.push(Move(squareOf(cell), squareOf(passed), Move::EN_PASSANT));
+  }
+}
+
+void MailboxBoard::addPawnMove(int from, int to, Move::Kind kind,
+                               MoveList& moves) const {
+  const std::vector<int>& promotions = rules_.promotions();
+  int fromSquare = squareOf(from), toSquare = squareOf(to);
+  int last = side_ == WHITE ? board_side_ - 1 : 0;
+  if (toSquare / board_side_ != last || promotions.empty()) {
+    moves.push(Move(fromSquare, toSquare, kind));
+    return;
+  }
+  for (int promotion : promotions) {
+    moves.push(Move(fromSquare, toSquare, kind, promotion));
+  }
+}
+
+/**
+ * @brief Castling, as in Board: the unmoved king goes two squares towards
+ * an unmoved rook on its rank over empty, unattacked squares
+ */
+void MailboxBoard::generateCastles(int king, MoveList& moves) const {
+  Color us = side_, them = opposite(us);
+  if (attacked(king, them)) return;
+  int rowStart = king / width_ * width_ + kPadding;
+  for (int rook = rowStart; rook < rowStart + board_side_; ++rook) {
+    int piece = cells_[rook];
+    if (piece < 0 || piece / kMaxPieceTypes != us || !unmoved_[rook] ||
+        !rules_.piece(piece % kMaxPieceTypes).castles) {
+      continue;
+    }
+    int direction = rook > king ? 1 : -1;
+    if ((rook - king) * direction < 3) continue;
+    bool blocked = false;
+    for (int cell = king + direction; cell != rook; cell += direction) {
+      blocked = blocked || cells_[cell] != kEmpty;
+    }
+    if (blocked || attacked(king + direction, them) ||
+        attacked(king + 2 * direction, them)) {
+      continue;
+    }
+    moves.push(Move(squareOf(king), squareOf(king + 2 * direction),
+                    Move::CASTLE));
+  }
+}
+
+void MailboxBoard::generateLegalMoves(MoveList& moves) {
+  MoveList pseudo;
+  generateMoves(pseudo);
+  Color us = side_;
+  for (Move move : pseudo) {
+    UndoInfo undo = makeMove(move);
+    if (!royalAttacked(us)) moves.push(move);
+    unmakeMove(move, undo);
+  }
+}
+
+MailboxBoard::UndoInfo MailboxBoard::makeMove(Move move) {
+  Color us = side_, them = opposite(us);
+  int from = cellOf(move.from()), to = cellOf(move.to());
+  int piece = cells_[from] % kMaxPieceTypes;
+  UndoInfo undo{piece,
+                cells_[to] >= 0 ? cells_[to] % kMaxPieceTypes : -1,
+                -1,
+                unmoved_[from] != 0,
+                unmoved_[to] != 0,
+                en_passant_victim_,
+                en_passant_origin_,
+                0,
+                key_};
+
+  if (move.kind() == Move::EN_PASSANT) {
+    undo.captured = cells_[en_passant_victim_] % kMaxPieceTypes;
+    remove(en_passant_victim_);
+  } else if (undo.captured >= 0) {
+    remove(to);
+  }
+  if (move.kind() == Move::CASTLE) {
+    int direction = to > from ? 1 : -1;
+    int rook = from + direction;
+    while (cells_[rook] == kEmpty) rook += direction;
+    undo.castle_rook = rook;
+    int rookType = cells_[rook] % kMaxPieceTypes;
+    remove(rook);
+    put(us, rookType, from + direction);
+    unmoved_[rook] = 0;  // castling needs an unmoved rook
+    key_ ^= keys_.unmoved(squareOf(rook));
+  }
+  remove(from);
+  put(us, move.promotion() >= 0 ? move.promotion() : piece, to);
+
+  if (undo.from_unmoved) key_ ^= keys_.unmoved(move.from());
+  if (undo.to_unmoved) key_ ^= keys_.unmoved(move.to());
+  unmoved_[from] = unmoved_[to] = 0;
+  if (en_passant_victim_ >= 0) toggleEnPassantKeys();
+  en_passant_victim_ = en_passant_origin_ = -1;
+  if (move.kind() == Move::FIRST_PUSH) {
+    en_passant_victim_ = to;
+    en_passant_origin_ = from;
+    toggleEnPassantKeys();
+  }
+  if (move.kind() == Move::PORTAL) {
+    int& ready = portal_ready_[us][move.portal()];
+    undo.portal_ready = ready;
+    ready = ply_ + 2 * (rules_.portals()[move.portal()].cooldown + 1);
+  }
+  ++ply_;
+  side_ = them;
+  key_ ^= keys_.blackToMove();
+  return undo;
+}
+
+void MailboxBoard::unmakeMove(Move move, const UndoInfo& undo) {
+  Color them = side_, us = opposite(them);
+  int from = cellOf(move.from()), to = cellOf(move.to());
+  remove(to);
+  put(us, undo.moved, from);
+
+  if (move.kind() == Move::CASTLE) {
+    int direction = to > from ? 1 : -1;
+    int rookType = cells_[from + direction] % kMaxPieceTypes;
+    remove(from + direction);
+    put(us, rookType, undo.castle_rook);
+    unmoved_[undo.castle_rook] = 1;
+  }
+  if (move.kind() == Move::EN_PASSANT) {
+    put(them, undo.captured, undo.en_passant_victim);
+  } else if (undo.captured >= 0) {
+    put(them, undo.captured, to);
+  }
+  unmoved_[from] = undo.from_unmoved;
+  unmoved_[to] = undo.to_unmoved;
+  en_passant_victim_ = undo.en_passant_victim;
+  en_passant_origin_ = undo.en_passant_origin;
+  if (move.kind() == Move::PORTAL) {
+    portal_ready_[us][move.portal()] = undo.portal_ready;
+  }
+  --ply_;
+  side_ = us;
+  key_ = undo.key;
+}
+
+/**
+ * @brief Adds or removes the keys of the squares the last long pawn move
+ * passed over
+ */
+void MailboxBoard::toggleEnPassantKeys() {
+  int step = en_passant_victim_ > en_passant_origin_ ? width_ : -width_;
+  for (int cell = en_passant_origin_ + step; cell != en_passant_victim_;
+       cell += step) {
+    key_ ^= keys_.enPassant(squareOf(cell));
+  }
+}
+
+/**
+ * @brief Whether the cell lies strictly between where the last long pawn
+ * move started and ended
+ */
+bool MailboxBoard::isEnPassantTarget(int cell) const {
+  if (en_passant_victim_ < 0) return false;
+  int step = en_passant_victim_ > en_passant_origin_ ? width_ : -width_;
+  int offset = cell - en_passant_origin_;
+  if (offset % width_ != 0) return false;
+  int distance = offset / step;
+  return distance > 0 &&
+         distance < (en_passant_victim_ - en_passant_origin_) / step;
+}
+
+bool MailboxBoard::attacked(int cell, Color by) const {
+  // As in Board, walk the rays of the other color from the cell and look
+  // for an attacker of the same type at their ends. Rays of pieces other
+  // than pawns end at open portal entries of their color.
+  bool portals = !rules_.portals().empty();
+  for (int type = 0; type < rules_.pieceTypes(); ++type) {
+    if (counts_[by][type] == 0) continue;
+    int attacker = by * kMaxPieceTypes + type;
+    bool stops = portals && !rules_.piece(type).pawn;
+    for (const Ray& ray : rays_[opposite(by)][type]) {
+      int to = cell;
+      for (int step = 0; step < ray.range; ++step) {
+        to += ray.delta;
+        int target = cells_[to];
+        if (target == kEmpty) {
+          if (stops && isOpenEntryCell(to, by)) break;
+          continue;
+        }
+        if (target == attacker) return true;
+        break;
+      }
+    }
+  }
+  return portals && attackedThroughPortal(*this, squareOf(cell), by);
+}
+
+bool MailboxBoard::royalAttacked(Color color) const {
+  if (royal_type_ < 0) return false;
+  int remaining = counts_[color][royal_type_];
+  int royal = color * kMaxPieceTypes + royal_type_;
+  for (int cell = 0; remaining > 0; ++cell) {
+    if (cells_[cell] != royal) continue;
+    if (attacked(cell, opposite(color))) return true;
+    --remaining;
+  }
+  return false;
+}
+
+std::string MailboxBoard::toString() const {
+  std::vector<char> symbols(board_side_ * board_side_, '.');
+  for (int square = 0; square < board_side_ * board_side_; ++square) {
+    int piece = cells_[cellOf(square)];
+    if (piece < 0) continue;
+    symbols[square] = rules_.piece(piece % kMaxPieceTypes).symbol;
+    if (piece / kMaxPieceTypes == BLACK) {
+      symbols[square] |= 0x20;  // lowercase
+    }
+  }
+  return boardDiagram(board_side_, symbols);
+}
@@ -0,0 +1,24 @@
+#include "Move.hpp"
+
+#include <algorithm>
+#include <utility>
+
+std::string Move::toString(int side, char promotionSymbol) const {
+  std::string text;
+  for (int square : {from(), to()}) {
+    text += static_cast<char>('a' + square % side);
+    text += std::to_string(square / side + 1);
+  }
+  if (promotion() >= 0 && promotionSymbol != '\0') {
+    text += static_cast<char>(promotionSymbol | 0x20);  // lowercase
+  }
+  return text;
+}
+
+void MoveList::grow() {
+  std::vector<Move> larger(2 * static_cast<std::size_t>(capacity_));
+  std::copy(begin(), end(), larger.begin());
+  overflow_ = std::move(larger);
+  data_ = overflow_.data();
+  capacity_ = static_cast<int>(overflow_.size());
+}
@@ -0,0 +1,169 @@
+#include "PieceRules.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+char symbolOf(const std::string& type) {
+  if (type == "Knight") return 'N';
+  return type.empty() ? '?' : static_cast<char>(std::toupper(type[0]));
+}
+
+/**
+ * @brief Drops rays that go nowhere, and the whole group if none is left
+ */
+void addGroup(std::vector<std::vector<RayRule>>& groups,
+              const std::vector<RayRule>& rays) {
+  std::vector<RayRule> used;
+  for (const RayRule& ray : rays) {
+    if (ray.range > 0) used.push_back(ray);
+  }
+  if (!used.empty()) groups.push_back(std::move(used));
+}
+
+}  // namespace
+
+RuleSet::RuleSet(const std::vector<PieceConfig>& pieces, int board_size,
+                 const std::vector<PortalConfig>& portals)
+    : board_size_(board_size) {
+  if (pieces.size() > kMaxPieceTypes) {
+    throw std::invalid_argument("Too many piece types");
+  }
+  auto range = [&](int squares) {
+    return std::clamp(squares, 0, board_size - 1);
+  };
+
+  for (const PieceConfig& config : pieces) {
+    const MovementRules& movement = config.movement;
+    PieceRules rules;
+    rules.type = config.type;
+    rules.symbol = symbolOf(config.type);
+    rules.royal = config.type == "King";
+    rules.castles = config.type == "Rook";
+    rules.pawn =
+        movement.first_move_forward > 0 || movement.diagonal_capture > 0;
+
+    for (Color color : {WHITE, BLACK}) {
+      auto& groups = rules.ray_groups[color];
+      if (rules.pawn) {
+        int forward = color == WHITE ? 1 : -1;
+        int capture = range(movement.diagonal_capture);
+        addGroup(groups, {{-1, forward, capture}, {1, forward, capture}});
+        continue;
+      }
+      int vertical = range(movement.forward);
+      int horizontal = range(movement.sideways);
+      int diagonal = range(movement.diagonal);
+      addGroup(groups, {{0, 1, vertical},
+                        {0, -1, vertical},
+                        {1, 0, horizontal},
+                        {-1, 0, horizontal}});
+      addGroup(groups, {{1, 1, diagonal},
+                        {-1, 1, diagonal},
+                        {1, -1, diagonal},
+                        {-1, -1, diagonal}});
+      if (movement.l_shape) {
+        std::vector<RayRule> jumps;
+        for (int dx : {-2, -1, 1, 2}) {
+          for (int dy : {-2, -1, 1, 2}) {
+            if (std::abs(dx) != std::abs(dy)) jumps.push_back({dx, dy, 1});
+          }
+        }
+        addGroup(groups, jumps);
+      }
+    }
+    if (rules.pawn) {
+      rules.push_range = range(movement.forward);
+      rules.first_push_range =
+          std::max(rules.push_range, range(movement.first_move_forward));
+    }
+    pieces_.push_back(std::move(rules));
+  }
+
+  for (int type = 0; type < pieceTypes(); ++type) {
+    if (pieces_[type].royal && royal_type_ < 0) royal_type_ = type;
+    if (!pieces_[type].pawn && !pieces_[type].royal) {
+      promotions_.push_back(type);
+    }
+  }
+
+  for (Color color : {WHITE, BLACK}) {
+    for (const PieceRules& piece : pieces_) {
+      if (piece.pawn) continue;
+      for (const auto& group : piece.ray_groups[color]) {
+        for (const RayRule& ray : group) {
+          std::pair<int, int> step{ray.dx, ray.dy};
+          if (std::find(steps_[color].begin(), steps_[color].end(), step) ==
+              steps_[color].end()) {
+            steps_[color].push_back(step);
+          }
+        }
+      }
+    }
+  }
+  addPortals(portals);
+}
+
+/**
+ * @brief Resolves the portals into squares and per-color entry tables, so
+ * move generation never looks at their color names
+ */
+void RuleSet::addPortals(const std::vector<PortalConfig>& portals) {
+  if (portals.size() > kMaxPortals) {
+    throw std::invalid_argument("Too many portals");
+  }
+  auto squareOf = [&](const Position& position, const std::string& id) {
+    if (position.x < 0 || position.x >= board_size_ || position.y < 0 ||
+        position.y >= board_size_) {
+      throw std::invalid_argument("Portal " + id + " is off the board");
+    }
+    return position.y * board_size_ + position.x;
+  };
+  for (auto& table : portal_at_) {
+    table.assign(board_size_ * board_size_, -1);
+  }
+
+  for (const PortalConfig& config : portals) {
+    PortalRule portal;
+    portal.id = config.id;
+    portal.entry = squareOf(config.positions.entry, config.id);
+    portal.exit = squareOf(config.positions.exit, config.id);
+    portal.preserve_direction = config.properties.preserve_direction;
+    portal.cooldown = std::max(config.properties.cooldown, 0);
+    portal.allowed = {false, false};
+    for (const std::string& name : config.properties.allowed_colors) {
+      if (name != "white" && name != "black") {
+        throw std::invalid_argument("Portal " + config.id +
+                                    " allows unknown color " + name);
+      }
+      portal.allowed[name == "white" ? WHITE : BLACK] = true;
+    }
+    if (portal.entry == portal.exit) {
+      throw std::invalid_argument("Portal " + config.id + " leads to itself");
+    }
+
+    int index = static_cast<int>(portals_.size());
+    for (Color color : {WHITE, BLACK}) {
+      if (!portal.allowed[color]) continue;
+      int& slot = portal_at_[color][portal.entry];
+      if (slot >= 0) {
+        throw std::invalid_argument("Portals " + portals_[slot].id + " and " +
+                                    config.id + " share an entry");
+      }
+      slot = index;
+    }
+    portals_.push_back(std::move(portal));
+  }
+}
+
+int RuleSet::rayRange(int type, Color color, int dx, int dy) const {
+  for (const auto& group : pieces_[type].ray_groups[color]) {
+    for (const RayRule& ray : group) {
+      if (ray.dx == dx && ray.dy == dy) return ray.range;
+    }
+  }
+  return 0;
+}
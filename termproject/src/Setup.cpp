@@ -0,0 +1,147 @@
+#include "Setup.hpp"
+
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+Setup startingSetup(const std::vector<PieceConfig>& pieces, int board_size) {
+  Setup setup;
+  setup.board_size = board_size;
+  for (int type = 0; type < static_cast<int>(pieces.size()); ++type) {
+    for (Color color : {WHITE, BLACK}) {
+      const auto& positions = color == WHITE ? pieces[type].white_positions
+                                             : pieces[type].black_positions;
+      for (const Position& position : positions) {
+        if (position.x < 0 || position.x >= board_size || position.y < 0 ||
+            position.y >= board_size) {
+          throw std::out_of_range(pieces[type].type + " placed off the board");
+        }
+        setup.pieces.push_back(
+            {color, type, position.y * board_size + position.x});
+      }
+    }
+  }
+  return setup;
+}
+
+namespace {
+
+/**
+ * @brief Marks the king and the outermost rook on one side of it as
+ * unmoved, for one letter of the castling field
+ */
+void allowCastling(Setup& setup, const RuleSet& rules, Color color,
+                   bool kingside) {
+  int side = setup.board_size;
+  int rank = color == WHITE ? 0 : side - 1;
+  Placement* king = nullptr;
+  for (Placement& piece : setup.pieces) {
+    if (piece.color == color && piece.type == rules.royalType() &&
+        piece.square / side == rank) {
+      king = &piece;
+    }
+  }
+  if (king == nullptr) {
+    throw std::invalid_argument("Castling without a king on the back rank");
+  }
+
+  Placement* rook = nullptr;
+  for (Placement& piece : setup.pieces) {
+    if (piece.color != color || !rules.piece(piece.type).castles ||
+        piece.square / side != rank) {
+      continue;
+    }
+    bool outside = kingside ? piece.square > king->square
+                            : piece.square < king->square;
+    bool further = rook == nullptr || (kingside ? piece.square > rook->square
+                                                : piece.square < rook->square);
+    if (outside && further) rook = &piece;
+  }
+  if (rook == nullptr) {
+    throw std::invalid_argument("Castling without a rook to castle with");
+  }
+  king->unmoved = true;
+  rook->unmoved = true;
+}
+
+}  // namespace
+
+Setup parseFen(const std::string& fen, const RuleSet& rules) {
+  std::istringstream fields(fen);
+  std::string placement, side = "w", castling = "-", passed = "-";
+  fields >> placement >> side >> castling >> passed;
+
+  Setup setup;
+  int size = setup.board_size = rules.boardSize();
+  int rank = size - 1, file = 0;
+  for (std::size_t i = 0; i < placement.size(); ++i) {
+    char c = placement[i];
+    if (c == '/') {
+      if (file != size) throw std::invalid_argument("FEN rank of wrong size");
+      --rank;
+      file = 0;
+    } else if (std::isdigit(static_cast<unsigned char>(c))) {
+      int run = 0;
+      while (i < placement.size() &&
+             std::isdigit(static_cast<unsigned char>(placement[i]))) {
+        run = run * 10 + (placement[i++] - '0');
+      }
+      --i;
+      file += run;
+    } else {
+      char symbol =
+          static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+      int type = 0;
+      while (type < rules.pieceTypes() && rules.piece(type).symbol != symbol) {
+        ++type;
+      }
+      if (type == rules.pieceTypes()) {
+        throw std::invalid_argument(std::string("Unknown FEN piece ") + c);
+      }
+      Color color = c == symbol ? WHITE : BLACK;
+      int pawnRank = color == WHITE ? 1 : size - 2;
+      bool unmoved = rules.piece(type).pawn && rank == pawnRank;
+      setup.pieces.push_back({color, type, rank * size + file, unmoved});
+      ++file;
+    }
+    if (file > size || rank < 0) {
+      throw std::invalid_argument("FEN does not fit the board");
+    }
+  }
+  if (rank != 0 || file != size) {
+    throw std::invalid_argument("FEN has too few squares");
+  }
+
+  if (side != "w" && side != "b") {
+    throw std::invalid_argument("FEN side to move must be w or b");
+  }
+  setup.side_to_move = side == "w" ? WHITE : BLACK;
+
+  for (char c : castling) {
+    switch (c) {
+      case 'K': allowCastling(setup, rules, WHITE, true); break;
+      case 'Q': allowCastling(setup, rules, WHITE, false); break;
+      case 'k': allowCastling(setup, rules, BLACK, true); break;
+      case 'q': allowCastling(setup, rules, BLACK, false); break;
+      case '-': break;
+      default: throw std::invalid_argument("Bad FEN castling field");
+    }
+  }
+
+  if (passed != "-") {
+    int passedFile = passed[0] - 'a', passedRank = 0;
+    for (std::size_t i = 1; i < passed.size(); ++i) {
+      if (!std::isdigit(static_cast<unsigned char>(passed[i]))) {
+        throw std::invalid_argument("Bad FEN en passant square");
+      }
+      passedRank = passedRank * 10 + (passed[i] - '0');
+    }
+    --passedRank;  // ranks are numbered from 1
+    if (passedFile < 0 || passedFile >= size || passedRank < 0 ||
+        passedRank >= size) {
+      throw std::invalid_argument("Bad FEN en passant square");
+    }
+    setup.en_passant = passedRank * size + passedFile;
+  }
+  return setup;
+}
@@ -0,0 +1,25 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <bit>
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) {
+  resize(megabytes);
+}
+
+void TranspositionTable::resize(std::size_t megabytes) {
+  std::size_t buckets = megabytes * 1024 * 1024 / sizeof(Bucket);
+  buckets = std::bit_floor(std::max<std::size_t>(buckets, 1));
+  buckets_.reset();  // free the old table before allocating the new one
+  buckets_ = std::make_unique<Bucket[]>(buckets);
+  mask_ = buckets - 1;
+}
+
+void TranspositionTable::clear() {
+  for (std::size_t i = 0; i <= mask_; ++i) {
+    for (Slot& slot : buckets_[i].slots) {
+      slot.check.store(0, std::memory_order_relaxed);
+      slot.data.store(0, std::memory_order_relaxed);
+    }
+  }
+}
@@ -0,0 +1,48 @@
+#include "Zobrist.hpp"
+
+namespace {
+
+// SplitMix64: every seed gives a well mixed sequence, which is all the keys
+// need
+class KeyRandom {
+ public:
+  explicit KeyRandom(std::uint64_t seed) : state_(seed) {}
+
+  std::uint64_t next() {
+    std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+ private:
+  std::uint64_t state_;
+};
+
+std::vector<std::uint64_t> randomKeys(KeyRandom& random, std::size_t count) {
+  std::vector<std::uint64_t> keys(count);
+  for (std::uint64_t& key : keys) key = random.next();
+  return keys;
+}
+
+}  // namespace
+
+ZobristKeys::ZobristKeys(const RuleSet& rules)
+    : squares_(rules.boardSize() * rules.boardSize()),
+      piece_types_(rules.pieceTypes()) {
+  KeyRandom random(0x5A0B1157ULL);
+  pieces_ = randomKeys(random, 2 * piece_types_ * squares_);
+  unmoved_ = randomKeys(random, squares_);
+  en_passant_ = randomKeys(random, squares_);
+  black_to_move_ = random.next();
+
+  // A color waits at most 2 * (cooldown + 1) plies for a portal
+  int count = 0;
+  for (Color color : {WHITE, BLACK}) {
+    for (const PortalRule& portal : rules.portals()) {
+      cooldown_offsets_[color].push_back(count);
+      count += 2 * (portal.cooldown + 1);
+    }
+  }
+  cooldowns_ = randomKeys(random, count);
+}
@@ -2,6 +2,7 @@
 #include <iomanip>
 #include <iostream>
 
+#include "BoardFactory.hpp"
 #include "ConfigReader.hpp"
 
 // Helper function to print positions
@@ -100,5 +101,23 @@ int main(int argc, char* argv[]) {
     printPortalConfig(portal);
   }
 
+  // Set up the starting position with the configured movement rules
+  try {
+    RuleSet rules(reader.getPieceConfigs(), settings.board_size,
+                  reader.getPortalConfigs());
+    Setup setup =
+        startingSetup(reader.getPieceConfigs(), settings.board_size);
+    visitBoard(rules, setup, [](auto& board) {
+      MoveList moves;
+      board.generateLegalMoves(moves);
+
+      std::cout << "\n=== Starting Position ===\n" << board.toString();
+      std::cout << "Legal moves for white: " << moves.size() << "\n";
+    });
+  } catch (const std::exception& e) {
+    std::cerr << "Error setting up the board: " << e.what() << "\n";
+    return 1;
+  }
+
   return 0;
 }
@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "AttackTables.hpp"
+#include "Board.hpp"
+#include "ConfigReader.hpp"
+#include "MailboxBoard.hpp"
+#include "Setup.hpp"
+
+namespace {
+
+/**
+ * @brief Moves played from one position that must reach another one
+ */
+struct KeyCase {
+  std::string name;
+  std::string fen;
+  std::vector<std::string> moves;  // coordinate notation, e.g. "e1g1"
+  std::string expected;            // FEN of the position they reach
+};
+
+const std::vector<KeyCase> kCases = {
+    {"white castles short",
+     "4k3/8/8/8/8/8/8/4K2R w K -",
+     {"e1g1"},
+     "4k3/8/8/8/8/8/8/5RK1 b - -"},
+    {"black castles long",
+     "r3k3/8/8/8/8/8/8/4K3 b q -",
+     {"e8c8"},
+     "2kr4/8/8/8/8/8/8/4K3 w - -"},
+    {"castling, then the rook returns",
+     "4k3/8/8/8/8/8/8/4K2R w K -",
+     {"e1g1", "e8d8", "g1h2", "d8e8", "f1h1", "e8d8", "h2g1", "d8e8"},
+     "4k3/8/8/8/8/8/8/6KR w - -"},
+    {"double pawn push",
+     "4k3/8/8/8/8/8/4P3/4K3 w - -",
+     {"e2e4"},
+     "4k3/8/8/8/4P3/8/8/4K3 b - e3"},
+    {"knight moves in another order",
+     "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -",
+     {"g1f3", "b8c6", "b1c3", "g8f6"},
+     "r1bqkb1r/pppppppp/2n2n2/8/8/2N2N2/PPPPPPPP/R1BQKB1R w KQkq -"},
+};
+
+/**
+ * @brief Plays a legal move given in coordinate notation
+ */
+template <typename BoardType>
+void play(BoardType& board, const std::string& text) {
+  MoveList moves;
+  board.generateLegalMoves(moves);
+  for (Move move : moves) {
+    if (move.toString(board.side()) == text) {
+      board.makeMove(move);
+      return;
+    }
+  }
+  throw std::runtime_error("No legal move " + text);
+}
+
+/**
+ * @brief Whether playing the case's moves gives the key of its expected
+ * position set up from scratch
+ */
+template <typename BoardType, typename MakeBoard>
+bool sameKey(const KeyCase& test, const RuleSet& rules, MakeBoard makeBoard) {
+  BoardType played = makeBoard(parseFen(test.fen, rules));
+  for (const std::string& move : test.moves) play(played, move);
+  BoardType expected = makeBoard(parseFen(test.expected, rules));
+  return played.key() == expected.key();
+}
+
+}  // namespace
+
+int main() {
+  try {
+    ConfigReader reader("data/standard_chess.json");
+    if (!reader.readConfig()) {
+      throw std::runtime_error("Failed to read data/standard_chess.json");
+    }
+    RuleSet rules(reader.getPieceConfigs(),
+                  reader.getGameSettings().board_size);
+    AttackTables<8> tables(rules);
+
+    std::cout << std::left << std::setw(36) << "Case" << std::right
+              << std::setw(10) << "Board<8>" << std::setw(10) << "Mailbox"
+              << "\n"
+              << std::string(56, '-') << "\n";
+    bool passed = true;
+    for (const KeyCase& test : kCases) {
+      bool bitboard = sameKey<Board<8>>(test, rules, [&](const Setup& setup) {
+        return Board<8>(tables, setup);
+      });
+      bool mailbox = sameKey<MailboxBoard>(
+          test, rules,
+          [&](const Setup& setup) { return MailboxBoard(rules, setup); });
+      passed = passed && bitboard && mailbox;
+      std::cout << std::left << std::setw(36) << test.name << std::right
+                << std::setw(10) << (bitboard ? "ok" : "FAIL")
+                << std::setw(10) << (mailbox ? "ok" : "FAIL") << "\n";
+    }
+    std::cout << (passed ? "All keys match\n" : "Some keys do not match\n");
+    return passed ? 0 : 1;
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BoardFactory.hpp"
+#include "ConfigReader.hpp"
+#include "Perft.hpp"
+#include "Setup.hpp"
+#include "TranspositionTable.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Sets up a configuration's starting position, or a FEN position
+ * with its pieces, and passes the board to a visitor
+ */
+template <typename Visitor>
+void visitPosition(const std::string& config, const std::string& fen,
+                   Visitor&& visitor) {
+  ConfigReader reader(config);
+  if (!reader.readConfig()) {
+    throw std::runtime_error("Failed to read " + config);
+  }
+  RuleSet rules(reader.getPieceConfigs(), reader.getGameSettings().board_size,
+                reader.getPortalConfigs());
+  Setup setup = fen.empty() ? startingSetup(reader.getPieceConfigs(),
+                                            rules.boardSize())
+                            : parseFen(fen, rules);
+  visitBoard(rules, setup, visitor);
+}
+
+template <typename BoardType>
+std::string moveText(const BoardType& board, Move move) {
+  char promotion = move.promotion() >= 0
+                       ? board.rules().piece(move.promotion()).symbol
+                       : '\0';
+  std::string text = move.toString(board.side(), promotion);
+  if (move.kind() == Move::PORTAL) {
+    text += " via " + board.rules().portals()[move.portal()].id;
+  }
+  return text;
+}
+
+double rate(std::uint64_t nodes, double seconds) {
+  return seconds > 0 ? nodes / seconds : 0.0;
+}
+
+/**
+ * @brief A table of the given size, or none if the size is 0
+ */
+std::unique_ptr<TranspositionTable> makeTable(std::size_t megabytes) {
+  if (megabytes == 0) return nullptr;
+  return std::make_unique<TranspositionTable>(megabytes);
+}
+
+/**
+ * @brief Counts one position to every depth up to the given one, listing
+ * the nodes below each root move at the last depth if asked to
+ */
+void runPosition(const std::string& config, const std::string& fen,
+                 int depth, bool divide, int threads, std::size_t hash) {
+  auto table = makeTable(hash);
+  visitPosition(config, fen, [&](auto& board) {
+    std::cout << board.toString() << "\n";
+    for (int d = 1; d <= depth; ++d) {
+      auto start = Clock::now();
+      auto entries = perftDivide(board, d, threads, table.get());
+      double seconds = std::chrono::duration<double>(Clock::now() - start)
+                           .count();
+      std::uint64_t nodes = 0;
+      for (const DivideEntry& entry : entries) nodes += entry.nodes;
+
+      if (divide && d == depth) {
+        std::vector<std::pair<std::string, std::uint64_t>> lines;
+        for (const DivideEntry& entry : entries) {
+          lines.emplace_back(moveText(board, entry.move), entry.nodes);
+        }
+        std::sort(lines.begin(), lines.end());
+        for (const auto& [move, count] : lines) {
+          std::cout << move << ": " << count << "\n";
+        }
+        std::cout << "\n";
+      }
+      std::cout << "Depth " << std::setw(2) << d << ": " << std::setw(14)
+                << nodes << " nodes " << std::fixed << std::setprecision(3)
+                << std::setw(9) << seconds << " s " << std::setprecision(0)
+                << std::setw(12) << rate(nodes, seconds) << " nodes/s\n";
+    }
+  });
+}
+
+/**
+ * @brief Checks every position of a suite against its expected counts
+ *
+ * The suite is a JSON file with a "positions" array; each entry has a
+ * "name", a "config" path relative to the suite file, an optional "fen"
+ * and the expected "nodes" for depths 1, 2 and so on.
+ *
+ * @return bool True if every count matched.
+ */
+bool runSuite(const std::string& path, int maxDepth, int threads,
+              std::size_t hash) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+  nlohmann::json suite;
+  file >> suite;
+  std::filesystem::path directory = std::filesystem::path(path).parent_path();
+
+  std::cout << std::left << std::setw(24) << "Position" << std::right
+            << std::setw(6) << "Depth" << std::setw(14) << "Nodes"
+            << std::setw(14) << "Expected" << std::setw(8) << "Result"
+            << std::setw(14) << "Nodes/s" << "\n"
+            << std::string(80, '-') << "\n";
+
+  auto table = makeTable(hash);
+  bool passed = true;
+  std::uint64_t totalNodes = 0;
+  double totalSeconds = 0;
+  for (const auto& position : suite["positions"]) {
+    std::string name = position["name"].get<std::string>();
+    std::string config =
+        (directory / position["config"].get<std::string>()).string();
+    std::string fen = position.value("fen", "");
+    auto expected = position["nodes"].get<std::vector<std::uint64_t>>();
+    int depth = std::min<int>(maxDepth, expected.size());
+    // Positions under other rules can have the same keys
+    if (table) table->clear();
+
+    visitPosition(config, fen, [&](auto& board) {
+      for (int d = 1; d <= depth; ++d) {
+        auto start = Clock::now();
+        std::uint64_t nodes = 0;
+        for (const DivideEntry& entry :
+             perftDivide(board, d, threads, table.get())) {
+          nodes += entry.nodes;
+        }
+        double seconds =
+            std::chrono::duration<double>(Clock::now() - start).count();
+        totalNodes += nodes;
+        totalSeconds += seconds;
+        bool ok = nodes == expected[d - 1];
+        passed = passed && ok;
+        std::cout << std::left << std::setw(24) << name << std::right
+                  << std::setw(6) << d << std::setw(14) << nodes
+                  << std::setw(14) << expected[d - 1] << std::setw(8)
+                  << (ok ? "ok" : "FAIL") << std::fixed
+                  << std::setprecision(0) << std::setw(14)
+                  << rate(nodes, seconds) << "\n";
+      }
+    });
+  }
+  std::cout << std::string(80, '-') << "\n"
+            << "Total: " << totalNodes << " nodes in " << std::fixed
+            << std::setprecision(3) << totalSeconds << " s, "
+            << std::setprecision(0) << rate(totalNodes, totalSeconds)
+            << " nodes/s\n"
+            << (passed ? "All counts match\n" : "Some counts do not match\n");
+  return passed;
+}
+
+void printUsage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " [--fen <fen>] [--divide] [--threads <n>] [--hash <MB>]"
+            << " <config> <depth>\n"
+            << "       " << program
+            << " [--max-depth <n>] [--threads <n>] [--hash <MB>]"
+            << " --suite <suite.json>\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string fen, suite;
+  bool divide = false;
+  int threads = std::max(1u, std::thread::hardware_concurrency());
+  int maxDepth = 64;
+  std::size_t hash = 0;  // megabytes of transposition table, 0 for none
+  std::vector<std::string> arguments;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--fen") == 0 && i + 1 < argc) {
+      fen = argv[++i];
+    } else if (std::strcmp(argv[i], "--divide") == 0) {
+      divide = true;
+    } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = std::max(1, std::atoi(argv[++i]));
+    } else if (std::strcmp(argv[i], "--max-depth") == 0 && i + 1 < argc) {
+      maxDepth = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--hash") == 0 && i + 1 < argc) {
+      hash = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--suite") == 0 && i + 1 < argc) {
+      suite = argv[++i];
+    } else {
+      arguments.push_back(argv[i]);
+    }
+  }
+
+  try {
+    if (!suite.empty() && arguments.empty()) {
+      return runSuite(suite, maxDepth, threads, hash) ? 0 : 1;
+    }
+    if (suite.empty() && arguments.size() == 2) {
+      runPosition(arguments[0], fen, std::atoi(arguments[1].c_str()), divide,
+                  threads, hash);
+      return 0;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  printUsage(argv[0]);
+  return 1;
+}